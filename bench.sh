@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Colors
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BOLD='\033[1m'
+CYAN='\033[0;36m'
+DIM='\033[2m'
+NC='\033[0m'
+
+# Usage: ./bench.sh [--no-build] [--update-budget] [--top=N] [edition ...]
+BUILD=true
+ARGS=()
+for arg in "$@"; do
+  case "$arg" in
+    --no-build) BUILD=false ;;
+    *) ARGS+=("$arg") ;;
+  esac
+done
+
+cd "$(dirname "$0")"
+
+echo ""
+echo -e "${BOLD}${CYAN}  ★  Constellation Footprint${NC}"
+echo -e "${DIM}  ─────────────────────────${NC}"
+echo ""
+
+if $BUILD; then
+  ./build.sh || exit 1
+fi
+
+python3 tools/footprint.py "${ARGS[@]}"
+status=$?
+
+echo ""
+if [[ $status -eq 0 ]]; then
+  echo -e "${GREEN}${BOLD}  ★  Footprint within budget${NC}"
+else
+  echo -e "${RED}${BOLD}  ✗  Footprint over budget${NC}"
+fi
+echo ""
+exit $status
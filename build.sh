@@ -27,6 +27,11 @@ for i in $(seq 0 $((NUM - 1))); do
   echo ""
 done
 
+# Bitmap variants land in shared/resources, so write them once before the
+# editions build side by side
+python3 tools/bitmap_pipeline.py "${EDITIONS[@]}" --quiet || exit 1
+export BITMAP_VARIANTS_READY=1
+
 # Start all builds in background
 for i in $(seq 0 $((NUM - 1))); do
   log=$(mktemp)
@@ -1,12 +1,22 @@
 #include <pebble.h>
 #include "views/moon_view.h"
 #include "utilities/weather.h"
+#include "utilities/scenario_log.h"
 #include "shared_modules/top_module.h"
 #include "shared_modules/bottom_module.h"
 #include "shared_modules/battery_module.h"
 #include "modules/step_tracker_module.h"
 #include "shared_modules/splash_logo_module.h"
 #include "shared_modules/weather_display_module.h"
+#include "shared_modules/weather_sync_module.h"
+#include "shared_modules/time_display_module.h"
+#include "shared_modules/render_graph_module.h"
+#include "shared_modules/face_renderer_module.h"
+#include "shared_modules/render_budget_module.h"
+#include "shared_modules/power_governor_module.h"
+#include "shared_modules/work_queue_module.h"
+#include "shared_modules/message_outbox_module.h"
+#include "shared_modules/step_history_module.h"
 #include "modules/outer_ring_module.h"
 #include "utilities/logos.h"
 
@@ -23,48 +33,42 @@
 
 static Window *s_window;
 
-// Text layers (central elements only)
-static TextLayer *s_time_layer;
-
-// Custom drawing layers
+// Custom drawing layers (immediate mode draws all of them on the face layer)
+#if !RENDER_IMMEDIATE
+static Layer *s_steps_layer;
 static Layer *s_canvas_layer;
-static Layer *s_ampm_layer;
-
-// ============================================================================
-// GLOBAL STATE - Bitmaps
-// ============================================================================
-
-static GBitmap *s_am_active_bitmap;
-static GBitmap *s_am_inactive_bitmap;
-static GBitmap *s_pm_active_bitmap;
-static GBitmap *s_pm_inactive_bitmap;
+static Layer *s_clock_ring_layer;
+#endif
+static bool s_ui_loaded = false;
 
 // Center logo (replaces modules when enabled)
+#if !RENDER_IMMEDIATE
 static BitmapLayer *s_center_logo_layer;
+#endif
 static GBitmap *s_center_logo_bitmap;
+static GRect s_center_logo_frame;
 
 // ============================================================================
 // GLOBAL STATE - App Data
 // ============================================================================
 
-static bool s_is_pm;
 static int s_current_second;
 static int s_current_minute;
 static int s_current_hour;
-static int s_last_weather_minute = -1;
-static Layer *s_clock_ring_layer;
 
 // User settings (persisted)
 static bool s_show_clock_analog = true;
 static bool s_show_second_ticker = false;
 static bool s_show_decorative_ring = true;
 static bool s_show_step_tracker = true;
+static int s_battery_saver = POWER_GOVERNOR_DEFAULT_THRESHOLD;  // Percent, 0 = off
 static DateFormatType s_top_module_format = DATE_FORMAT_WEEKDAY;
 static DateFormatType s_bottom_module_format = DATE_FORMAT_MONTH_DAY;
 static int s_step_goal = 8000;
 static int s_style_logo = 1;
 static bool s_tracker_use_line = false;
 static bool s_show_moon_view = true;
+static bool s_moon_step_history = false;
 static bool s_show_weather = true;
 static int s_weather_scale = 1;
 static bool s_use_miles = false;
@@ -95,6 +99,7 @@ static DateFormatType parse_date_format(const char *format_str) {
   if (strcmp(format_str, "weekday_day") == 0) return DATE_FORMAT_WEEKDAY_DAY;
   if (strcmp(format_str, "step_count") == 0) return DATE_FORMAT_STEP_COUNT;
   if (strcmp(format_str, "distance") == 0) return DATE_FORMAT_DISTANCE;
+  if (strcmp(format_str, "step_history") == 0) return DATE_FORMAT_STEP_HISTORY;
   
   return DATE_FORMAT_WEEKDAY; // Default fallback
 }
@@ -104,41 +109,17 @@ static bool check_if_24h() {
   return clock_is_24h_style();
 }
 
-static void draw_bitmap_centered(GContext *ctx, GBitmap *bmp, GRect rect) {
-  if (!bmp) return;
-  
-  GRect bmp_bounds = gbitmap_get_bounds(bmp);
-  int x = rect.origin.x + (rect.size.w - bmp_bounds.size.w) / 2;
-  int y = rect.origin.y + (rect.size.h - bmp_bounds.size.h) / 2;
-  graphics_draw_bitmap_in_rect(ctx, bmp, GRect(x, y, bmp_bounds.size.w, bmp_bounds.size.h));
-}
-
 // ============================================================================
-// LAYER UPDATE PROCEDURES
+// DRAW PROCEDURES
 // ============================================================================
 
-static void ampm_update_proc(Layer *layer, GContext *ctx) {
-  GRect bounds = layer_get_bounds(layer);
-  int section_height = (bounds.size.h - 2) / 2;
-  int width = bounds.size.w;
-
-  GRect am_rect = GRect(0, 0, width, section_height);
-  GRect pm_rect = GRect(0, section_height + 2, width, section_height);
-
-  draw_bitmap_centered(ctx, s_is_pm ? s_am_inactive_bitmap : s_am_active_bitmap, am_rect);
-  draw_bitmap_centered(ctx, s_is_pm ? s_pm_active_bitmap : s_pm_inactive_bitmap, pm_rect);
-}
-
-
-// Draws the static clock ring and Gabbro outer ring on their own layer (only redrawn when settings change)
-static void clock_ring_update_proc(Layer *layer, GContext *ctx) {
-  GRect bounds = layer_get_bounds(layer);
-
+// Draws the static clock ring and Gabbro outer ring (only redrawn when settings change)
+static void draw_clock_ring(GContext *ctx, GRect bounds) {
   if (s_show_clock_analog) {
     outer_ring_draw(ctx, bounds);
   }
 
-  if (!s_show_decorative_ring) return;
+  if (!s_show_decorative_ring || render_budget_get_level() >= RENDER_LEVEL_NO_DECORATIVE_RING) return;
   int radius;
 
   int BASE_RECT_WIDTH = 174;
@@ -175,10 +156,9 @@ static void draw_gabbro_outer_ring_numbers(GContext *ctx, GRect bounds) {
   outer_ring_draw_numbers(ctx, bounds);
 }
 
-static void canvas_update_proc(Layer *layer, GContext *ctx) {
-  GRect bounds = layer_get_bounds(layer);
-
-  // Gabbro outer ring and clock ring are on their own static layer now
+// Step progress, redrawn only when steps or settings change
+static void draw_steps(GContext *ctx, GRect bounds) {
+  if (!s_show_step_tracker) return;
 
   // Calculate arc dimensions for step tracker based on platform
   int radius, diameter;
@@ -198,16 +178,114 @@ static void canvas_update_proc(Layer *layer, GContext *ctx) {
   arc_bounds = GRect(center.x - radius, y_offset + 7, diameter, diameter);
 
   // Draw step tracker (delegated to module)
-  if (s_show_step_tracker) {
-    step_tracker_module_draw(layer, ctx, bounds, radius, arc_bounds);
-  }
+  step_tracker_module_draw(NULL, ctx, bounds, radius, arc_bounds);
+}
+
+// Analog tickers and hour numbers, drawn above the step arc
+static void draw_tickers(GContext *ctx, GRect bounds) {
+  if (!s_show_clock_analog) return;
 
   // Draw clock tickers (hour & minute always, second only if enabled)
-  if (s_show_clock_analog) {
-    outer_ring_draw_tickers(ctx, bounds, s_current_hour, s_current_minute, s_current_second, s_show_second_ticker);
+  outer_ring_draw_tickers(ctx, bounds, s_current_hour, s_current_minute, s_current_second, s_show_second_ticker);
+  draw_gabbro_outer_ring_numbers(ctx, bounds);
+}
+
+// The render budget and the power governor can hold the second ticker to
+// minute rate while it is shown
+static bool ticker_shows_seconds(void) {
+  return s_show_second_ticker && render_budget_get_level() < RENDER_LEVEL_MINUTE_TICKER &&
+         power_governor_get_tier() < POWER_TIER_MINUTE_TICKER;
+}
+
+// The tickers only follow the second while the second ticker is shown
+static RenderInputs canvas_inputs(void) {
+  return RENDER_INPUT_MINUTE | RENDER_INPUT_HOUR | RENDER_INPUT_SETTINGS |
+         (ticker_shows_seconds() ? RENDER_INPUT_SECOND : 0);
+}
+
+#if RENDER_IMMEDIATE
+// One layer holds everything, so it redraws on every input except seconds
+// it does not show
+static void apply_canvas_inputs(void) {
+  face_renderer_module_set_inputs((RENDER_INPUT_ALL & ~RENDER_INPUT_SECOND) | canvas_inputs());
+}
+
+static void draw_step_tracker_icons(GContext *ctx, GRect bounds) {
+  if (s_show_step_tracker) step_tracker_module_draw_icons(ctx, bounds);
+}
+
+static void draw_center_logo(GContext *ctx, GRect bounds) {
+  face_renderer_draw_bitmap(ctx, s_center_logo_bitmap, s_center_logo_frame);
+}
+#else
+static void apply_canvas_inputs(void) {
+  render_graph_add(s_canvas_layer, canvas_inputs());
+}
+
+static void clock_ring_update_proc(Layer *layer, GContext *ctx) {
+  render_budget_begin(ctx);
+  draw_clock_ring(ctx, layer_get_bounds(layer));
+  render_budget_end();
+}
+
+static void steps_update_proc(Layer *layer, GContext *ctx) {
+  render_budget_begin(ctx);
+  draw_steps(ctx, layer_get_bounds(layer));
+  render_budget_end();
+}
+
+static void canvas_update_proc(Layer *layer, GContext *ctx) {
+  render_budget_begin(ctx);
+  draw_tickers(ctx, layer_get_bounds(layer));
+  render_budget_end();
+}
+#endif
+
+// ============================================================================
+// DEFERRED WORK
+// ============================================================================
+
+// Top/bottom text depends on the date, steps, settings and center logo mode
+static void update_text_modules(void) {
+  if (!s_ui_loaded) return;
+  time_t temp = time(NULL);
+  struct tm *tick_time = localtime(&temp);
+  if (!tick_time) return;
+
+  int step_count = s_show_step_tracker ? step_tracker_module_get_count() : 0;
+  
+  int distance_walked = 0;
+#if defined(PBL_HEALTH)
+  distance_walked = (int)health_service_sum_today(HealthMetricWalkedDistanceMeters);
+#endif
+  
+  bool changed = top_module_update(tick_time, s_top_module_format, step_count, distance_walked, s_use_miles, 0);
+  changed |= bottom_module_update(tick_time, s_bottom_module_format, step_count, distance_walked, s_use_miles, 0);
+  // Text layers mark themselves; nothing else listens for the date but the
+  // immediate-mode face, which draws the text itself
+  if (changed) render_graph_invalidate(RENDER_INPUT_DAY);
+}
+
+// Weather pushed by the phone: parsed inline, icon and text re-derived here
+static void apply_weather(void) {
+  weather_display_module_update();
+  render_graph_invalidate(RENDER_INPUT_WEATHER);
+}
+
+// Minute history is only read while a slot or the moon view shows it
+static bool step_history_shown(void) {
+  return s_top_module_format == DATE_FORMAT_STEP_HISTORY || s_bottom_module_format == DATE_FORMAT_STEP_HISTORY ||
+         (s_show_moon_view && s_moon_step_history);
+}
+
+// Reads the minutes since the last read; a long backlog continues in later slots
+static void update_step_history(void) {
+  uint32_t revision = step_history_module_get_revision();
+  if (step_history_module_update()) {
+    work_queue_post(update_step_history, WORK_PRIORITY_LOW);
   }
-  if (s_show_clock_analog) {
-    draw_gabbro_outer_ring_numbers(ctx, bounds);
+  if (step_history_module_get_revision() != revision) {
+    work_queue_post(update_text_modules, WORK_PRIORITY_HIGH);
   }
 }
 
@@ -220,63 +298,98 @@ static void update_time() {
   struct tm *tick_time = localtime(&temp);
   
   // Safety check
-  if (!s_time_layer || !tick_time) {
+  if (!s_ui_loaded || !tick_time) {
     return;
   }
   
-  // Only update step count, weather, battery on minute boundaries
-  bool minute_changed = (tick_time->tm_min != s_last_weather_minute);
-  if (minute_changed) {
-    s_last_weather_minute = tick_time->tm_min;
-    weather_display_module_update();
+  // Everything that changed since the last tick (time fields plus pending events)
+  // Close the last frame first, the watchdog may shed or restore a feature
+  render_budget_frame();
+  RenderInputs changed = render_graph_tick(tick_time);
+  
+  // Only update step count and weather on minute boundaries
+  if (changed & RENDER_INPUT_MINUTE) {
     if (s_show_step_tracker) {
-      step_tracker_module_update();
+      work_queue_post(step_tracker_module_update, WORK_PRIORITY_HIGH);
+    }
+    work_queue_post(weather_display_module_update, WORK_PRIORITY_NORMAL);
+    if (step_history_shown()) {
+      work_queue_post(update_step_history, WORK_PRIORITY_NORMAL);
     }
+    work_queue_post(weather_sync_module_check, WORK_PRIORITY_LOW);
   }
   
-  int step_count = s_show_step_tracker ? step_tracker_module_get_count() : 0;
-  
-  int distance_walked = 0;
-#if defined(PBL_HEALTH)
-  distance_walked = (int)health_service_sum_today(HealthMetricWalkedDistanceMeters);
-#endif
-  
-  top_module_update(tick_time, s_top_module_format, step_count, distance_walked, s_use_miles, 0);
-  bottom_module_update(tick_time, s_bottom_module_format, step_count, distance_walked, s_use_miles, 0);
+  // Text, health and weather follow on the work queue once the minute has
+  // flipped on screen
+  if (changed & (RENDER_INPUT_MINUTE | RENDER_INPUT_DAY | RENDER_INPUT_STEPS |
+                 RENDER_INPUT_SETTINGS | RENDER_INPUT_VISIBILITY)) {
+    work_queue_post(update_text_modules, WORK_PRIORITY_HIGH);
+  }
   
-  // Update time
-  static char time_buffer[8];
-  strftime(time_buffer, sizeof(time_buffer), check_if_24h() ? "%H:%M" : "%I:%M", tick_time);
-  text_layer_set_text(s_time_layer, time_buffer);
+  time_display_module_update(tick_time, check_if_24h());
   s_current_second = tick_time->tm_sec;
   s_current_minute = tick_time->tm_min;
   s_current_hour = tick_time->tm_hour;
   
-  // Update AM/PM indicator only on hour change
-  bool new_is_pm = (tick_time->tm_hour >= 12);
-  if (new_is_pm != s_is_pm) {
-    s_is_pm = new_is_pm;
-    if (s_ampm_layer) {
-      layer_mark_dirty(s_ampm_layer);
-    }
-  }
-  
-  // Only redraw canvas when second ticker is active or minute changed
-  if (s_canvas_layer && (s_show_second_ticker || minute_changed)) {
-    layer_mark_dirty(s_canvas_layer);
-  }
+  // Invalidate only the layers whose inputs changed
+  render_graph_flush();
 }
 
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
   update_time();
 }
 
+// Applies a new render budget level; the ring and ticker read it when drawn
+static void render_level_handler(RenderLevel level) {
+  tick_timer_service_subscribe(ticker_shows_seconds() && s_show_clock_analog ? SECOND_UNIT : MINUTE_UNIT,
+                               tick_handler);
+  if (s_ui_loaded) apply_canvas_inputs();
+  render_graph_invalidate(RENDER_INPUT_SETTINGS);
+}
+
 static void accel_tap_handler(AccelAxisType axis, int32_t direction) {
   if (s_show_moon_view) {
     moon_view_module_show();
   }
 }
 
+// Wrist taps only open the moon view, so the tap service goes once the
+// governor sheds it
+static void apply_tap_subscription(void) {
+  if (power_governor_get_tier() < POWER_TIER_NO_TAP) {
+    accel_tap_service_subscribe(accel_tap_handler);
+  } else {
+    accel_tap_service_unsubscribe();
+  }
+}
+
+// Without health events the step count is still read on every minute tick
+static void apply_step_subscription(void) {
+  if (s_show_step_tracker && power_governor_get_tier() < POWER_TIER_POLL_HEALTH) {
+    step_tracker_module_subscribe();
+  } else {
+    step_tracker_module_unsubscribe();
+  }
+}
+
+// Applies a new power tier: tick rate, tap and health subscriptions, and how
+// long weather may age before the watch asks for more
+static void power_tier_handler(PowerTier tier) {
+  tick_timer_service_subscribe(ticker_shows_seconds() && s_show_clock_analog ? SECOND_UNIT : MINUTE_UNIT,
+                               tick_handler);
+  if (s_ui_loaded) apply_canvas_inputs();
+  apply_tap_subscription();
+  apply_step_subscription();
+  weather_sync_module_set_stale_age(WEATHER_STALE_AGE_S * power_governor_refresh_scale());
+  render_graph_invalidate(RENDER_INPUT_SETTINGS);
+}
+
+// One battery subscription feeds the indicator and the power governor
+static void battery_handler(BatteryChargeState state) {
+  battery_module_set_state(state);
+  power_governor_update(state);
+}
+
 // ============================================================================
 // WINDOW HANDLERS
 // ============================================================================
@@ -298,10 +411,12 @@ static void prv_window_load(Window *window) {
 }
 
 static void center_logo_cleanup(void) {
+#if !RENDER_IMMEDIATE
   if (s_center_logo_layer) {
     bitmap_layer_destroy(s_center_logo_layer);
     s_center_logo_layer = NULL;
   }
+#endif
   if (s_center_logo_bitmap) {
     gbitmap_destroy(s_center_logo_bitmap);
     s_center_logo_bitmap = NULL;
@@ -314,8 +429,7 @@ static void apply_center_logo(Window *window) {
 
   if (!s_use_center_logo || s_center_logo_style < 1 || s_center_logo_style > SPLASH_LOGO_COUNT) {
     // Show normal center components
-    if (s_time_layer) layer_set_hidden(text_layer_get_layer(s_time_layer), false);
-    if (s_ampm_layer) layer_set_hidden(s_ampm_layer, false);
+    time_display_module_set_hidden(false);
     top_module_deinit();
     top_module_init(window, layer_get_bounds(window_get_root_layer(window)), -36, RESOURCE_ID_WALKING_SMALL_IMAGE, -33);
     bottom_module_deinit();
@@ -323,17 +437,17 @@ static void apply_center_logo(Window *window) {
     battery_module_deinit();
     battery_module_init(window, layer_get_bounds(window_get_root_layer(window)),
                         layer_get_bounds(window_get_root_layer(window)).size.h / 2 + 8 + 28 + 5 - 2);
-    battery_module_subscribe();
+    render_graph_invalidate(RENDER_INPUT_VISIBILITY | RENDER_INPUT_BATTERY);
     return;
   }
 
   // Hide center components
-  if (s_time_layer) layer_set_hidden(text_layer_get_layer(s_time_layer), true);
-  if (s_ampm_layer) layer_set_hidden(s_ampm_layer, true);
+  time_display_module_set_hidden(true);
   top_module_deinit();
   bottom_module_deinit();
-  battery_module_unsubscribe();
+  // Only the indicator goes; the battery service stays subscribed for the power governor
   battery_module_deinit();
+  render_graph_invalidate(RENDER_INPUT_VISIBILITY);
 
   // Show selected logo at center
   Layer *window_layer = window_get_root_layer(window);
@@ -346,12 +460,15 @@ static void apply_center_logo(Window *window) {
   int x = (bounds.size.w - logo_bounds.size.w) / 2;
   int y = (bounds.size.h - logo_bounds.size.h) / 2;
 
-  s_center_logo_layer = bitmap_layer_create(GRect(x, y, logo_bounds.size.w, logo_bounds.size.h));
+  s_center_logo_frame = GRect(x, y, logo_bounds.size.w, logo_bounds.size.h);
+#if !RENDER_IMMEDIATE
+  s_center_logo_layer = bitmap_layer_create(s_center_logo_frame);
   if (s_center_logo_layer) {
     bitmap_layer_set_bitmap(s_center_logo_layer, s_center_logo_bitmap);
     bitmap_layer_set_compositing_mode(s_center_logo_layer, GCompOpSet);
     layer_add_child(window_layer, bitmap_layer_get_layer(s_center_logo_layer));
   }
+#endif
 }
 
 static void load_watchface_ui(void *data) {
@@ -364,41 +481,53 @@ static void load_watchface_ui(void *data) {
   // Clean up splash logo (frees both layer and bitmap)
   splash_logo_cleanup();
   
-  // Create time text layer (central element)
-  // Position depends on 24h format (centered when 24h, offset when 12h for AM/PM)
+  // Create time display (central element)
+  // Centered when 24h, offset left when 12h to make room for AM/PM
   int time_width = check_if_24h() ? bounds.size.w : (bounds.size.w - 20);
-  s_time_layer = text_layer_create(GRect(0, bounds.size.h / 2 - 20, time_width, 36));
-  if (s_time_layer) {
-    text_layer_set_background_color(s_time_layer, GColorClear);
-    text_layer_set_text_color(s_time_layer, GColorWhite);
-    text_layer_set_font(s_time_layer, fonts_get_system_font(FONT_KEY_LECO_32_BOLD_NUMBERS));
-    text_layer_set_text_alignment(s_time_layer, GTextAlignmentCenter);
-    layer_add_child(window_layer, text_layer_get_layer(s_time_layer));
-  }
-  
-  // Create AM/PM indicator layer (only visible in 12h format)
-  if (!check_if_24h()) {
-    s_ampm_layer = layer_create(GRect(bounds.size.w / 2 + 36, bounds.size.h / 2 - 10, 18, 22));
-    if (s_ampm_layer) {
-      layer_set_update_proc(s_ampm_layer, ampm_update_proc);
-      layer_add_child(window_layer, s_ampm_layer);
-    }
-  }
-  
+  GRect ampm_frame = check_if_24h() ? GRectZero : GRect(bounds.size.w / 2 + 36, bounds.size.h / 2 - 10, 18, 22);
+  time_display_module_init(window, GRect(0, bounds.size.h / 2 - 20, time_width, 36), ampm_frame,
+                           fonts_get_system_font(FONT_KEY_LECO_32_BOLD_NUMBERS), RESOURCE_ID_AMPM_BADGES_IMAGE);
+  
+#if RENDER_IMMEDIATE
+  // One full-screen layer; procs run in the same order the layers stack
+  face_renderer_module_init(window, RENDER_INPUT_ALL);
+  face_renderer_module_add(time_display_module_draw);
+  face_renderer_module_add(draw_clock_ring);
+  face_renderer_module_add(draw_steps);
+  face_renderer_module_add(draw_tickers);
+  face_renderer_module_add(weather_display_module_draw);
+  face_renderer_module_add(top_module_draw);
+  face_renderer_module_add(bottom_module_draw);
+  face_renderer_module_add(battery_module_draw);
+  face_renderer_module_add(draw_step_tracker_icons);
+  face_renderer_module_add(draw_center_logo);
+  apply_canvas_inputs();
+#else
   // Create clock ring on its own layer (only redraws when settings change)
   s_clock_ring_layer = layer_create(bounds);
   if (s_clock_ring_layer) {
     layer_set_update_proc(s_clock_ring_layer, clock_ring_update_proc);
     layer_add_child(window_layer, s_clock_ring_layer);
+    render_graph_add(s_clock_ring_layer, RENDER_INPUT_SETTINGS);
+  }
+  
+  // Step progress gets its own layer so ticker movement never redraws it
+  s_steps_layer = layer_create(bounds);
+  if (s_steps_layer) {
+    layer_set_update_proc(s_steps_layer, steps_update_proc);
+    layer_add_child(window_layer, s_steps_layer);
+    render_graph_add(s_steps_layer, RENDER_INPUT_STEPS | RENDER_INPUT_SETTINGS);
   }
   
-  // Create canvas layer for step tracker and second indicator
-  // Add this LAST so the second ticker appears on top of all other elements
+  // Create canvas layer for the analog tickers
+  // Add this LAST so the tickers appear on top of all other elements
   s_canvas_layer = layer_create(bounds);
   if (s_canvas_layer) {
     layer_set_update_proc(s_canvas_layer, canvas_update_proc);
     layer_add_child(window_layer, s_canvas_layer);
+    render_graph_add(s_canvas_layer, canvas_inputs());
   }
+#endif
   
   // Initialize modules
   weather_module_set_scale(s_weather_scale);
@@ -409,7 +538,7 @@ static void load_watchface_ui(void *data) {
   battery_module_init(window, bounds, bounds.size.h / 2 + 8 + 28 + 5 - 2);
   
   if (s_show_step_tracker) {
-    step_tracker_module_init(window, bounds, s_canvas_layer);
+    step_tracker_module_init(window, bounds);
   }
 
   // Set step goal from settings
@@ -417,38 +546,47 @@ static void load_watchface_ui(void *data) {
     step_tracker_module_set_goal(s_step_goal);
   }
 
-  // Initialize time display
-  update_time();
-
   // Apply center logo mode (hides center components if enabled)
   apply_center_logo(window);
+
+  // Initialize time display, every layer starts dirty
+  s_ui_loaded = true;
+  render_graph_invalidate(RENDER_INPUT_ALL);
+  scenario_log_expect_frame("face_frame");
+  update_time();
+  // The first frame shows everything, not just the time
+  work_queue_drain();
 }
 
 static void prv_window_unload(Window *window) {
   // Clean up center logo
   center_logo_cleanup();
 
-  // Destroy central text layers
-  if (s_time_layer) {
-    text_layer_destroy(s_time_layer);
-    s_time_layer = NULL;
-  }
-  
+  s_ui_loaded = false;
+
   // Destroy custom layers
+#if RENDER_IMMEDIATE
+  face_renderer_module_deinit();
+#else
   if (s_canvas_layer) {
+    render_graph_remove(s_canvas_layer);
     layer_destroy(s_canvas_layer);
     s_canvas_layer = NULL;
   }
+  if (s_steps_layer) {
+    render_graph_remove(s_steps_layer);
+    layer_destroy(s_steps_layer);
+    s_steps_layer = NULL;
+  }
   if (s_clock_ring_layer) {
+    render_graph_remove(s_clock_ring_layer);
     layer_destroy(s_clock_ring_layer);
     s_clock_ring_layer = NULL;
   }
-  if (s_ampm_layer) {
-    layer_destroy(s_ampm_layer);
-    s_ampm_layer = NULL;
-  }
+#endif
   
   // Deinitialize modules
+  time_display_module_deinit();
   weather_display_module_deinit();
   top_module_deinit();
   bottom_module_deinit();
@@ -470,9 +608,11 @@ static void save_settings(void) {
   persist_write_int(MESSAGE_KEY_SPLASH_LOGO_STYLE, s_style_logo);
   persist_write_bool(MESSAGE_KEY_SHOW_STEP_TRACKER, s_show_step_tracker);
   persist_write_bool(MESSAGE_KEY_SHOW_MOON_VIEW, s_show_moon_view);
+  persist_write_bool(MESSAGE_KEY_MOON_STEP_HISTORY, s_moon_step_history);
   persist_write_bool(MESSAGE_KEY_SHOW_WEATHER, s_show_weather);
   persist_write_int(MESSAGE_KEY_WEATHER_SCALE, s_weather_scale);
   persist_write_bool(MESSAGE_KEY_USE_MILES, s_use_miles);
+  persist_write_int(MESSAGE_KEY_BATTERY_SAVER, s_battery_saver);
   persist_write_bool(MESSAGE_KEY_USE_CENTER_LOGO, s_use_center_logo);
   persist_write_int(MESSAGE_KEY_CENTER_LOGO_STYLE, s_center_logo_style);
 }
@@ -507,6 +647,9 @@ static void load_settings(void) {
   if (persist_exists(MESSAGE_KEY_SHOW_MOON_VIEW)) {
     s_show_moon_view = persist_read_bool(MESSAGE_KEY_SHOW_MOON_VIEW);
   }
+  if (persist_exists(MESSAGE_KEY_MOON_STEP_HISTORY)) {
+    s_moon_step_history = persist_read_bool(MESSAGE_KEY_MOON_STEP_HISTORY);
+  }
   if (persist_exists(MESSAGE_KEY_SHOW_WEATHER)) {
     s_show_weather = persist_read_bool(MESSAGE_KEY_SHOW_WEATHER);
   }
@@ -516,6 +659,9 @@ static void load_settings(void) {
   if (persist_exists(MESSAGE_KEY_USE_MILES)) {
     s_use_miles = persist_read_bool(MESSAGE_KEY_USE_MILES);
   }
+  if (persist_exists(MESSAGE_KEY_BATTERY_SAVER)) {
+    s_battery_saver = persist_read_int(MESSAGE_KEY_BATTERY_SAVER);
+  }
   if (persist_exists(MESSAGE_KEY_USE_CENTER_LOGO)) {
     s_use_center_logo = persist_read_bool(MESSAGE_KEY_USE_CENTER_LOGO);
   }
@@ -531,20 +677,14 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
   Tuple *weather_tuple = dict_find(iter, MESSAGE_KEY_WEATHER_DATA);
   if (weather_tuple && weather_tuple->type == TUPLE_CSTRING) {
     weather_module_update(weather_tuple->value->cstring);
-    weather_display_module_update();
-    // Trigger UI update if needed
-    if (s_canvas_layer) {
-      layer_mark_dirty(s_canvas_layer);
-    }
+    work_queue_post(apply_weather, WORK_PRIORITY_NORMAL);
+    work_queue_post(weather_module_save, WORK_PRIORITY_LOW);
   }
 
   // Handle outer clock analog ring toggle
   Tuple *clock_analog_tuple = dict_find(iter, MESSAGE_KEY_SHOW_CLOCK_ANALOG);
   if (clock_analog_tuple) {
     s_show_clock_analog = (clock_analog_tuple->value->int32 == 1);
-    if (s_canvas_layer) {
-      layer_mark_dirty(s_canvas_layer);
-    }
   }
   
   // Handle second ticker visibility setting
@@ -552,19 +692,14 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
   if (show_ticker_tuple) {
     s_show_second_ticker = (show_ticker_tuple->value->int32 == 1);
     // Switch tick frequency based on whether seconds are shown
-    tick_timer_service_subscribe(s_show_second_ticker ? SECOND_UNIT : MINUTE_UNIT, tick_handler);
-    if (s_canvas_layer) {
-      layer_mark_dirty(s_canvas_layer);
-    }
+    tick_timer_service_subscribe(ticker_shows_seconds() ? SECOND_UNIT : MINUTE_UNIT, tick_handler);
+    if (s_ui_loaded) apply_canvas_inputs();
   }
   
   // Handle clock ring visibility setting
   Tuple *show_ring_tuple = dict_find(iter, MESSAGE_KEY_SHOW_DECORATIVE_RING);
   if (show_ring_tuple) {
     s_show_decorative_ring = (show_ring_tuple->value->int32 == 1);
-    if (s_clock_ring_layer) {
-      layer_mark_dirty(s_clock_ring_layer);
-    }
   }
   
   // Handle step goal setting
@@ -576,9 +711,6 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
     if (s_show_step_tracker) {
       step_tracker_module_set_goal(s_step_goal);
     }
-    if (s_canvas_layer) {
-      layer_mark_dirty(s_canvas_layer);
-    }
   }
   
   // Handle splash logo style setting
@@ -603,19 +735,20 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
   Tuple *show_tracker_tuple = dict_find(iter, MESSAGE_KEY_SHOW_STEP_TRACKER);
   if (show_tracker_tuple) {
     s_show_step_tracker = (show_tracker_tuple->value->int32 == 1);
-    if (s_canvas_layer) {
-      layer_mark_dirty(s_canvas_layer);
-    }
-    // Clock ring radius depends on step tracker visibility
-    if (s_clock_ring_layer) {
-      layer_mark_dirty(s_clock_ring_layer);
-    }
   }
   
   // Handle show moon view setting
   Tuple *show_moon_tuple = dict_find(iter, MESSAGE_KEY_SHOW_MOON_VIEW);
   if (show_moon_tuple) {
     s_show_moon_view = (show_moon_tuple->value->int32 == 1);
+    weather_sync_module_set_enabled(s_show_weather || s_show_moon_view);
+  }
+  
+  // Handle moon view step history setting
+  Tuple *moon_history_tuple = dict_find(iter, MESSAGE_KEY_MOON_STEP_HISTORY);
+  if (moon_history_tuple) {
+    s_moon_step_history = (moon_history_tuple->value->int32 == 1);
+    moon_view_module_set_step_history(s_moon_step_history);
   }
   
   // Handle show weather setting
@@ -623,6 +756,7 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
   if (show_weather_tuple) {
     s_show_weather = (show_weather_tuple->value->int32 == 1);
     weather_display_module_set_visible(s_show_weather);
+    weather_sync_module_set_enabled(s_show_weather || s_show_moon_view);
   }
   
   // Handle weather scale setting
@@ -630,7 +764,7 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
   if (weather_scale_tuple) {
     s_weather_scale = atoi(weather_scale_tuple->value->cstring);
     weather_module_set_scale(s_weather_scale);
-    weather_display_module_update();
+    work_queue_post(apply_weather, WORK_PRIORITY_NORMAL);
   }
 
   // Handle use miles setting
@@ -651,42 +785,69 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
     s_center_logo_style = atoi(center_logo_style_tuple->value->cstring);
   }
 
-  // Always persist settings regardless of UI state
-  save_settings();
+  // Handle battery saver threshold setting
+  Tuple *battery_saver_tuple = dict_find(iter, MESSAGE_KEY_BATTERY_SAVER);
+  if (battery_saver_tuple) {
+    s_battery_saver = atoi(battery_saver_tuple->value->cstring);
+    power_governor_set_threshold(s_battery_saver);
+  }
+
+  // The phone asks for the render budget level and power tier by sending the keys
+  if (dict_find(iter, MESSAGE_KEY_RENDER_LEVEL)) {
+    render_budget_send_level();
+  }
+  if (dict_find(iter, MESSAGE_KEY_POWER_TIER)) {
+    power_governor_send_tier();
+  }
+
+  // Weather-only messages leave settings and settings-driven layers alone
+  bool settings_changed = false;
+  for (Tuple *t = dict_read_first(iter); t; t = dict_read_next(iter)) {
+    if (t->key != MESSAGE_KEY_WEATHER_DATA && t->key != MESSAGE_KEY_RENDER_LEVEL &&
+        t->key != MESSAGE_KEY_POWER_TIER) {
+      settings_changed = true;
+    }
+  }
+
+  // Persist settings regardless of UI state; a burst of messages is saved once
+  if (settings_changed) {
+    work_queue_post(save_settings, WORK_PRIORITY_LOW);
+    render_graph_invalidate(RENDER_INPUT_SETTINGS);
+  }
+
+  // A newly shown sparkline reads its backlog now, not on the next minute
+  if ((top_format_tuple || bottom_format_tuple || show_moon_tuple || moon_history_tuple) && step_history_shown()) {
+    work_queue_post(update_step_history, WORK_PRIORITY_NORMAL);
+  }
 
   // Only apply settings and redraw if the watchface UI has loaded
-  if (s_canvas_layer) {
+  if (s_ui_loaded) {
     
     // Handle step tracker enable/disable only when the setting actually changed
     if (show_tracker_tuple) {
       step_tracker_module_deinit();
       if (s_show_step_tracker) {
-        step_tracker_module_init(s_window, layer_get_bounds(window_get_root_layer(s_window)), s_canvas_layer);
+        step_tracker_module_init(s_window, layer_get_bounds(window_get_root_layer(s_window)));
         step_tracker_module_set_goal(s_step_goal);
-        step_tracker_module_subscribe();
-      } else {
-        step_tracker_module_unsubscribe();
       }
+      apply_step_subscription();
     } else if (step_goal_tuple && s_show_step_tracker) {
       step_tracker_module_set_goal(s_step_goal);
     }
     
-    // Force full redraw of all elements
-    layer_mark_dirty(s_canvas_layer);
-    if (s_clock_ring_layer) {
-      layer_mark_dirty(s_clock_ring_layer);
-    }
-    if (s_ampm_layer) {
-      layer_mark_dirty(s_ampm_layer);
-    }
-    update_time();
-    battery_module_update();
-
     // Reapply center logo mode if the setting changed
     if (center_logo_tuple || center_logo_style_tuple) {
       apply_center_logo(s_window);
     }
+
+    // Redraw only what the message touched (clock ring radius follows
+    // step tracker visibility, so it is a settings input too)
+    if (settings_changed) {
+      battery_module_update();
+    }
+    update_time();
   }
+  scenario_log_mark("inbox");
 }
 
 // ============================================================================
@@ -694,22 +855,20 @@ static void inbox_received_handler(DictionaryIterator *iter, void *context) {
 // ============================================================================
 
 static void prv_init(void) {
+  scenario_log_launch();
+
   // Load user settings
   load_settings();
+  date_format_init();
   
   // Initialize weather module
   weather_module_init();
+  step_history_module_init();
   
   // Load bitmap resources (only central)
   splash_logo_init();
   moon_view_module_init();
-
-  if (!check_if_24h()) {
-    s_am_active_bitmap = gbitmap_create_with_resource(RESOURCE_ID_AM_ACTIVE_IMAGE);
-    s_am_inactive_bitmap = gbitmap_create_with_resource(RESOURCE_ID_AM_INACTIVE_IMAGE);
-    s_pm_active_bitmap = gbitmap_create_with_resource(RESOURCE_ID_PM_ACTIVE_IMAGE);
-    s_pm_inactive_bitmap = gbitmap_create_with_resource(RESOURCE_ID_PM_INACTIVE_IMAGE);
-  }
+  moon_view_module_set_step_history(s_moon_step_history);
   
   // Create and set up main window
   s_window = window_create();
@@ -722,31 +881,45 @@ static void prv_init(void) {
   }
   
   // Subscribe to services — use SECOND_UNIT only when second ticker is enabled
-  tick_timer_service_subscribe(s_show_second_ticker && s_show_clock_analog ? SECOND_UNIT : MINUTE_UNIT, tick_handler);
-  accel_tap_service_subscribe(accel_tap_handler);
+  render_budget_module_init(render_level_handler);
+  power_governor_module_init(power_tier_handler);
+  power_governor_set_threshold(s_battery_saver);
+  tick_timer_service_subscribe(ticker_shows_seconds() && s_show_clock_analog ? SECOND_UNIT : MINUTE_UNIT, tick_handler);
+  apply_tap_subscription();
   
   // Modules handle their own subscriptions
-  battery_module_subscribe();
-  if (s_show_step_tracker) {
-    step_tracker_module_subscribe();
-  }
+  battery_state_service_subscribe(battery_handler);
+  apply_step_subscription();
+  weather_sync_module_set_enabled(s_show_weather || s_show_moon_view);
+  weather_sync_module_subscribe();
   
   // Set up app message for config communication
   app_message_register_inbox_received(inbox_received_handler);
+  message_outbox_module_init();
   app_message_open(512, 512);  // Increased buffer size for weather data
+
+  // Start from the current charge once the tier can be sent to the phone
+  power_governor_update(battery_state_service_peek());
 }
 
 static void prv_deinit(void) {
+  // Finish queued work (a settings save among it) while everything is alive
+  work_queue_drain();
+  work_queue_module_deinit();
+  message_outbox_module_deinit();
+
   // Unsubscribe from services
   tick_timer_service_unsubscribe();
   accel_tap_service_unsubscribe();
   
   // Modules handle their own unsubscriptions
-  battery_module_unsubscribe();
+  battery_state_service_unsubscribe();
   step_tracker_module_unsubscribe();
+  weather_sync_module_unsubscribe();
   
   // Deinit moon view module
   moon_view_module_deinit();
+  step_history_module_deinit();
   
   // Destroy window
   if (s_window) {
@@ -756,22 +929,6 @@ static void prv_deinit(void) {
   
   // Destroy bitmap resources (only central/splash elements)
   splash_logo_cleanup();
-  if (s_am_active_bitmap) {
-    gbitmap_destroy(s_am_active_bitmap);
-    s_am_active_bitmap = NULL;
-  }
-  if (s_am_inactive_bitmap) {
-    gbitmap_destroy(s_am_inactive_bitmap);
-    s_am_inactive_bitmap = NULL;
-  }
-  if (s_pm_active_bitmap) {
-    gbitmap_destroy(s_pm_active_bitmap);
-    s_pm_active_bitmap = NULL;
-  }
-  if (s_pm_inactive_bitmap) {
-    gbitmap_destroy(s_pm_inactive_bitmap);
-    s_pm_inactive_bitmap = NULL;
-  }
 }
 
 // ============================================================================
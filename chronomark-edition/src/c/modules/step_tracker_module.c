@@ -1,15 +1,21 @@
 #include "step_tracker_module.h"
+#include "../shared_modules/render_graph_module.h"
+#include "../shared_modules/face_renderer_module.h"
 
-static BitmapLayer *s_left_icon_layer = NULL;
-static BitmapLayer *s_right_icon_layer = NULL;
 static GBitmap *s_left_bitmap = NULL;
 static GBitmap *s_right_bitmap = NULL;
+static GRect s_left_icon_frame;
+static GRect s_right_icon_frame;
 static int s_step_count = 0;
 static int s_step_goal = 8000;
-static Layer *s_parent_canvas_layer = NULL;
 static int s_last_health_step_count = 0;
 static time_t s_last_health_update = 0;
 
+#if !RENDER_IMMEDIATE
+static BitmapLayer *s_left_icon_layer = NULL;
+static BitmapLayer *s_right_icon_layer = NULL;
+#endif
+
 static void health_handler(HealthEventType event, void *context) {
   // Update step count when health data changes
   if (event == HealthEventMovementUpdate || event == HealthEventSignificantUpdate) {
@@ -24,16 +30,16 @@ static void health_handler(HealthEventType event, void *context) {
     if (new_count - s_last_health_step_count >= 50 || new_count < s_last_health_step_count) {
       s_step_count = new_count;
       s_last_health_step_count = new_count;
-      if (s_parent_canvas_layer) {
-        layer_mark_dirty(s_parent_canvas_layer);
-      }
+      render_graph_invalidate(RENDER_INPUT_STEPS);
+      render_graph_flush();
     }
   }
 }
 
-void step_tracker_module_init(Window *window, GRect bounds, Layer *canvas_layer) {
+void step_tracker_module_init(Window *window, GRect bounds) {
+#if !RENDER_IMMEDIATE
   Layer *window_layer = window_get_root_layer(window);
-  s_parent_canvas_layer = canvas_layer;
+#endif
   
   // Load bitmap resources
   s_left_bitmap = gbitmap_create_with_resource(RESOURCE_ID_WALKING_IMAGE);
@@ -47,24 +53,30 @@ void step_tracker_module_init(Window *window, GRect bounds, Layer *canvas_layer)
   if (s_left_bitmap) {
     int icon_x = 0 + (bounds.size.w / 2 - radius);
     int icon_y = cy - WALKING_ICON_SIZE;
-    s_left_icon_layer = bitmap_layer_create(GRect(icon_x, icon_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE));
+    s_left_icon_frame = GRect(icon_x, icon_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE);
+#if !RENDER_IMMEDIATE
+    s_left_icon_layer = bitmap_layer_create(s_left_icon_frame);
     if (s_left_icon_layer) {
       bitmap_layer_set_bitmap(s_left_icon_layer, s_left_bitmap);
       bitmap_layer_set_compositing_mode(s_left_icon_layer, GCompOpSet);
       layer_add_child(window_layer, bitmap_layer_get_layer(s_left_icon_layer));
     }
+#endif
   }
 
   // Right icon at 90° (bottom of arc)
   if (s_right_bitmap) {
     int icon_x = bounds.size.w - (bounds.size.w / 2 - radius) - WALKING_ICON_SIZE;
     int icon_y = cy - WALKING_ICON_SIZE;
-    s_right_icon_layer = bitmap_layer_create(GRect(icon_x, icon_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE));
+    s_right_icon_frame = GRect(icon_x, icon_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE);
+#if !RENDER_IMMEDIATE
+    s_right_icon_layer = bitmap_layer_create(s_right_icon_frame);
     if (s_right_icon_layer) {
       bitmap_layer_set_bitmap(s_right_icon_layer, s_right_bitmap);
       bitmap_layer_set_compositing_mode(s_right_icon_layer, GCompOpSet);
       layer_add_child(window_layer, bitmap_layer_get_layer(s_right_icon_layer));
     }
+#endif
   }
   
   // Initialize step count
@@ -93,18 +105,24 @@ void step_tracker_module_draw(Layer *layer, GContext *ctx, GRect bounds, int rad
   }
 }
 
+#if RENDER_IMMEDIATE
+void step_tracker_module_draw_icons(GContext *ctx, GRect bounds) {
+  face_renderer_draw_bitmap(ctx, s_left_bitmap, s_left_icon_frame);
+  face_renderer_draw_bitmap(ctx, s_right_bitmap, s_right_icon_frame);
+}
+#endif
+
 void step_tracker_module_update(void) {
-  s_step_count = (int)health_service_sum_today(HealthMetricStepCount);
-  if (s_parent_canvas_layer) {
-    layer_mark_dirty(s_parent_canvas_layer);
+  int count = (int)health_service_sum_today(HealthMetricStepCount);
+  if (count != s_step_count) {
+    s_step_count = count;
+    render_graph_invalidate(RENDER_INPUT_STEPS);
   }
 }
 
 void step_tracker_module_set_goal(int goal) {
   s_step_goal = goal;
-  if (s_parent_canvas_layer) {
-    layer_mark_dirty(s_parent_canvas_layer);
-  }
+  render_graph_invalidate(RENDER_INPUT_STEPS);
 }
 
 int step_tracker_module_get_count(void) {
@@ -122,6 +140,7 @@ void step_tracker_module_unsubscribe(void) {
 
 void step_tracker_module_deinit(void) {
   // Destroy bitmap layers
+#if !RENDER_IMMEDIATE
   if (s_left_icon_layer) {
     bitmap_layer_destroy(s_left_icon_layer);
     s_left_icon_layer = NULL;
@@ -130,6 +149,7 @@ void step_tracker_module_deinit(void) {
     bitmap_layer_destroy(s_right_icon_layer);
     s_right_icon_layer = NULL;
   }
+#endif
   
   // Destroy bitmaps
   if (s_left_bitmap) {
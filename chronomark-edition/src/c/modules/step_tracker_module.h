@@ -1,5 +1,6 @@
 #pragma once
 #include <pebble.h>
+#include "../utilities/render_mode.h"
 
 // Step Tracker Module - Step Progress Arc and Icons
 
@@ -7,7 +8,7 @@
 #define STEP_TRACK_MARGIN 4
 #define WALKING_ICON_SIZE 20
 
-void step_tracker_module_init(Window *window, GRect bounds, Layer *canvas_layer);
+void step_tracker_module_init(Window *window, GRect bounds);
 void step_tracker_module_update(void);
 void step_tracker_module_deinit(void);
 void step_tracker_module_subscribe(void);
@@ -15,3 +16,6 @@ void step_tracker_module_unsubscribe(void);
 void step_tracker_module_set_goal(int goal);
 int step_tracker_module_get_count(void);
 void step_tracker_module_draw(Layer *layer, GContext *ctx, GRect bounds, int radius, GRect arc_bounds);
+
+// Immediate mode: draws the two track icons at the frames computed in init
+void step_tracker_module_draw_icons(GContext *ctx, GRect bounds);
@@ -1,8 +1,11 @@
 #include "moon_view.h"
 #include "../modules/sun_tracker_module.h"
 #include "../utilities/weather.h"
+#include "../utilities/scenario_log.h"
 #include "../modules/step_tracker_module.h" // for STEP_TRACK_WIDTH, STEP_TRACK_MARGIN
 #include "../utilities/date_format.h"
+#include "../shared_modules/moon_phase_module.h"
+#include "../shared_modules/step_history_module.h"
 #include "../modules/outer_ring_module.h"
 
 static Window *s_moon_window = NULL;
@@ -10,23 +13,23 @@ static TextLayer *s_sunrise_text_layer = NULL;
 static TextLayer *s_sunset_text_layer = NULL;
 static Layer *s_sun_canvas_layer = NULL;
 static GBitmap *bitmap_moon_background = NULL;
-static GBitmap *bitmap_moon_phase = NULL;
 static BitmapLayer *s_bg_bitmap_layer = NULL;
-static BitmapLayer *s_phase_bitmap_layer = NULL;
-
-// Moon phase resource IDs indexed by moon_phase_icon (1-7)
-static const uint32_t s_moon_phase_resources[] = {
-  0, // index 0 unused
-  RESOURCE_ID_MOON_PHASE_1_IMAGE,
-  RESOURCE_ID_MOON_PHASE_2_IMAGE,
-  RESOURCE_ID_MOON_PHASE_3_IMAGE,
-  RESOURCE_ID_MOON_PHASE_4_IMAGE,
-  RESOURCE_ID_MOON_PHASE_5_IMAGE,
-  RESOURCE_ID_MOON_PHASE_6_IMAGE,
-  RESOURCE_ID_MOON_PHASE_7_IMAGE,
-};
+static Layer *s_phase_layer = NULL;
+static int s_moon_phase = -1;
+static Layer *s_history_layer = NULL;
+static bool s_show_step_history = false;
+
+static void moon_phase_update_proc(Layer *layer, GContext *ctx) {
+  if (s_moon_phase < 0) return;
+  moon_phase_module_draw(ctx, layer_get_bounds(layer), s_moon_phase);
+}
+
+static void step_history_update_proc(Layer *layer, GContext *ctx) {
+  step_history_module_draw(ctx, layer_get_bounds(layer), GColorWhite);
+}
 
 static void sun_canvas_update_proc(Layer *layer, GContext *ctx) {
+  scenario_log_frame();
   GRect bounds = layer_get_bounds(layer);
 
   // Draw outer ring with hour numbers and tickers
@@ -53,11 +56,22 @@ static void sun_canvas_update_proc(Layer *layer, GContext *ctx) {
   sun_tracker_module_draw(layer, ctx, bounds, radius, arc_bounds);
 }
 
+// Frame of the moon art, centered slightly below the middle of the window
+static GRect moon_frame(GBitmap *bitmap, GRect bounds) {
+  GSize size;
+  if (bitmap) {
+    size = gbitmap_get_bounds(bitmap).size;
+  } else {
+    int diameter = (bounds.size.w < bounds.size.h ? bounds.size.w : bounds.size.h) * 2 / 3;
+    size = GSize(diameter, diameter);
+  }
+  int x = (bounds.size.w - size.w) / 2 + 1;
+  int y = (bounds.size.h - size.h) / 2 + 7;
+  return GRect(x, y, size.w, size.h);
+}
+
 static BitmapLayer *create_centered_bitmap_layer(Layer *parent, GBitmap *bitmap, GRect bounds) {
-  GRect bitmap_bounds = gbitmap_get_bounds(bitmap);
-  int x = (bounds.size.w - bitmap_bounds.size.w) / 2 + 1;
-  int y = (bounds.size.h - bitmap_bounds.size.h) / 2 + 7;
-  BitmapLayer *layer = bitmap_layer_create(GRect(x, y, bitmap_bounds.size.w, bitmap_bounds.size.h));
+  BitmapLayer *layer = bitmap_layer_create(moon_frame(bitmap, bounds));
   if (layer) {
     bitmap_layer_set_bitmap(layer, bitmap);
     bitmap_layer_set_compositing_mode(layer, GCompOpSet);
@@ -92,9 +106,7 @@ static void moon_window_load(Window *window) {
   // Load moon bitmaps
   bitmap_moon_background = gbitmap_create_with_resource(RESOURCE_ID_MOON_BACKGROUND_IMAGE);
 
-  if (has_weather && weather->moon_phase_icon >= 1 && weather->moon_phase_icon <= 7) {
-    bitmap_moon_phase = gbitmap_create_with_resource(s_moon_phase_resources[weather->moon_phase_icon]);
-  }
+  s_moon_phase = has_weather ? weather->moon_phase : -1;
 
   // Sun tracker bar
   s_sun_canvas_layer = layer_create(bounds);
@@ -129,10 +141,24 @@ static void moon_window_load(Window *window) {
   s_sunrise_text_layer = create_info_text_layer(window_layer, GRect(0, 45, bounds.size.w, 50), sunrise_buf);
   s_sunset_text_layer = create_info_text_layer(window_layer, GRect(0, 65, bounds.size.w, 50), sunset_buf);
 
-  // Moon phase bitmaps
-  s_bg_bitmap_layer = create_centered_bitmap_layer(window_layer, bitmap_moon_background, bounds);
-  if (bitmap_moon_phase) {
-    s_phase_bitmap_layer = create_centered_bitmap_layer(window_layer, bitmap_moon_phase, bounds);
+  // Lit area of the moon, drawn beneath the line art
+  s_phase_layer = layer_create(moon_frame(bitmap_moon_background, bounds));
+  if (s_phase_layer) {
+    layer_set_update_proc(s_phase_layer, moon_phase_update_proc);
+    layer_add_child(window_layer, s_phase_layer);
+  }
+  if (bitmap_moon_background) {
+    s_bg_bitmap_layer = create_centered_bitmap_layer(window_layer, bitmap_moon_background, bounds);
+  }
+
+  // Today's steps per hour beneath the moon
+  if (s_show_step_history) {
+    GRect moon = moon_frame(bitmap_moon_background, bounds);
+    s_history_layer = layer_create(GRect(bounds.size.w / 2 - 48, moon.origin.y + moon.size.h + 4, 96, 14));
+    if (s_history_layer) {
+      layer_set_update_proc(s_history_layer, step_history_update_proc);
+      layer_add_child(window_layer, s_history_layer);
+    }
   }
 
   // Auto-dismiss after 5 seconds
@@ -140,20 +166,21 @@ static void moon_window_load(Window *window) {
 }
 
 static void moon_window_unload(Window *window) {
+  scenario_log_expect_frame("moon_hide");
   sun_tracker_module_deinit();
 
-  if (s_phase_bitmap_layer) {
-    bitmap_layer_destroy(s_phase_bitmap_layer);
-    s_phase_bitmap_layer = NULL;
+  if (s_history_layer) {
+    layer_destroy(s_history_layer);
+    s_history_layer = NULL;
+  }
+  if (s_phase_layer) {
+    layer_destroy(s_phase_layer);
+    s_phase_layer = NULL;
   }
   if (s_bg_bitmap_layer) {
     bitmap_layer_destroy(s_bg_bitmap_layer);
     s_bg_bitmap_layer = NULL;
   }
-  if (bitmap_moon_phase) {
-    gbitmap_destroy(bitmap_moon_phase);
-    bitmap_moon_phase = NULL;
-  }
   if (bitmap_moon_background) {
     gbitmap_destroy(bitmap_moon_background);
     bitmap_moon_background = NULL;
@@ -191,6 +218,8 @@ void moon_view_module_deinit(void) {
 
 void moon_view_module_show(void) {
   if (s_moon_window) {
+    scenario_log_mark("moon_show");
+    scenario_log_expect_frame("moon_frame");
     window_stack_push(s_moon_window, true);
   }
 }
@@ -200,3 +229,7 @@ void moon_view_module_hide(void) {
     window_stack_remove(s_moon_window, true);
   }
 }
+
+void moon_view_module_set_step_history(bool show) {
+  s_show_step_history = show;
+}
@@ -7,3 +7,6 @@ void moon_view_module_init(void);
 void moon_view_module_deinit(void);
 void moon_view_module_show(void);
 void moon_view_module_hide(void);
+
+// Show today's steps per hour beneath the moon (applies on the next show)
+void moon_view_module_set_step_history(bool show);
@@ -1,11 +1,16 @@
 #include "battery_module.h"
+#include "render_graph_module.h"
 
-static Layer *s_battery_layer = NULL;
+static GRect s_frame;
+static bool s_active = false;
 static int s_battery_percent = 100;
 static bool s_battery_is_charging = false;
 
-static void battery_update_proc(Layer *layer, GContext *ctx) {
-  GRect bounds = layer_get_bounds(layer);
+#if !RENDER_IMMEDIATE
+static Layer *s_battery_layer = NULL;
+#endif
+
+static void draw_battery(GContext *ctx, GRect bounds) {
   int max_filled_width = bounds.size.w - 4;
   int filled_width = (s_battery_percent * max_filled_width) / 100;
   
@@ -40,27 +45,41 @@ static void battery_update_proc(Layer *layer, GContext *ctx) {
   }
 }
 
-static void battery_handler(BatteryChargeState state) {
+#if !RENDER_IMMEDIATE
+static void battery_update_proc(Layer *layer, GContext *ctx) {
+  draw_battery(ctx, layer_get_bounds(layer));
+}
+#endif
+
+void battery_module_set_state(BatteryChargeState state) {
+  // The service repeats unchanged readings; only a new one is worth a frame
+  bool changed = state.charge_percent != s_battery_percent || state.is_charging != s_battery_is_charging;
   s_battery_percent = state.charge_percent;
   s_battery_is_charging = state.is_charging;
-  if (s_battery_layer) {
-    layer_mark_dirty(s_battery_layer);
+  if (s_active && changed) {
+    render_graph_invalidate(RENDER_INPUT_BATTERY);
+    render_graph_flush();
   }
 }
 
 void battery_module_init(Window *window, GRect bounds, int y_offset) {
-  if (s_battery_layer) return;  // Guard against double-init
+  if (s_active) return;  // Guard against double-init
+  s_active = true;
+  
+  s_frame = GRect((bounds.size.w - BATTERY_WIDTH) / 2 - 2, y_offset,
+                  BATTERY_WIDTH + 4, BATTERY_HEIGHT + 4);
   
+#if !RENDER_IMMEDIATE
   Layer *window_layer = window_get_root_layer(window);
   
   // Create battery indicator layer
-  s_battery_layer = layer_create(GRect((bounds.size.w - BATTERY_WIDTH) / 2 - 2,
-                                       y_offset,
-                                       BATTERY_WIDTH + 4, BATTERY_HEIGHT + 4));
+  s_battery_layer = layer_create(s_frame);
   if (s_battery_layer) {
     layer_set_update_proc(s_battery_layer, battery_update_proc);
     layer_add_child(window_layer, s_battery_layer);
+    render_graph_add(s_battery_layer, RENDER_INPUT_BATTERY | RENDER_INPUT_VISIBILITY);
   }
+#endif
   
   // Initialize battery level
   BatteryChargeState charge = battery_state_service_peek();
@@ -72,22 +91,22 @@ void battery_module_update(void) {
   BatteryChargeState charge = battery_state_service_peek();
   s_battery_percent = charge.charge_percent;
   s_battery_is_charging = charge.is_charging;
-  if (s_battery_layer) {
-    layer_mark_dirty(s_battery_layer);
-  }
-}
-
-void battery_module_subscribe(void) {
-  battery_state_service_subscribe(battery_handler);
+  render_graph_invalidate(RENDER_INPUT_BATTERY);
 }
 
-void battery_module_unsubscribe(void) {
-  battery_state_service_unsubscribe();
+#if RENDER_IMMEDIATE
+void battery_module_draw(GContext *ctx, GRect bounds) {
+  if (s_active) draw_battery(ctx, s_frame);
 }
+#endif
 
 void battery_module_deinit(void) {
+  s_active = false;
+#if !RENDER_IMMEDIATE
   if (s_battery_layer) {
+    render_graph_remove(s_battery_layer);
     layer_destroy(s_battery_layer);
     s_battery_layer = NULL;
   }
+#endif
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <pebble.h>
+#include "../utilities/render_mode.h"
 
 // Battery Module - Battery Indicator Display
 
@@ -9,5 +10,9 @@
 void battery_module_init(Window *window, GRect bounds, int y_offset);
 void battery_module_update(void);
 void battery_module_deinit(void);
-void battery_module_subscribe(void);
-void battery_module_unsubscribe(void);
+
+// New reading from the app's battery handler; kept while the indicator is hidden
+void battery_module_set_state(BatteryChargeState state);
+
+// Immediate mode: draws the indicator at the frame computed in init
+void battery_module_draw(GContext *ctx, GRect bounds);
@@ -0,0 +1,57 @@
+#include "face_renderer_module.h"
+#include "render_budget_module.h"
+
+static Layer *s_face_layer = NULL;
+static FaceDrawProc s_procs[FACE_RENDERER_MAX_PROCS];
+static int s_proc_count = 0;
+
+static void face_update_proc(Layer *layer, GContext *ctx) {
+  GRect bounds = layer_get_bounds(layer);
+  render_budget_begin(ctx);
+  for (int i = 0; i < s_proc_count; i++) {
+    s_procs[i](ctx, bounds);
+  }
+  render_budget_end();
+}
+
+void face_renderer_module_init(Window *window, RenderInputs inputs) {
+  if (s_face_layer) return;  // Guard against double-init
+
+  Layer *window_layer = window_get_root_layer(window);
+  s_face_layer = layer_create(layer_get_bounds(window_layer));
+  if (s_face_layer) {
+    layer_set_update_proc(s_face_layer, face_update_proc);
+    layer_add_child(window_layer, s_face_layer);
+    render_graph_add(s_face_layer, inputs);
+  }
+  s_proc_count = 0;
+}
+
+void face_renderer_module_add(FaceDrawProc proc) {
+  if (!proc || s_proc_count >= FACE_RENDERER_MAX_PROCS) return;
+  s_procs[s_proc_count++] = proc;
+}
+
+void face_renderer_module_set_inputs(RenderInputs inputs) {
+  render_graph_add(s_face_layer, inputs);
+}
+
+void face_renderer_module_deinit(void) {
+  if (s_face_layer) {
+    render_graph_remove(s_face_layer);
+    layer_destroy(s_face_layer);
+    s_face_layer = NULL;
+  }
+  s_proc_count = 0;
+}
+
+void face_renderer_draw_bitmap(GContext *ctx, GBitmap *bitmap, GRect frame) {
+  if (!bitmap) return;
+
+  GRect bitmap_bounds = gbitmap_get_bounds(bitmap);
+  GRect rect = GRect(frame.origin.x + (frame.size.w - bitmap_bounds.size.w) / 2,
+                     frame.origin.y + (frame.size.h - bitmap_bounds.size.h) / 2,
+                     bitmap_bounds.size.w, bitmap_bounds.size.h);
+  graphics_context_set_compositing_mode(ctx, GCompOpSet);
+  graphics_draw_bitmap_in_rect(ctx, bitmap, rect);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <pebble.h>
+#include "../utilities/render_mode.h"
+#include "render_graph_module.h"
+
+// Face Renderer Module - Immediate-mode alternative to the layer tree
+//
+// One full-screen layer calls the registered draw procs in registration
+// order (that is the draw order). Only used when RENDER_IMMEDIATE is set.
+
+#define FACE_RENDERER_MAX_PROCS 12
+
+typedef void (*FaceDrawProc)(GContext *ctx, GRect bounds);
+
+// Creates the face layer and registers it with the render graph
+void face_renderer_module_init(Window *window, RenderInputs inputs);
+
+// Appends a draw proc; later procs draw on top of earlier ones
+void face_renderer_module_add(FaceDrawProc proc);
+
+// Updates which inputs redraw the face (e.g. when the second ticker toggles)
+void face_renderer_module_set_inputs(RenderInputs inputs);
+
+void face_renderer_module_deinit(void);
+
+// Draws a bitmap centred in frame, like a BitmapLayer with GCompOpSet
+void face_renderer_draw_bitmap(GContext *ctx, GBitmap *bitmap, GRect frame);
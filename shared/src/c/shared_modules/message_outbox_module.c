@@ -0,0 +1,102 @@
+#include "message_outbox_module.h"
+
+typedef struct {
+  uint32_t key;
+  uint8_t value;
+  int attempts;
+} OutboxMessage;
+
+static OutboxMessage s_messages[MESSAGE_OUTBOX_SIZE];
+static int s_count = 0;
+static bool s_in_flight = false;
+static AppTimer *s_retry_timer = NULL;
+
+static void try_send(void);
+
+static void retry_callback(void *data) {
+  s_retry_timer = NULL;
+  try_send();
+}
+
+// The head message failed once more; wait, or give up on it
+static void schedule_retry(void) {
+  if (++s_messages[0].attempts >= MESSAGE_OUTBOX_MAX_ATTEMPTS) {
+    memmove(&s_messages[0], &s_messages[1], (size_t)(--s_count) * sizeof(s_messages[0]));
+    try_send();
+    return;
+  }
+  if (!s_retry_timer) {
+    s_retry_timer = app_timer_register(MESSAGE_OUTBOX_RETRY_MS << (s_messages[0].attempts - 1),
+                                       retry_callback, NULL);
+  }
+}
+
+static void try_send(void) {
+  if (s_in_flight || s_retry_timer || s_count == 0) return;
+
+  DictionaryIterator *iter;
+  if (!connection_service_peek_pebble_app_connection() ||
+      app_message_outbox_begin(&iter) != APP_MSG_OK || !iter) {
+    schedule_retry();
+    return;
+  }
+  dict_write_uint8(iter, s_messages[0].key, s_messages[0].value);
+  if (app_message_outbox_send() != APP_MSG_OK) {
+    schedule_retry();
+    return;
+  }
+  s_in_flight = true;
+}
+
+static void outbox_sent_handler(DictionaryIterator *iter, void *context) {
+  s_in_flight = false;
+  if (s_count > 0) {
+    memmove(&s_messages[0], &s_messages[1], (size_t)(--s_count) * sizeof(s_messages[0]));
+  }
+  try_send();
+}
+
+static void outbox_failed_handler(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+  s_in_flight = false;
+  if (s_count > 0) schedule_retry();
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Modules may queue before this; their messages wait for the first retry
+void message_outbox_module_init(void) {
+  app_message_register_outbox_sent(outbox_sent_handler);
+  app_message_register_outbox_failed(outbox_failed_handler);
+}
+
+void message_outbox_send_uint8(uint32_t key, uint8_t value) {
+  for (int i = 0; i < s_count; i++) {
+    if (s_messages[i].key == key) {
+      // The head may be in flight with the old value; the newer one follows it
+      if (i > 0 || !s_in_flight) {
+        s_messages[i].value = value;
+        return;
+      }
+    }
+  }
+  if (s_count == MESSAGE_OUTBOX_SIZE) {
+    // Oldest queued message that is not in flight makes room
+    int drop = s_in_flight ? 1 : 0;
+    memmove(&s_messages[drop], &s_messages[drop + 1],
+            (size_t)(s_count - drop - 1) * sizeof(s_messages[0]));
+    s_count--;
+  }
+  s_messages[s_count++] = (OutboxMessage){ .key = key, .value = value };
+  try_send();
+}
+
+void message_outbox_module_deinit(void) {
+  if (s_retry_timer) {
+    app_timer_cancel(s_retry_timer);
+    s_retry_timer = NULL;
+  }
+  s_count = 0;
+  s_in_flight = false;
+}
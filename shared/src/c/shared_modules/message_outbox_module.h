@@ -0,0 +1,22 @@
+#pragma once
+#include <pebble.h>
+
+// Message Outbox Module - The watch's one AppMessage sender
+//
+// Modules queue a key with a uint8 value; a key that is already queued keeps
+// its place and takes the newer value. One message is in flight at a time
+// and leaves the queue only when the phone acks it. A refused or failed send
+// is retried after MESSAGE_OUTBOX_RETRY_MS, doubling every attempt, and
+// dropped after MESSAGE_OUTBOX_MAX_ATTEMPTS (the phone can ask again).
+
+#define MESSAGE_OUTBOX_SIZE 4
+#define MESSAGE_OUTBOX_MAX_ATTEMPTS 5
+#define MESSAGE_OUTBOX_RETRY_MS 1000
+
+// Registers the sent/failed handlers; call before app_message_open
+void message_outbox_module_init(void);
+
+void message_outbox_send_uint8(uint32_t key, uint8_t value);
+
+// Drop queued messages and the pending retry
+void message_outbox_module_deinit(void);
@@ -0,0 +1,39 @@
+#include "moon_phase_module.h"
+
+// Integer square root (Newton's method), enough for radii in pixels
+static int32_t isqrt_i32(int32_t value) {
+  if (value <= 0) return 0;
+  int32_t x = value;
+  int32_t y = (x + 1) / 2;
+  while (y < x) {
+    x = y;
+    y = (x + value / x) / 2;
+  }
+  return x;
+}
+
+void moon_phase_module_draw(GContext *ctx, GRect frame, int phase) {
+  int radius = (frame.size.w < frame.size.h ? frame.size.w : frame.size.h) / 2;
+  if (radius <= 0) return;
+
+  if (phase < 0) phase = 0;
+  if (phase > 100) phase = 100;
+
+  // Terminator position as a fraction of each row's half-width:
+  // waxing lights [k*w, w] on the right, waning lights [-w, -k*w] on the left
+  int32_t k = cos_lookup((TRIG_MAX_ANGLE * phase) / 100);
+  bool waxing = phase <= 50;
+
+  GPoint center = grect_center_point(&frame);
+  graphics_context_set_fill_color(ctx, GColorWhite);
+
+  for (int dy = -radius; dy <= radius; dy++) {
+    int half = isqrt_i32(radius * radius - dy * dy);
+    int edge = (int)((k * half) / TRIG_MAX_RATIO);
+    int x0 = waxing ? edge : -half;
+    int x1 = waxing ? half : -edge;
+    if (x1 > x0) {
+      graphics_fill_rect(ctx, GRect(center.x + x0, center.y + dy, x1 - x0, 1), 0, GCornerNone);
+    }
+  }
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <pebble.h>
+
+// Moon Phase Module - Procedural lit-area renderer for the moon views
+
+// Fills the sunlit part of a disc inscribed in `frame` for phase 0-100
+// (0=new, 50=full, 100=new). Draw the moon line art on top of it.
+void moon_phase_module_draw(GContext *ctx, GRect frame, int phase);
@@ -0,0 +1,68 @@
+#include "power_governor_module.h"
+#include "message_outbox_module.h"
+
+static PowerTierHandler s_handler = NULL;
+static PowerTier s_tier = POWER_TIER_FULL;
+static int s_threshold = POWER_GOVERNOR_DEFAULT_THRESHOLD;
+static BatteryChargeState s_state = { .charge_percent = 100 };
+static bool s_first_reading = true;
+
+// Charge at or below which a tier starts: the threshold, then 2/3 and 1/3 of it
+static int tier_start(PowerTier tier) {
+  return s_threshold * (POWER_TIER_MAX + 1 - tier) / POWER_TIER_MAX;
+}
+
+static PowerTier tier_for(int percent) {
+  PowerTier tier = POWER_TIER_FULL;
+  for (PowerTier t = POWER_TIER_FULL + 1; t <= POWER_TIER_MAX; t++) {
+    if (percent <= tier_start(t)) tier = t;
+  }
+  return tier;
+}
+
+static void evaluate(void) {
+  PowerTier target = POWER_TIER_FULL;
+  if (s_threshold > 0 && !s_state.is_charging && !s_state.is_plugged) {
+    target = tier_for(s_state.charge_percent);
+    if (target < s_tier) {
+      // Hold the current tier until the charge is clearly back above its start
+      PowerTier held = tier_for(s_state.charge_percent - POWER_GOVERNOR_HYSTERESIS);
+      target = held < s_tier ? held : s_tier;
+    }
+  }
+  if (target == s_tier) return;
+  s_tier = target;
+  if (s_handler) s_handler(target);
+  power_governor_send_tier();
+}
+
+void power_governor_module_init(PowerTierHandler handler) {
+  s_handler = handler;
+  s_tier = POWER_TIER_FULL;
+  // The phone hears the tier on the first reading even when it stays full
+  s_first_reading = true;
+}
+
+void power_governor_set_threshold(int percent) {
+  s_threshold = percent < 0 ? 0 : (percent > 100 ? 100 : percent);
+  evaluate();
+}
+
+void power_governor_update(BatteryChargeState state) {
+  s_state = state;
+  evaluate();
+  if (s_first_reading) power_governor_send_tier();
+}
+
+PowerTier power_governor_get_tier(void) {
+  return s_tier;
+}
+
+int power_governor_refresh_scale(void) {
+  return 1 << s_tier;
+}
+
+void power_governor_send_tier(void) {
+  s_first_reading = false;
+  message_outbox_send_uint8(MESSAGE_KEY_POWER_TIER, (uint8_t)s_tier);
+}
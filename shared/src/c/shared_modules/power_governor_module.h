@@ -0,0 +1,41 @@
+#pragma once
+#include <pebble.h>
+
+// Power Governor Module - Steps the face down as the battery drains
+//
+// Fed every battery reading (the app's battery handler forwards them). At or below the
+// saver threshold the face sheds work one tier at a time, the deeper tiers
+// at two thirds and one third of the threshold. Tiers come back once the
+// charge is POWER_GOVERNOR_HYSTERESIS above where they started, and all at
+// once while charging. Every change is reported to the app and pushed to
+// the phone as MESSAGE_KEY_POWER_TIER so pkjs stretches its refresh too.
+
+// Shed in this order, restored in reverse
+typedef enum {
+  POWER_TIER_FULL = 0,
+  POWER_TIER_MINUTE_TICKER,   // Second ticker only moves once a minute
+  POWER_TIER_NO_TAP,          // Moon view tap subscription suspended
+  POWER_TIER_POLL_HEALTH,     // Health events off, steps read on the minute tick
+} PowerTier;
+
+#define POWER_TIER_MAX POWER_TIER_POLL_HEALTH
+
+#define POWER_GOVERNOR_DEFAULT_THRESHOLD 30  // Percent; 0 turns the governor off
+#define POWER_GOVERNOR_HYSTERESIS 5          // Percent above a tier's start before it is restored
+
+typedef void (*PowerTierHandler)(PowerTier tier);
+
+void power_governor_module_init(PowerTierHandler handler);
+
+// Saver threshold in percent, re-evaluated against the last reading
+void power_governor_set_threshold(int percent);
+
+void power_governor_update(BatteryChargeState state);
+
+PowerTier power_governor_get_tier(void);
+
+// Weather refresh spacing multiplier: doubles with every tier
+int power_governor_refresh_scale(void);
+
+// Push the current tier to the phone (also used to answer a POWER_TIER request)
+void power_governor_send_tier(void);
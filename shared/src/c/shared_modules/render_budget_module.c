@@ -0,0 +1,89 @@
+#include "render_budget_module.h"
+#include "message_outbox_module.h"
+#include "../utilities/scenario_log.h"
+
+static RenderLevelHandler s_handler = NULL;
+static RenderLevel s_level = RENDER_LEVEL_FULL;
+
+// Rolling cost, average of recent frames in ms (x4 fixed point)
+static uint32_t s_average_x4 = 0;
+static uint32_t s_frame_ms = 0;
+static bool s_frame_drawn = false;
+static uint32_t s_begin_ms = 0;
+static int s_over_count = 0;
+static int s_under_count = 0;
+static uint32_t s_under_since_ms = 0;
+
+static uint32_t now_ms(void) {
+  time_t seconds;
+  uint16_t millis;
+  time_ms(&seconds, &millis);
+  // Wraps, but differences stay correct in unsigned arithmetic
+  return (uint32_t)seconds * 1000 + millis;
+}
+
+static void set_level(RenderLevel level) {
+  if (level == s_level) return;
+  s_level = level;
+  s_over_count = 0;
+  s_under_count = 0;
+  if (s_handler) s_handler(level);
+  render_budget_send_level();
+}
+
+void render_budget_module_init(RenderLevelHandler handler) {
+  s_handler = handler;
+  s_level = RENDER_LEVEL_FULL;
+  s_average_x4 = 0;
+  s_frame_ms = 0;
+  s_frame_drawn = false;
+  s_over_count = 0;
+  s_under_count = 0;
+}
+
+void render_budget_begin(GContext *ctx) {
+  graphics_context_set_antialiased(ctx, s_level < RENDER_LEVEL_NO_ANTIALIAS);
+  s_begin_ms = now_ms();
+}
+
+void render_budget_end(void) {
+  s_frame_ms += now_ms() - s_begin_ms;
+  s_frame_drawn = true;
+  scenario_log_frame();
+}
+
+void render_budget_frame(void) {
+  if (!s_frame_drawn) return;
+
+  // Exponential moving average, weight 1/4 for the newest frame
+  s_average_x4 = s_average_x4 - s_average_x4 / 4 + s_frame_ms;
+  uint32_t average = s_average_x4 / 4;
+  s_frame_ms = 0;
+  s_frame_drawn = false;
+
+  if (average > RENDER_BUDGET_MS) {
+    s_under_count = 0;
+    if (++s_over_count >= RENDER_BUDGET_SHED_FRAMES && s_level < RENDER_LEVEL_MAX) {
+      set_level(s_level + 1);
+    }
+  } else if (average < RENDER_BUDGET_MS / 2) {
+    s_over_count = 0;
+    uint32_t now = now_ms();
+    if (s_under_count++ == 0) s_under_since_ms = now;
+    if (s_under_count >= RENDER_BUDGET_SHED_FRAMES &&
+        now - s_under_since_ms >= RENDER_BUDGET_RESTORE_MS && s_level > RENDER_LEVEL_FULL) {
+      set_level(s_level - 1);
+    }
+  } else {
+    s_over_count = 0;
+    s_under_count = 0;
+  }
+}
+
+RenderLevel render_budget_get_level(void) {
+  return s_level;
+}
+
+void render_budget_send_level(void) {
+  message_outbox_send_uint8(MESSAGE_KEY_RENDER_LEVEL, (uint8_t)s_level);
+}
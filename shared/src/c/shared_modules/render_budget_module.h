@@ -0,0 +1,50 @@
+#pragma once
+#include <pebble.h>
+
+// Render Budget Module - Watchdog that sheds optional drawing when frames run long
+//
+// Draw procs are bracketed with render_budget_begin/end and timed with
+// time_ms(). Once per frame the total is folded into a rolling average;
+// repeated overruns step the level up (shedding one feature), sustained
+// headroom steps it back down. Every change is reported to the app and
+// pushed to the phone as MESSAGE_KEY_RENDER_LEVEL.
+
+// Shed in this order, restored in reverse
+typedef enum {
+  RENDER_LEVEL_FULL = 0,
+  RENDER_LEVEL_NO_ANTIALIAS,       // Draw without anti-aliasing
+  RENDER_LEVEL_MINUTE_TICKER,      // Second ticker only moves once a minute
+  RENDER_LEVEL_NO_DECORATIVE_RING, // Skip the decorative ring
+} RenderLevel;
+
+#define RENDER_LEVEL_MAX RENDER_LEVEL_NO_DECORATIVE_RING
+
+// Per-platform frame budget
+#if defined(PBL_PLATFORM_APLITE)
+#define RENDER_BUDGET_MS 45
+#elif defined(PBL_PLATFORM_EMERY) || defined(PBL_PLATFORM_GABBRO)
+#define RENDER_BUDGET_MS 35
+#else
+#define RENDER_BUDGET_MS 25
+#endif
+
+#define RENDER_BUDGET_SHED_FRAMES 3      // Consecutive overruns before shedding
+// Restoring needs as many frames under half budget and at least this long,
+// so it is as quick as shedding at minute ticks and not faster at seconds
+#define RENDER_BUDGET_RESTORE_MS 30000
+
+typedef void (*RenderLevelHandler)(RenderLevel level);
+
+void render_budget_module_init(RenderLevelHandler handler);
+
+// Bracket a draw proc; begin also applies the anti-aliasing level to ctx
+void render_budget_begin(GContext *ctx);
+void render_budget_end(void);
+
+// Close the frame drawn since the last call (call once per tick, before flushing)
+void render_budget_frame(void);
+
+RenderLevel render_budget_get_level(void);
+
+// Push the current level to the phone (also used to answer a RENDER_LEVEL request)
+void render_budget_send_level(void);
@@ -0,0 +1,72 @@
+#include "render_graph_module.h"
+
+typedef struct {
+  Layer *layer;
+  RenderInputs inputs;
+} RenderNode;
+
+static RenderNode s_nodes[RENDER_GRAPH_MAX_LAYERS];
+static int s_node_count = 0;
+static RenderInputs s_pending = 0;
+
+// Last time fields seen by render_graph_tick (-1 forces a full first tick)
+static int s_last_second = -1;
+static int s_last_minute = -1;
+static int s_last_hour = -1;
+static int s_last_yday = -1;
+
+void render_graph_add(Layer *layer, RenderInputs inputs) {
+  if (!layer) return;
+
+  for (int i = 0; i < s_node_count; i++) {
+    if (s_nodes[i].layer == layer) {
+      s_nodes[i].inputs = inputs;
+      return;
+    }
+  }
+
+  if (s_node_count >= RENDER_GRAPH_MAX_LAYERS) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Render graph full, layer not tracked");
+    return;
+  }
+  s_nodes[s_node_count++] = (RenderNode) { .layer = layer, .inputs = inputs };
+}
+
+void render_graph_remove(Layer *layer) {
+  for (int i = 0; i < s_node_count; i++) {
+    if (s_nodes[i].layer == layer) {
+      s_nodes[i] = s_nodes[--s_node_count];
+      return;
+    }
+  }
+}
+
+void render_graph_invalidate(RenderInputs changed) {
+  s_pending |= changed;
+}
+
+RenderInputs render_graph_tick(struct tm *tick_time) {
+  if (tick_time) {
+    if (tick_time->tm_sec != s_last_second) s_pending |= RENDER_INPUT_SECOND;
+    if (tick_time->tm_min != s_last_minute) s_pending |= RENDER_INPUT_MINUTE;
+    if (tick_time->tm_hour != s_last_hour) s_pending |= RENDER_INPUT_HOUR;
+    if (tick_time->tm_yday != s_last_yday) s_pending |= RENDER_INPUT_DAY;
+
+    s_last_second = tick_time->tm_sec;
+    s_last_minute = tick_time->tm_min;
+    s_last_hour = tick_time->tm_hour;
+    s_last_yday = tick_time->tm_yday;
+  }
+  return s_pending;
+}
+
+void render_graph_flush(void) {
+  if (!s_pending) return;
+
+  for (int i = 0; i < s_node_count; i++) {
+    if (s_nodes[i].inputs & s_pending) {
+      layer_mark_dirty(s_nodes[i].layer);
+    }
+  }
+  s_pending = 0;
+}
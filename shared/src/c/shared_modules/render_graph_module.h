@@ -0,0 +1,42 @@
+#pragma once
+#include <pebble.h>
+
+// Render Graph Module - Layers declare their inputs, one dispatcher invalidates them
+//
+// Each registered layer lists the state it is drawn from. Events only report
+// which inputs changed; render_graph_flush() then marks dirty exactly the
+// layers that depend on them, and leaves every other layer alone.
+
+#define RENDER_GRAPH_MAX_LAYERS 12
+
+typedef enum {
+  RENDER_INPUT_SECOND     = 1 << 0,
+  RENDER_INPUT_MINUTE     = 1 << 1,
+  RENDER_INPUT_HOUR       = 1 << 2,
+  RENDER_INPUT_DAY        = 1 << 3,
+  RENDER_INPUT_STEPS      = 1 << 4,
+  RENDER_INPUT_WEATHER    = 1 << 5,
+  RENDER_INPUT_BATTERY    = 1 << 6,
+  RENDER_INPUT_SETTINGS   = 1 << 7,
+  RENDER_INPUT_VISIBILITY = 1 << 8,
+} RenderInput;
+
+#define RENDER_INPUT_ALL 0x1FF
+
+typedef uint16_t RenderInputs;
+
+// Register a layer (or update its inputs if already registered)
+void render_graph_add(Layer *layer, RenderInputs inputs);
+
+// Must be called before the layer is destroyed
+void render_graph_remove(Layer *layer);
+
+// Record changed inputs; nothing is invalidated until the next flush
+void render_graph_invalidate(RenderInputs changed);
+
+// Fold the time fields that changed since the last tick into the pending set
+// and return everything pending, so callers can skip work for unchanged inputs
+RenderInputs render_graph_tick(struct tm *tick_time);
+
+// Mark dirty only the layers whose inputs intersect the pending set, then clear it
+void render_graph_flush(void);
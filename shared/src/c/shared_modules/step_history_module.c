@@ -0,0 +1,164 @@
+#include "step_history_module.h"
+
+#define STEP_HISTORY_VERSION 2
+
+typedef struct {
+  uint8_t version;
+  time_t read_until;                     // Minute data has been read up to here
+  time_t day_start;                      // Local midnight the slots count from
+  uint16_t steps[STEP_HISTORY_HOURS];    // Slot = hours since day_start
+} StepHistoryStore;
+
+static StepHistoryStore s_store;
+static uint32_t s_revision = 0;
+static time_t s_last_read = 0;
+static time_t s_saved_at = 0;
+
+// ============================================================================
+// SLOTS
+// ============================================================================
+
+// Hours since local midnight, so half-hour zones still split at the hour;
+// the extra hour of a DST day folds into the last slot
+static int slot_of(time_t when) {
+  int slot = (int)((when - s_store.day_start) / SECONDS_PER_HOUR);
+  return slot < STEP_HISTORY_HOURS ? slot : STEP_HISTORY_HOURS - 1;
+}
+
+// Clear the slots when a new day starts
+static void start_day(time_t day_start) {
+  if (day_start == s_store.day_start) return;
+  memset(s_store.steps, 0, sizeof(s_store.steps));
+  s_store.day_start = day_start;
+  s_revision++;
+}
+
+#if defined(PBL_HEALTH)
+static void add_steps(time_t when, int steps) {
+  if (steps <= 0 || when < s_store.day_start) return;
+  uint16_t *slot = &s_store.steps[slot_of(when)];
+  *slot = (*slot + steps > UINT16_MAX) ? UINT16_MAX : *slot + steps;
+  s_revision++;
+}
+#endif
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+static void save_store(void) {
+  persist_write_data(STEP_HISTORY_PERSIST_KEY, &s_store, sizeof(s_store));
+  s_saved_at = time(NULL);
+}
+
+static void load_store(void) {
+  memset(&s_store, 0, sizeof(s_store));
+  if (persist_exists(STEP_HISTORY_PERSIST_KEY) &&
+      persist_read_data(STEP_HISTORY_PERSIST_KEY, &s_store, sizeof(s_store)) == (int)sizeof(s_store) &&
+      s_store.version == STEP_HISTORY_VERSION && s_store.read_until <= time(NULL)) {
+    return;
+  }
+  // Missing, stale format or from the future after a clock change: start over
+  memset(&s_store, 0, sizeof(s_store));
+  s_store.version = STEP_HISTORY_VERSION;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void step_history_module_init(void) {
+  load_store();
+  s_last_read = 0;
+  s_saved_at = time(NULL);
+  s_revision++;
+}
+
+bool step_history_module_update(void) {
+#if defined(PBL_HEALTH)
+  time_t now = time(NULL);
+  time_t start = s_store.read_until;
+  // Nothing older than midnight is worth reading
+  time_t today = time_start_of_today();
+  start_day(today);
+  if (start < today) start = today;
+
+  bool caught_up = now - start < STEP_HISTORY_BATCH_MINUTES * SECONDS_PER_MINUTE;
+  if (caught_up && now - s_last_read < STEP_HISTORY_REFRESH_S) return false;
+  s_last_read = now;
+
+  HealthMinuteData *records = malloc(STEP_HISTORY_BATCH_MINUTES * sizeof(HealthMinuteData));
+  if (!records) return false;
+
+  bool more = false;
+  for (int batch = 0; start < now; batch++) {
+    if (batch == STEP_HISTORY_MAX_BATCHES) {
+      more = true;
+      break;
+    }
+    time_t batch_start = start;
+    time_t requested_end = start + STEP_HISTORY_BATCH_MINUTES * SECONDS_PER_MINUTE;
+    if (requested_end > now) requested_end = now;
+    time_t batch_end = requested_end;
+    // Both ends come back moved to the records actually returned
+    uint32_t count = health_service_get_minute_history(records, STEP_HISTORY_BATCH_MINUTES,
+                                                       &batch_start, &batch_end);
+    if (count == 0) {
+      // Recent minutes may not be filed yet; an older empty window is a gap
+      if (now - requested_end < STEP_HISTORY_REFRESH_S) break;
+      start = requested_end;
+      s_store.read_until = requested_end;
+      continue;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+      if (!records[i].is_invalid) {
+        add_steps(batch_start + (time_t)i * SECONDS_PER_MINUTE, records[i].steps);
+      }
+    }
+    start = batch_end;
+    s_store.read_until = batch_end;
+  }
+  free(records);
+
+  if (now - s_saved_at >= STEP_HISTORY_SAVE_S) {
+    save_store();
+  }
+  return more;
+#else
+  return false;
+#endif
+}
+
+uint32_t step_history_module_get_revision(void) {
+  return s_revision;
+}
+
+void step_history_module_draw(GContext *ctx, GRect frame, GColor color) {
+  time_t now = time(NULL);
+  if (now < s_store.day_start || frame.size.w < STEP_HISTORY_HOURS) return;
+  // Slots from an earlier day are cleared on the next update; show none until then
+  int last = (s_store.day_start == time_start_of_today()) ? slot_of(now) : -1;
+
+  int busiest = 0;
+  for (int h = 0; h <= last; h++) {
+    if (s_store.steps[h] > busiest) busiest = s_store.steps[h];
+  }
+
+  // One bar per hour of the day, so the empty right side is the rest of it
+  int slot_w = frame.size.w / STEP_HISTORY_HOURS;
+  int left = frame.origin.x + (frame.size.w - slot_w * STEP_HISTORY_HOURS) / 2;
+  int baseline = frame.origin.y + frame.size.h;
+  graphics_context_set_fill_color(ctx, color);
+  graphics_fill_rect(ctx, GRect(left, baseline - 1, slot_w * STEP_HISTORY_HOURS, 1), 0, GCornerNone);
+  if (busiest == 0) return;
+  for (int h = 0; h <= last; h++) {
+    int height = s_store.steps[h] * (frame.size.h - 1) / busiest;
+    if (s_store.steps[h] > 0 && height < 1) height = 1;
+    int x = left + h * slot_w;
+    graphics_fill_rect(ctx, GRect(x, baseline - 1 - height, slot_w > 1 ? slot_w - 1 : 1, height), 0, GCornerNone);
+  }
+}
+
+void step_history_module_deinit(void) {
+  save_store();
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <pebble.h>
+
+// Step History Module - Today's steps per hour, read incrementally
+//
+// Today's hourly step totals live in slots counted from local midnight,
+// persisted together with the time minute data has been read up to. The first run reads from midnight with
+// health_service_get_minute_history in batches of STEP_HISTORY_BATCH_MINUTES
+// records; later launches and ticks only read the minutes since then, and
+// no more often than STEP_HISTORY_REFRESH_S. Empty windows older than that
+// are gaps in the history and are skipped.
+
+#define STEP_HISTORY_HOURS 24
+#define STEP_HISTORY_BATCH_MINUTES 60      // Records per minute-history read
+#define STEP_HISTORY_MAX_BATCHES 4         // Reads per update; the rest waits for the next one
+#define STEP_HISTORY_REFRESH_S (15 * 60)   // The firmware files minute data in chunks anyway
+#define STEP_HISTORY_SAVE_S (60 * 60)      // Persist at most hourly (and at deinit)
+#define STEP_HISTORY_PERSIST_KEY 2         // Kept clear of the MESSAGE_KEY_* range
+
+// Restores the persisted hours
+void step_history_module_init(void);
+
+// Reads the minutes since the last read; returns true when more are waiting
+bool step_history_module_update(void);
+
+// Changes whenever an hour's total does (for redraw decisions)
+uint32_t step_history_module_get_revision(void);
+
+// Today's hours as a bar per hour, scaled to the busiest one
+void step_history_module_draw(GContext *ctx, GRect frame, GColor color);
+
+// Persists the hours read so far
+void step_history_module_deinit(void);
@@ -0,0 +1,162 @@
+#include "time_display_module.h"
+#include "render_graph_module.h"
+
+#define BADGE_COUNT 4     // AM active, AM inactive, PM active, PM inactive
+
+static GFont s_font = NULL;
+static GRect s_time_frame;
+static GRect s_ampm_frame;
+static bool s_hidden = false;
+static char s_time_buffer[8];
+
+#if !RENDER_IMMEDIATE
+static TextLayer *s_time_layer = NULL;
+static Layer *s_ampm_layer = NULL;
+#endif
+
+// Sub-bitmaps share the atlas pixels, only the headers are allocated
+static GBitmap *s_atlas = NULL;
+static GBitmap *s_badges[BADGE_COUNT];
+static bool s_is_pm = false;
+
+// ============================================================================
+// DRAWING
+// ============================================================================
+
+static void draw_badge(GContext *ctx, GBitmap *badge, GRect rect) {
+  if (!badge) return;
+  graphics_draw_bitmap_in_rect(ctx, badge,
+      GRect(rect.origin.x + (rect.size.w - TIME_BADGE_WIDTH) / 2,
+            rect.origin.y + (rect.size.h - TIME_BADGE_HEIGHT) / 2,
+            TIME_BADGE_WIDTH, TIME_BADGE_HEIGHT));
+}
+
+static void draw_ampm(GContext *ctx, GRect frame) {
+  int section_height = (frame.size.h - 2) / 2;
+
+  draw_badge(ctx, s_badges[s_is_pm ? 1 : 0],
+             GRect(frame.origin.x, frame.origin.y, frame.size.w, section_height));
+  draw_badge(ctx, s_badges[s_is_pm ? 2 : 3],
+             GRect(frame.origin.x, frame.origin.y + section_height + 2, frame.size.w, section_height));
+}
+
+#if RENDER_IMMEDIATE
+void time_display_module_draw(GContext *ctx, GRect bounds) {
+  if (!s_font || s_hidden) return;
+
+  graphics_context_set_text_color(ctx, GColorWhite);
+  graphics_draw_text(ctx, s_time_buffer, s_font, s_time_frame,
+                     GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+  if (s_ampm_frame.size.w > 0) {
+    draw_ampm(ctx, s_ampm_frame);
+  }
+}
+#else
+static void ampm_update_proc(Layer *layer, GContext *ctx) {
+  draw_ampm(ctx, layer_get_bounds(layer));
+}
+#endif
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void time_display_module_init(Window *window, GRect time_frame, GRect ampm_frame,
+                              GFont font, uint32_t badge_res) {
+  s_font = font;
+  s_time_frame = time_frame;
+  s_ampm_frame = ampm_frame;
+  s_hidden = false;
+  s_time_buffer[0] = '\0';
+  if (!s_font) return;
+
+  // The badge atlas is only needed in 12h mode
+  if (ampm_frame.size.w > 0) {
+    s_atlas = gbitmap_create_with_resource(badge_res);
+    for (int i = 0; s_atlas && i < BADGE_COUNT; i++) {
+      s_badges[i] = gbitmap_create_as_sub_bitmap(s_atlas,
+          GRect(i * TIME_BADGE_WIDTH, 0, TIME_BADGE_WIDTH, TIME_BADGE_HEIGHT));
+    }
+  }
+
+#if !RENDER_IMMEDIATE
+  Layer *window_layer = window_get_root_layer(window);
+
+  s_time_layer = text_layer_create(time_frame);
+  if (s_time_layer) {
+    text_layer_set_background_color(s_time_layer, GColorClear);
+    text_layer_set_text_color(s_time_layer, GColorWhite);
+    text_layer_set_font(s_time_layer, s_font);
+    text_layer_set_text_alignment(s_time_layer, GTextAlignmentCenter);
+    layer_add_child(window_layer, text_layer_get_layer(s_time_layer));
+    // New text dirties the layer itself; the graph only covers show/hide
+    render_graph_add(text_layer_get_layer(s_time_layer), RENDER_INPUT_VISIBILITY);
+  }
+
+  if (ampm_frame.size.w > 0) {
+    s_ampm_layer = layer_create(ampm_frame);
+    if (s_ampm_layer) {
+      layer_set_update_proc(s_ampm_layer, ampm_update_proc);
+      layer_add_child(window_layer, s_ampm_layer);
+      render_graph_add(s_ampm_layer, RENDER_INPUT_HOUR | RENDER_INPUT_VISIBILITY);
+    }
+  }
+#endif
+}
+
+void time_display_module_update(struct tm *tick_time, bool use_24h) {
+  if (!s_font || !tick_time) return;
+
+  int hour = tick_time->tm_hour;
+  if (!use_24h) {
+    hour = hour % 12;
+    if (hour == 0) hour = 12;
+  }
+
+  // Second ticks land here too; only a new minute sets the text
+  char buffer[sizeof(s_time_buffer)];
+  snprintf(buffer, sizeof(buffer), "%02d:%02d", hour, tick_time->tm_min);
+  if (strcmp(buffer, s_time_buffer) != 0) {
+    memcpy(s_time_buffer, buffer, sizeof(s_time_buffer));
+#if !RENDER_IMMEDIATE
+    if (s_time_layer) text_layer_set_text(s_time_layer, s_time_buffer);
+#endif
+  }
+  s_is_pm = (tick_time->tm_hour >= 12);
+}
+
+void time_display_module_set_hidden(bool hidden) {
+  s_hidden = hidden;
+#if !RENDER_IMMEDIATE
+  if (s_time_layer) layer_set_hidden(text_layer_get_layer(s_time_layer), hidden);
+  if (s_ampm_layer) layer_set_hidden(s_ampm_layer, hidden);
+#endif
+}
+
+void time_display_module_deinit(void) {
+#if !RENDER_IMMEDIATE
+  if (s_time_layer) {
+    render_graph_remove(text_layer_get_layer(s_time_layer));
+    text_layer_destroy(s_time_layer);
+    s_time_layer = NULL;
+  }
+  if (s_ampm_layer) {
+    render_graph_remove(s_ampm_layer);
+    layer_destroy(s_ampm_layer);
+    s_ampm_layer = NULL;
+  }
+#endif
+
+  // Sub-bitmaps must go before the atlas they point into
+  for (int i = 0; i < BADGE_COUNT; i++) {
+    if (s_badges[i]) {
+      gbitmap_destroy(s_badges[i]);
+      s_badges[i] = NULL;
+    }
+  }
+  if (s_atlas) {
+    gbitmap_destroy(s_atlas);
+    s_atlas = NULL;
+  }
+  s_font = NULL;
+}
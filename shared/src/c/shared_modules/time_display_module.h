@@ -0,0 +1,25 @@
+#pragma once
+#include <pebble.h>
+#include "../utilities/render_mode.h"
+
+// Time Display Module - Time text layer, AM/PM blitted from a badge atlas
+//
+// The time is one text layer in the given LECO font, set only when the
+// minute changes. Badge atlas layout (tools/glyph_atlas.py): AM active,
+// AM inactive, PM active, PM inactive in equal 14x8 cells.
+
+#define TIME_BADGE_WIDTH 14
+#define TIME_BADGE_HEIGHT 8
+
+// Digits are centred in time_frame; pass GRectZero as ampm_frame in 24h mode
+void time_display_module_init(Window *window, GRect time_frame, GRect ampm_frame,
+                              GFont font, uint32_t badge_res);
+
+// Sets the text on a new minute; AM/PM follows the hour input
+void time_display_module_update(struct tm *tick_time, bool use_24h);
+
+void time_display_module_set_hidden(bool hidden);
+void time_display_module_deinit(void);
+
+// Immediate mode: draws digits and badges at the frames passed to init
+void time_display_module_draw(GContext *ctx, GRect bounds);
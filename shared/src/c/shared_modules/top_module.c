@@ -1,15 +1,49 @@
 #include "top_module.h"
+#include "face_renderer_module.h"
+#include "step_history_module.h"
 
-static TextLayer *s_day_layer = NULL;
-static BitmapLayer *s_walk_icon_layer = NULL;
 static GBitmap *s_walk_icon_bitmap = NULL;
 static DateFormatType s_current_format = DATE_FORMAT_WEEKDAY;
+static GRect s_text_frame;
+static GRect s_icon_frame;
+static GRect s_history_frame;
+static char s_buffer[20];
+static bool s_show_icon = false;
+static uint32_t s_history_revision = 0;
+static bool s_active = false;
+
+#if RENDER_IMMEDIATE
+static GFont s_font;
+#else
+static TextLayer *s_day_layer = NULL;
+static BitmapLayer *s_walk_icon_layer = NULL;
+static Layer *s_history_layer = NULL;
+#endif
+
+#if !RENDER_IMMEDIATE
+static void history_update_proc(Layer *layer, GContext *ctx) {
+  step_history_module_draw(ctx, layer_get_bounds(layer), GColorWhite);
+}
+#endif
 
 void top_module_init(Window *window, GRect bounds, int text_y_offset, uint32_t walk_icon_res, int icon_y_offset) {
+  s_text_frame = GRect(0, bounds.size.h / 2 + text_y_offset, bounds.size.w, 24);
+  // The sparkline sits where the text would, a bar per hour
+  s_history_frame = GRect(bounds.size.w / 2 - 48, s_text_frame.origin.y + 6, 96, 14);
+  s_icon_frame = GRect(bounds.size.w / 2 + 20, bounds.size.h / 2 + icon_y_offset, 15, 15);
+  s_walk_icon_bitmap = gbitmap_create_with_resource(walk_icon_res);
+  s_buffer[0] = '\0';
+  s_show_icon = false;
+  s_history_revision = 0;
+  s_active = true;
+
+#if RENDER_IMMEDIATE
+  s_font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+#else
   Layer *window_layer = window_get_root_layer(window);
   
   // Create text layer
-  s_day_layer = text_layer_create(GRect(0, bounds.size.h / 2 + text_y_offset, bounds.size.w, 24));
+  s_day_layer = text_layer_create(s_text_frame);
   if (s_day_layer) {
     text_layer_set_background_color(s_day_layer, GColorClear);
     text_layer_set_text_color(s_day_layer, GColorWhite);
@@ -19,33 +53,74 @@ void top_module_init(Window *window, GRect bounds, int text_y_offset, uint32_t w
   }
   
   // Create walking icon layer (initially hidden)
-  s_walk_icon_bitmap = gbitmap_create_with_resource(walk_icon_res);
-  s_walk_icon_layer = bitmap_layer_create(GRect(bounds.size.w / 2 + 20, bounds.size.h / 2 + icon_y_offset, 15, 15));
+  s_walk_icon_layer = bitmap_layer_create(s_icon_frame);
   if (s_walk_icon_layer) {
     bitmap_layer_set_bitmap(s_walk_icon_layer, s_walk_icon_bitmap);
     bitmap_layer_set_compositing_mode(s_walk_icon_layer, GCompOpSet);
     layer_set_hidden(bitmap_layer_get_layer(s_walk_icon_layer), true);
     layer_add_child(window_layer, bitmap_layer_get_layer(s_walk_icon_layer));
   }
+
+  // Step history sparkline (hidden unless that format is chosen)
+  s_history_layer = layer_create(s_history_frame);
+  if (s_history_layer) {
+    layer_set_update_proc(s_history_layer, history_update_proc);
+    layer_set_hidden(s_history_layer, true);
+    layer_add_child(window_layer, s_history_layer);
+  }
+#endif
 }
 
-void top_module_update(struct tm *tick_time, DateFormatType format, int step_count, int distance_walked, bool use_miles, int heart_rate) {
-  if (!s_day_layer) return;
+bool top_module_update(struct tm *tick_time, DateFormatType format, int step_count, int distance_walked, bool use_miles, int heart_rate) {
+  if (!s_active) return false;
   
-  static char buffer[20];
+  char buffer[sizeof(s_buffer)];
   format_date_string(buffer, sizeof(buffer), tick_time, format, step_count, distance_walked, use_miles, heart_rate);
-  text_layer_set_text(s_day_layer, buffer);
   
   // Show walking icon for step count or distance format
   bool show_icon = (format == DATE_FORMAT_STEP_COUNT || format == DATE_FORMAT_DISTANCE);
+  uint32_t history_revision = (format == DATE_FORMAT_STEP_HISTORY) ? step_history_module_get_revision() : 0;
+  bool history_changed = (history_revision != s_history_revision);
+  s_current_format = format;
+  if (show_icon == s_show_icon && !history_changed && strcmp(buffer, s_buffer) == 0) return false;
+  
+  strncpy(s_buffer, buffer, sizeof(s_buffer));
+  s_show_icon = show_icon;
+  s_history_revision = history_revision;
+  
+#if !RENDER_IMMEDIATE
+  if (s_history_layer) {
+    layer_set_hidden(s_history_layer, format != DATE_FORMAT_STEP_HISTORY);
+    if (history_changed) layer_mark_dirty(s_history_layer);
+  }
+  text_layer_set_text(s_day_layer, s_buffer);
   if (s_walk_icon_layer) {
-    layer_set_hidden(bitmap_layer_get_layer(s_walk_icon_layer), !show_icon);
+    layer_set_hidden(bitmap_layer_get_layer(s_walk_icon_layer), !s_show_icon);
   }
+#endif
+  return true;
+}
+
+#if RENDER_IMMEDIATE
+void top_module_draw(GContext *ctx, GRect bounds) {
+  if (!s_active) return;
   
-  s_current_format = format;
+  graphics_context_set_text_color(ctx, GColorWhite);
+  graphics_draw_text(ctx, s_buffer, s_font, s_text_frame,
+                     GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+  if (s_current_format == DATE_FORMAT_STEP_HISTORY) {
+    step_history_module_draw(ctx, s_history_frame, GColorWhite);
+  }
+  if (s_show_icon) {
+    face_renderer_draw_bitmap(ctx, s_walk_icon_bitmap, s_icon_frame);
+  }
 }
+#endif
 
 void top_module_deinit(void) {
+  s_active = false;
+  
+#if !RENDER_IMMEDIATE
   if (s_day_layer) {
     text_layer_destroy(s_day_layer);
     s_day_layer = NULL;
@@ -55,6 +130,12 @@ void top_module_deinit(void) {
     bitmap_layer_destroy(s_walk_icon_layer);
     s_walk_icon_layer = NULL;
   }
+
+  if (s_history_layer) {
+    layer_destroy(s_history_layer);
+    s_history_layer = NULL;
+  }
+#endif
   
   if (s_walk_icon_bitmap) {
     gbitmap_destroy(s_walk_icon_bitmap);
@@ -1,9 +1,14 @@
 #pragma once
 #include <pebble.h>
 #include "../utilities/date_format.h"
+#include "../utilities/render_mode.h"
 
 // Top Module - Configurable Date Display
 
 void top_module_init(Window *window, GRect bounds, int text_y_offset, uint32_t walk_icon_res, int icon_y_offset);
-void top_module_update(struct tm *tick_time, DateFormatType format, int step_count, int distance_walked, bool use_miles, int heart_rate);
+// Returns true when the text, icon or step history changed (unchanged text leaves the layers clean)
+bool top_module_update(struct tm *tick_time, DateFormatType format, int step_count, int distance_walked, bool use_miles, int heart_rate);
 void top_module_deinit(void);
+
+// Immediate mode: draws text, icon or sparkline from the frames computed in init
+void top_module_draw(GContext *ctx, GRect bounds);
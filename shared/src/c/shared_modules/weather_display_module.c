@@ -1,12 +1,15 @@
 #include "weather_display_module.h"
 #include "../utilities/weather.h"
 #include "../utilities/date_format.h"
+#include "face_renderer_module.h"
 
 #define WEATHER_ICON_SIZE 15
 
-static TextLayer *s_weather_layer = NULL;
-static BitmapLayer *s_icon_layer = NULL;
 static GBitmap *s_icon_bitmap = NULL;
+static GRect s_text_frame;
+static GRect s_icon_frame;
+static bool s_active = false;
+static bool s_show_icon = false;
 static char s_weather_buffer[12];
 static int s_center_y;
 static int s_center_x;
@@ -17,14 +20,29 @@ static int s_cached_day = -1;
 static int s_sunrise_min = -1;
 static int s_sunset_min = -1;
 
-void weather_display_module_init(Window *window, GRect bounds, int weather_y_offset) {
-  Layer *window_layer = window_get_root_layer(window);
+#if RENDER_IMMEDIATE
+static GFont s_font;
+#else
+static TextLayer *s_weather_layer = NULL;
+static BitmapLayer *s_icon_layer = NULL;
+#endif
 
+void weather_display_module_init(Window *window, GRect bounds, int weather_y_offset) {
   s_center_x = bounds.size.w / 2;
   s_center_y = bounds.size.h / 2 + weather_y_offset;
+  s_text_frame = GRect(0, s_center_y, s_center_x, 24);
+  s_icon_frame = GRect(s_center_x + (WEATHER_ICON_SIZE /2) , s_center_y + 6, WEATHER_ICON_SIZE, WEATHER_ICON_SIZE);
+  s_weather_buffer[0] = '\0';
+  s_show_icon = false;
+  s_active = true;
+
+#if RENDER_IMMEDIATE
+  s_font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+#else
+  Layer *window_layer = window_get_root_layer(window);
 
   // Temperature text — right of center, leaves room for icon on the left
-  s_weather_layer = text_layer_create(GRect(0, s_center_y, s_center_x, 24));
+  s_weather_layer = text_layer_create(s_text_frame);
   if (s_weather_layer) {
     text_layer_set_background_color(s_weather_layer, GColorClear);
     text_layer_set_text_color(s_weather_layer, GColorWhite);
@@ -34,24 +52,30 @@ void weather_display_module_init(Window *window, GRect bounds, int weather_y_off
   }
 
   // Weather icon — left of center
-  s_icon_layer = bitmap_layer_create(GRect(s_center_x + (WEATHER_ICON_SIZE /2) , s_center_y + 6, WEATHER_ICON_SIZE, WEATHER_ICON_SIZE));
+  s_icon_layer = bitmap_layer_create(s_icon_frame);
   if (s_icon_layer) {
     bitmap_layer_set_compositing_mode(s_icon_layer, GCompOpSet);
     bitmap_layer_set_background_color(s_icon_layer, GColorClear);
     layer_set_hidden(bitmap_layer_get_layer(s_icon_layer), true);
     layer_add_child(window_layer, bitmap_layer_get_layer(s_icon_layer));
   }
+#endif
 }
 
 void weather_display_module_update(void) {
-  if (!s_weather_layer) return;
+  if (!s_active) return;
 
   if (!s_visible) return;
 
   WeatherData *weather = weather_module_get_data();
   if (!weather || !weather->is_valid) {
-    text_layer_set_text(s_weather_layer, "");
+    if (s_last_temp == INT16_MIN && s_last_res_id == 0) return;  // Already cleared
+    s_weather_buffer[0] = '\0';
+    s_show_icon = false;
+#if !RENDER_IMMEDIATE
+    text_layer_set_text(s_weather_layer, s_weather_buffer);
     if (s_icon_layer) layer_set_hidden(bitmap_layer_get_layer(s_icon_layer), true);
+#endif
     s_last_res_id = 0;
     s_last_temp = INT16_MIN;
     return;
@@ -62,7 +86,9 @@ void weather_display_module_update(void) {
   if (temp != s_last_temp) {
     s_last_temp = temp;
     snprintf(s_weather_buffer, sizeof(s_weather_buffer), "%d°", temp);
+#if !RENDER_IMMEDIATE
     text_layer_set_text(s_weather_layer, s_weather_buffer);
+#endif
   }
 
   bool is_night = false;
@@ -94,24 +120,45 @@ void weather_display_module_update(void) {
       s_icon_bitmap = NULL;
     }
     s_icon_bitmap = gbitmap_create_with_resource(res_id);
+    s_show_icon = (s_icon_bitmap != NULL);
+#if !RENDER_IMMEDIATE
     if (s_icon_bitmap && s_icon_layer) {
       bitmap_layer_set_bitmap(s_icon_layer, s_icon_bitmap);
       layer_set_hidden(bitmap_layer_get_layer(s_icon_layer), false);
     }
+#endif
   }
 }
 
+#if RENDER_IMMEDIATE
+void weather_display_module_draw(GContext *ctx, GRect bounds) {
+  if (!s_active || !s_visible) return;
+
+  graphics_context_set_text_color(ctx, GColorWhite);
+  graphics_draw_text(ctx, s_weather_buffer, s_font, s_text_frame,
+                     GTextOverflowModeWordWrap, GTextAlignmentRight, NULL);
+  if (s_show_icon) {
+    face_renderer_draw_bitmap(ctx, s_icon_bitmap, s_icon_frame);
+  }
+}
+#endif
+
 void weather_display_module_set_visible(bool visible) {
   s_visible = visible;
+#if !RENDER_IMMEDIATE
   if (s_weather_layer) {
     layer_set_hidden(text_layer_get_layer(s_weather_layer), !visible);
   }
   if (s_icon_layer) {
     layer_set_hidden(bitmap_layer_get_layer(s_icon_layer), !visible);
   }
+#endif
 }
 
 void weather_display_module_deinit(void) {
+  s_active = false;
+
+#if !RENDER_IMMEDIATE
   if (s_weather_layer) {
     text_layer_destroy(s_weather_layer);
     s_weather_layer = NULL;
@@ -120,6 +167,7 @@ void weather_display_module_deinit(void) {
     bitmap_layer_destroy(s_icon_layer);
     s_icon_layer = NULL;
   }
+#endif
   if (s_icon_bitmap) {
     gbitmap_destroy(s_icon_bitmap);
     s_icon_bitmap = NULL;
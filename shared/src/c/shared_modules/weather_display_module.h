@@ -1,7 +1,11 @@
 #pragma once
 #include <pebble.h>
+#include "../utilities/render_mode.h"
 
 void weather_display_module_init(Window *window, GRect bounds, int weather_y_offset);
 void weather_display_module_update(void);
 void weather_display_module_set_visible(bool visible);
 void weather_display_module_deinit(void);
+
+// Immediate mode: draws temperature and icon from the frames computed in init
+void weather_display_module_draw(GContext *ctx, GRect bounds);
@@ -0,0 +1,48 @@
+#include "weather_sync_module.h"
+#include "message_outbox_module.h"
+#include "../utilities/weather.h"
+
+static bool s_enabled = true;
+static time_t s_last_request = 0;
+static int s_stale_age = WEATHER_STALE_AGE_S;
+
+static void app_connection_handler(bool connected) {
+  if (connected) {
+    // Reconnecting is the earliest moment stale data can be replaced
+    s_last_request = 0;
+    weather_sync_module_check();
+  }
+}
+
+void weather_sync_module_set_enabled(bool enabled) {
+  s_enabled = enabled;
+}
+
+void weather_sync_module_set_stale_age(int seconds) {
+  s_stale_age = seconds > 0 ? seconds : WEATHER_STALE_AGE_S;
+}
+
+void weather_sync_module_check(void) {
+  if (!s_enabled) return;
+
+  time_t now = time(NULL);
+  if (weather_module_get_age(now) < s_stale_age) return;
+  if (now - s_last_request < WEATHER_REQUEST_RETRY_S) return;
+  if (!connection_service_peek_pebble_app_connection()) return;
+
+  // The outbox retries a failed send; the spacing covers a dropped one
+  message_outbox_send_uint8(MESSAGE_KEY_REQUEST_WEATHER, 1);
+  s_last_request = now;
+}
+
+void weather_sync_module_subscribe(void) {
+  // pkjs fetches on its own ready event, so give it a retry window before pulling
+  s_last_request = time(NULL);
+  connection_service_subscribe((ConnectionHandlers) {
+    .pebble_app_connection_handler = app_connection_handler,
+  });
+}
+
+void weather_sync_module_unsubscribe(void) {
+  connection_service_unsubscribe();
+}
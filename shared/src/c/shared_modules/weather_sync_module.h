@@ -0,0 +1,19 @@
+#pragma once
+#include <pebble.h>
+
+// Weather Sync Module - Watch-driven weather refresh requests
+
+#define WEATHER_STALE_AGE_S (60 * 60)     // Data older than this gets refreshed
+#define WEATHER_REQUEST_RETRY_S (5 * 60)  // Minimum spacing between requests
+
+// Enable/disable requests (off when neither weather nor moon view is shown)
+void weather_sync_module_set_enabled(bool enabled);
+
+// Age at which data counts as stale (the power governor stretches it)
+void weather_sync_module_set_stale_age(int seconds);
+
+// Request fresh weather if the data is stale and the phone is connected
+void weather_sync_module_check(void);
+
+void weather_sync_module_subscribe(void);
+void weather_sync_module_unsubscribe(void);
@@ -0,0 +1,107 @@
+#include "work_queue_module.h"
+#include "render_graph_module.h"
+
+typedef struct {
+  WorkCallback callback;
+  WorkPriority priority;
+  uint32_t order;
+} WorkJob;
+
+static WorkJob s_jobs[WORK_QUEUE_SIZE];
+static int s_count = 0;
+static uint32_t s_next_order = 0;
+static AppTimer *s_timer = NULL;
+
+static void schedule(uint32_t delay_ms);
+
+// Highest priority, then oldest, among the jobs posted before `before`
+static int next_job(uint32_t before) {
+  int best = -1;
+  for (int i = 0; i < s_count; i++) {
+    if (s_jobs[i].order >= before) continue;
+    if (best < 0 || s_jobs[i].priority < s_jobs[best].priority ||
+        (s_jobs[i].priority == s_jobs[best].priority && s_jobs[i].order < s_jobs[best].order)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+// Removed before it runs, so a job may post itself again
+static void run_job(int index) {
+  WorkCallback callback = s_jobs[index].callback;
+  s_jobs[index] = s_jobs[--s_count];
+  callback();
+}
+
+static uint32_t now_ms(void) {
+  time_t seconds;
+  uint16_t millis;
+  time_ms(&seconds, &millis);
+  return (uint32_t)seconds * 1000 + millis;
+}
+
+static void slot_callback(void *data) {
+  s_timer = NULL;
+  // At least one job per slot, more while the slot budget lasts
+  uint32_t start = now_ms();
+  int index;
+  while ((index = next_job(UINT32_MAX)) >= 0) {
+    run_job(index);
+    if (now_ms() - start >= WORK_QUEUE_SLOT_BUDGET_MS) break;
+  }
+  if (s_count > 0) {
+    schedule(WORK_QUEUE_SPACING_MS);
+  } else {
+    render_graph_flush();
+  }
+}
+
+static void schedule(uint32_t delay_ms) {
+  if (!s_timer) {
+    s_timer = app_timer_register(delay_ms, slot_callback, NULL);
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void work_queue_post(WorkCallback callback, WorkPriority priority) {
+  if (!callback) return;
+  for (int i = 0; i < s_count; i++) {
+    if (s_jobs[i].callback == callback) {
+      if (priority < s_jobs[i].priority) s_jobs[i].priority = priority;
+      return;
+    }
+  }
+  if (s_count == WORK_QUEUE_SIZE) {
+    callback();
+    return;
+  }
+  s_jobs[s_count++] = (WorkJob){ callback, priority, s_next_order++ };
+  schedule(WORK_QUEUE_FIRST_DELAY_MS);
+}
+
+void work_queue_drain(void) {
+  if (s_count == 0) return;
+  // Jobs posted meanwhile (a backlog continuing itself) keep their slot
+  uint32_t posted_before = s_next_order;
+  int index;
+  while ((index = next_job(posted_before)) >= 0) {
+    run_job(index);
+  }
+  if (s_count == 0 && s_timer) {
+    app_timer_cancel(s_timer);
+    s_timer = NULL;
+  }
+  render_graph_flush();
+}
+
+void work_queue_module_deinit(void) {
+  if (s_timer) {
+    app_timer_cancel(s_timer);
+    s_timer = NULL;
+  }
+  s_count = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <pebble.h>
+
+// Work Queue Module - Deferred jobs run on app_timer slots after the frame
+//
+// Handlers do the visible part of their work inline and post the rest here.
+// The first slot fires once the current event (and the frame it dirtied) is
+// done. Jobs run highest priority first, in posting order within a priority;
+// a slot keeps going until WORK_QUEUE_SLOT_BUDGET_MS is spent, so the usual
+// handful of cheap jobs costs one wakeup and a heavy burst is spread over
+// several event-loop passes.
+// Posting a job that is already queued coalesces it into the queued one.
+// Whatever the jobs invalidate is flushed to the render graph as one frame
+// once the queue runs dry.
+
+typedef enum {
+  WORK_PRIORITY_HIGH = 0,   // Visible data the next frame should show (steps, text)
+  WORK_PRIORITY_NORMAL,     // Re-derived display state (weather icon, bitmaps)
+  WORK_PRIORITY_LOW,        // Housekeeping (persist flushes, sync requests)
+} WorkPriority;
+
+#define WORK_QUEUE_SIZE 8
+#define WORK_QUEUE_FIRST_DELAY_MS 20   // Lets the frame in flight commit first
+#define WORK_QUEUE_SLOT_BUDGET_MS 10   // Jobs started per slot until this is spent
+#define WORK_QUEUE_SPACING_MS 40       // Between the slots of one burst
+
+typedef void (*WorkCallback)(void);
+
+// Queue a job; a queued job with the same callback keeps its place and takes
+// the higher of the two priorities. Runs inline if the queue is full.
+void work_queue_post(WorkCallback callback, WorkPriority priority);
+
+// Run every queued job now (first frame, exit); jobs they post wait for a slot
+void work_queue_drain(void);
+
+// Drop queued jobs and the pending slot
+void work_queue_module_deinit(void);
@@ -2,70 +2,215 @@
 #include <string.h>
 #include <stdio.h>
 
-static void to_uppercase(char *str) {
-  if (!str) return;
-  
-  while (*str) {
-    if (*str >= 'a' && *str <= 'z') {
-      *str = *str - 'a' + 'A';
+// ============================================================================
+// NAME TABLES
+// ============================================================================
+
+// Names come pre-uppercased, packed one after another with '\0' between them
+// (Sunday and January first). Languages the system fonts cannot show keep
+// the English table.
+typedef struct {
+  char code[3];                 // Language part of the locale ("fr" of "fr_FR")
+  const char *weekdays;
+  const char *weekdays_short;
+  const char *months;
+  const char *months_short;
+  const char *day_month;        // NULL: "DECEMBER 29", else "29<day_month>DÉCEMBRE"
+} DateLanguage;
+
+static const DateLanguage LANGUAGES[] = {
+  { "en",
+    "SUNDAY\0MONDAY\0TUESDAY\0WEDNESDAY\0THURSDAY\0FRIDAY\0SATURDAY",
+    "SUN\0MON\0TUE\0WED\0THU\0FRI\0SAT",
+    "JANUARY\0FEBRUARY\0MARCH\0APRIL\0MAY\0JUNE\0JULY\0AUGUST\0SEPTEMBER\0OCTOBER\0NOVEMBER\0DECEMBER",
+    "JAN\0FEB\0MAR\0APR\0MAY\0JUN\0JUL\0AUG\0SEP\0OCT\0NOV\0DEC",
+    NULL },
+  { "fr",
+    "DIMANCHE\0LUNDI\0MARDI\0MERCREDI\0JEUDI\0VENDREDI\0SAMEDI",
+    "DIM\0LUN\0MAR\0MER\0JEU\0VEN\0SAM",
+    "JANVIER\0FÉVRIER\0MARS\0AVRIL\0MAI\0JUIN\0JUILLET\0AOÛT\0SEPTEMBRE\0OCTOBRE\0NOVEMBRE\0DÉCEMBRE",
+    "JANV\0FÉVR\0MARS\0AVR\0MAI\0JUIN\0JUIL\0AOÛT\0SEPT\0OCT\0NOV\0DÉC",
+    " " },
+  { "de",
+    "SONNTAG\0MONTAG\0DIENSTAG\0MITTWOCH\0DONNERSTAG\0FREITAG\0SAMSTAG",
+    "SO\0MO\0DI\0MI\0DO\0FR\0SA",
+    "JANUAR\0FEBRUAR\0MÄRZ\0APRIL\0MAI\0JUNI\0JULI\0AUGUST\0SEPTEMBER\0OKTOBER\0NOVEMBER\0DEZEMBER",
+    "JAN\0FEB\0MÄR\0APR\0MAI\0JUN\0JUL\0AUG\0SEP\0OKT\0NOV\0DEZ",
+    ". " },
+  { "es",
+    "DOMINGO\0LUNES\0MARTES\0MIÉRCOLES\0JUEVES\0VIERNES\0SÁBADO",
+    "DOM\0LUN\0MAR\0MIÉ\0JUE\0VIE\0SÁB",
+    "ENERO\0FEBRERO\0MARZO\0ABRIL\0MAYO\0JUNIO\0JULIO\0AGOSTO\0SEPTIEMBRE\0OCTUBRE\0NOVIEMBRE\0DICIEMBRE",
+    "ENE\0FEB\0MAR\0ABR\0MAY\0JUN\0JUL\0AGO\0SEP\0OCT\0NOV\0DIC",
+    " " },
+  { "it",
+    "DOMENICA\0LUNEDÌ\0MARTEDÌ\0MERCOLEDÌ\0GIOVEDÌ\0VENERDÌ\0SABATO",
+    "DOM\0LUN\0MAR\0MER\0GIO\0VEN\0SAB",
+    "GENNAIO\0FEBBRAIO\0MARZO\0APRILE\0MAGGIO\0GIUGNO\0LUGLIO\0AGOSTO\0SETTEMBRE\0OTTOBRE\0NOVEMBRE\0DICEMBRE",
+    "GEN\0FEB\0MAR\0APR\0MAG\0GIU\0LUG\0AGO\0SET\0OTT\0NOV\0DIC",
+    " " },
+  { "pt",
+    "DOMINGO\0SEGUNDA-FEIRA\0TERÇA-FEIRA\0QUARTA-FEIRA\0QUINTA-FEIRA\0SEXTA-FEIRA\0SÁBADO",
+    "DOM\0SEG\0TER\0QUA\0QUI\0SEX\0SÁB",
+    "JANEIRO\0FEVEREIRO\0MARÇO\0ABRIL\0MAIO\0JUNHO\0JULHO\0AGOSTO\0SETEMBRO\0OUTUBRO\0NOVEMBRO\0DEZEMBRO",
+    "JAN\0FEV\0MAR\0ABR\0MAI\0JUN\0JUL\0AGO\0SET\0OUT\0NOV\0DEZ",
+    " " },
+};
+
+static const DateLanguage *s_language = &LANGUAGES[0];
+
+// index-th name of a packed table; out-of-range indexes wrap
+static const char *table_name(const char *names, int index, int count) {
+  index = ((index % count) + count) % count;
+  while (index-- > 0) {
+    names += strlen(names) + 1;
+  }
+  return names;
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+// Appends to a caller buffer, always leaving it terminated
+typedef struct {
+  char *pos;
+  char *end;      // Last byte, kept for the terminator
+} DateWriter;
+
+// Whole UTF-8 characters only, so a short buffer never ends mid-letter
+static void put_text(DateWriter *w, const char *text) {
+  while (*text) {
+    int len = 1;
+    unsigned char lead = (unsigned char)*text;
+    if (lead >= 0xF0) len = 4;
+    else if (lead >= 0xE0) len = 3;
+    else if (lead >= 0xC0) len = 2;
+    if (w->end - w->pos < len) break;
+    for (int i = 0; i < len && *text; i++) {
+      *w->pos++ = *text++;
+    }
+  }
+  *w->pos = '\0';
+}
+
+// Decimal digits, zero-padded to min_digits
+static void put_number(DateWriter *w, int value, int min_digits) {
+  char digits[12];
+  int count = 0;
+  bool negative = value < 0;
+  unsigned int magnitude = negative ? 0u - (unsigned int)value : (unsigned int)value;
+  do {
+    digits[count++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0 && count < (int)sizeof(digits));
+  while (count < min_digits && count < (int)sizeof(digits)) {
+    digits[count++] = '0';
+  }
+  if (negative && w->pos < w->end) *w->pos++ = '-';
+  while (count > 0 && w->pos < w->end) {
+    *w->pos++ = digits[--count];
+  }
+  *w->pos = '\0';
+}
+
+static void put_weekday(DateWriter *w, struct tm *t, bool short_name) {
+  put_text(w, table_name(short_name ? s_language->weekdays_short : s_language->weekdays, t->tm_wday, 7));
+}
+
+static void put_month(DateWriter *w, struct tm *t, bool short_name) {
+  put_text(w, table_name(short_name ? s_language->months_short : s_language->months, t->tm_mon, 12));
+}
+
+// Numeric dates: fields in the order given, joined by sep
+static void put_numeric_date(DateWriter *w, struct tm *t, const char *order, const char *sep) {
+  for (const char *field = order; *field; field++) {
+    if (field != order) put_text(w, sep);
+    if (*field == 'Y') put_number(w, t->tm_year + 1900, 4);
+    else if (*field == 'M') put_number(w, t->tm_mon + 1, 2);
+    else put_number(w, t->tm_mday, 2);
+  }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void date_format_init(void) {
+  const char *locale = i18n_get_system_locale();
+  s_language = &LANGUAGES[0];
+  if (!locale) return;
+  for (size_t i = 0; i < ARRAY_LENGTH(LANGUAGES); i++) {
+    if (strncmp(locale, LANGUAGES[i].code, 2) == 0) {
+      s_language = &LANGUAGES[i];
+      return;
     }
-    str++;
   }
 }
 
 void format_date_string(char *buffer, size_t buffer_size, struct tm *tick_time, DateFormatType format, int step_count, int distance_walked, bool use_miles, int heart_rate) {
-  if (!buffer) return;
+  if (!buffer || buffer_size == 0) return;
+  DateWriter w = { buffer, buffer + buffer_size - 1 };
+  buffer[0] = '\0';
   
   switch (format) {
     case DATE_FORMAT_WEEKDAY:
       // MONDAY
       if (!tick_time) return;
-      strftime(buffer, buffer_size, "%A", tick_time);
-      to_uppercase(buffer);
+      put_weekday(&w, tick_time, false);
       break;
       
     case DATE_FORMAT_MONTH_DAY:
-      // DECEMBER 29
+      // DECEMBER 29 (29 DÉCEMBRE where the day comes first)
       if (!tick_time) return;
-      strftime(buffer, buffer_size, "%B %d", tick_time);
-      to_uppercase(buffer);
+      if (s_language->day_month) {
+        put_number(&w, tick_time->tm_mday, 1);
+        put_text(&w, s_language->day_month);
+        put_month(&w, tick_time, false);
+      } else {
+        put_month(&w, tick_time, false);
+        put_text(&w, " ");
+        put_number(&w, tick_time->tm_mday, 2);
+      }
       break;
       
     case DATE_FORMAT_YYYY_MM_DD:
       // 2025-12-29
       if (!tick_time) return;
-      strftime(buffer, buffer_size, "%Y-%m-%d", tick_time);
+      put_numeric_date(&w, tick_time, "YMD", "-");
       break;
       
     case DATE_FORMAT_DD_MM_YYYY:
       // 29/12/2025
       if (!tick_time) return;
-      strftime(buffer, buffer_size, "%d/%m/%Y", tick_time);
+      put_numeric_date(&w, tick_time, "DMY", "/");
       break;
       
     case DATE_FORMAT_MM_DD_YYYY:
       // 12/29/2025
       if (!tick_time) return;
-      strftime(buffer, buffer_size, "%m/%d/%Y", tick_time);
+      put_numeric_date(&w, tick_time, "MDY", "/");
       break;
       
     case DATE_FORMAT_MONTH_YEAR:
       // DEC 2025
       if (!tick_time) return;
-      strftime(buffer, buffer_size, "%b %Y", tick_time);
-      to_uppercase(buffer);
+      put_month(&w, tick_time, true);
+      put_text(&w, " ");
+      put_number(&w, tick_time->tm_year + 1900, 4);
       break;
       
     case DATE_FORMAT_WEEKDAY_DAY:
       // MON 29
       if (!tick_time) return;
-      strftime(buffer, buffer_size, "%a %d", tick_time);
-      to_uppercase(buffer);
+      put_weekday(&w, tick_time, true);
+      put_text(&w, " ");
+      put_number(&w, tick_time->tm_mday, 2);
       break;
       
     case DATE_FORMAT_STEP_COUNT:
       // Step count
-      snprintf(buffer, buffer_size, "%d", step_count);
+      put_number(&w, step_count, 1);
       break;
       
     case DATE_FORMAT_DISTANCE:
@@ -99,23 +244,45 @@ void format_date_string(char *buffer, size_t buffer_size, struct tm *tick_time,
       }
       break;
       
+    case DATE_FORMAT_STEP_HISTORY:
+      // No text; the module draws the sparkline in its place
+      break;
+      
     default:
       // Fallback to weekday
-      strftime(buffer, buffer_size, "%A", tick_time);
-      to_uppercase(buffer);
+      if (!tick_time) return;
+      put_weekday(&w, tick_time, false);
       break;
   }
 }
 
+// Reads exactly count decimal digits
+static bool parse_digits(const char *str, int count, int *out) {
+  int value = 0;
+  for (int i = 0; i < count; i++) {
+    if (str[i] < '0' || str[i] > '9') return false;
+    value = value * 10 + (str[i] - '0');
+  }
+  *out = value;
+  return true;
+}
+
 bool from_string_to_tm(const char *time_str, struct tm *out) {
   // Parse "2026-03-08T06:30" manually (no sscanf to avoid pulling in libc)
   if (!time_str || !out || strlen(time_str) < 16) return false;
 
+  int year, mon, mday, hour, min;
+  if (!parse_digits(time_str, 4, &year) || !parse_digits(time_str + 5, 2, &mon) ||
+      !parse_digits(time_str + 8, 2, &mday) || !parse_digits(time_str + 11, 2, &hour) ||
+      !parse_digits(time_str + 14, 2, &min)) {
+    return false;
+  }
+
   memset(out, 0, sizeof(struct tm));
-  out->tm_year = atoi(time_str) - 1900;       // "2026" -> 126
-  out->tm_mon  = atoi(time_str + 5) - 1;      // "03"   -> 2
-  out->tm_mday = atoi(time_str + 8);           // "08"
-  out->tm_hour = atoi(time_str + 11);          // "06"
-  out->tm_min  = atoi(time_str + 14);          // "30"
+  out->tm_year = year - 1900;                  // "2026" -> 126
+  out->tm_mon  = mon - 1;                      // "03"   -> 2
+  out->tm_mday = mday;                         // "08"
+  out->tm_hour = hour;                         // "06"
+  out->tm_min  = min;                          // "30"
   return true;
 }
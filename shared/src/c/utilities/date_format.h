@@ -12,9 +12,14 @@ typedef enum {
   DATE_FORMAT_WEEKDAY_DAY,       // MON 29
   DATE_FORMAT_STEP_COUNT,        // Step count display
   DATE_FORMAT_DISTANCE,           // Distance walked display
-  DATE_FORMAT_HEART_RATE          // Heart rate BPM display
+  DATE_FORMAT_HEART_RATE,         // Heart rate BPM display
+  DATE_FORMAT_STEP_HISTORY        // Today's steps per hour, drawn as a sparkline
 } DateFormatType;
 
+// Picks weekday and month names for the watch's language (English where
+// there is no table); call once at startup, before anything is formatted
+void date_format_init(void);
+
 // Format a date string according to the specified format type
 void format_date_string(char *buffer, size_t buffer_size, struct tm *tick_time, DateFormatType format, int step_count, int distance_walked, bool use_miles, int heart_rate);
 
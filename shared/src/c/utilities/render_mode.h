@@ -0,0 +1,12 @@
+#pragma once
+
+// Render mode, chosen per platform at build time (see wscript)
+//
+// RENDER_IMMEDIATE = 0: every module builds its own Text/Bitmap/custom layers.
+// RENDER_IMMEDIATE = 1: modules create no layers; one full-screen layer
+//   (face_renderer_module) draws the face from module state, using the frames
+//   each module computed in its *_init from the usual offsets.
+
+#ifndef RENDER_IMMEDIATE
+#define RENDER_IMMEDIATE 0
+#endif
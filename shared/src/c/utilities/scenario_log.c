@@ -0,0 +1,46 @@
+#include "scenario_log.h"
+
+#if SCENARIO_LOG
+
+static uint32_t s_launch_ms = 0;
+static size_t s_heap_peak = 0;
+static const char *s_expected = NULL;
+
+static uint32_t now_ms(void) {
+  time_t seconds;
+  uint16_t millis;
+  time_ms(&seconds, &millis);
+  return (uint32_t)seconds * 1000 + millis;
+}
+
+static size_t sample_heap(void) {
+  size_t used = heap_bytes_used();
+  if (used > s_heap_peak) s_heap_peak = used;
+  return used;
+}
+
+void scenario_log_launch(void) {
+  s_launch_ms = now_ms();
+  scenario_log_mark("launch");
+}
+
+void scenario_log_mark(const char *event) {
+  size_t used = sample_heap();
+  APP_LOG(APP_LOG_LEVEL_INFO, "SCN %s %lu %u %u", event, (unsigned long)(now_ms() - s_launch_ms),
+          (unsigned)used, (unsigned)s_heap_peak);
+}
+
+void scenario_log_expect_frame(const char *event) {
+  s_expected = event;
+}
+
+void scenario_log_frame(void) {
+  sample_heap();
+  if (s_expected) {
+    const char *event = s_expected;
+    s_expected = NULL;
+    scenario_log_mark(event);
+  }
+}
+
+#endif
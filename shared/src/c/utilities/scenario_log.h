@@ -0,0 +1,30 @@
+#pragma once
+#include <pebble.h>
+
+// Scenario log, enabled at build time with SCENARIO_LOG=1 (see wscript)
+//
+// Writes one APP_LOG line per event for tools/emu_scenarios.py:
+//
+//   SCN <event> <ms since launch> <heap used> <heap peak>
+//
+// The heap peak is the highest heap_bytes_used() seen at any event or frame.
+// scenario_log_expect_frame() arms an event that is logged by the next
+// scenario_log_frame(), so the time to the first frame of a window shows up
+// as the difference between two lines. Without SCENARIO_LOG every call
+// compiles away.
+
+#ifndef SCENARIO_LOG
+#define SCENARIO_LOG 0
+#endif
+
+#if SCENARIO_LOG
+void scenario_log_launch(void);
+void scenario_log_mark(const char *event);
+void scenario_log_expect_frame(const char *event);
+void scenario_log_frame(void);
+#else
+#define scenario_log_launch()
+#define scenario_log_mark(event)
+#define scenario_log_expect_frame(event)
+#define scenario_log_frame()
+#endif
@@ -9,6 +9,15 @@
 static WeatherData s_weather_data = {0};
 static int s_scale = 1; // 1=Celsius, 2=Fahrenheit
 
+// Layout written to persistent storage; bump the version when WeatherData changes
+#define WEATHER_SNAPSHOT_VERSION 1
+
+typedef struct {
+  uint8_t version;
+  time_t received_at;
+  WeatherData data;
+} WeatherSnapshot;
+
 // ============================================================================
 // PRIVATE FUNCTIONS - JSON PARSING HELPERS
 // ============================================================================
@@ -57,6 +66,41 @@ static bool get_json_int(const char *json, const char *key, int32_t *output) {
   return true;
 }
 
+// ============================================================================
+// PRIVATE FUNCTIONS - PERSISTENCE
+// ============================================================================
+
+static void save_snapshot(void) {
+  if (!s_weather_data.is_valid) return;
+  WeatherSnapshot snapshot = {
+    .version = WEATHER_SNAPSHOT_VERSION,
+    .received_at = time(NULL),
+    .data = s_weather_data,
+  };
+  persist_write_data(WEATHER_PERSIST_KEY, &snapshot, sizeof(snapshot));
+}
+
+static bool load_snapshot(void) {
+  if (!persist_exists(WEATHER_PERSIST_KEY)) return false;
+
+  WeatherSnapshot snapshot;
+  if (persist_read_data(WEATHER_PERSIST_KEY, &snapshot, sizeof(snapshot)) != (int)sizeof(snapshot) ||
+      snapshot.version != WEATHER_SNAPSHOT_VERSION || !snapshot.data.is_valid) {
+    persist_delete(WEATHER_PERSIST_KEY);
+    return false;
+  }
+
+  // Drop snapshots that are too old (or from the future after a clock change)
+  time_t age = time(NULL) - snapshot.received_at;
+  if (age < 0 || age > WEATHER_SNAPSHOT_MAX_AGE_S) {
+    persist_delete(WEATHER_PERSIST_KEY);
+    return false;
+  }
+
+  s_weather_data = snapshot.data;
+  return true;
+}
+
 // ============================================================================
 // PUBLIC FUNCTIONS
 // ============================================================================
@@ -64,6 +108,7 @@ static bool get_json_int(const char *json, const char *key, int32_t *output) {
 void weather_module_init(void) {
   memset(&s_weather_data, 0, sizeof(WeatherData));
   s_weather_data.is_valid = false;
+  load_snapshot();
 }
 
 void weather_module_update(const char *json_data) {
@@ -108,14 +153,31 @@ void weather_module_update(const char *json_data) {
   if (get_json_int(json_data, "moonPhaseIcon", &temp_val)) {
     s_weather_data.moon_phase_icon = (int16_t)temp_val;
   }
+
+  // Parse fetch time (seconds); fall back to receive time for older payloads
+  if (get_json_int(json_data, "timestamp", &temp_val) && temp_val > 0) {
+    s_weather_data.updated_at = (time_t)temp_val;
+  } else {
+    s_weather_data.updated_at = time(NULL);
+  }
   
   s_weather_data.is_valid = true;
 }
 
+void weather_module_save(void) {
+  save_snapshot();
+}
+
 WeatherData* weather_module_get_data(void) {
   return &s_weather_data;
 }
 
+int32_t weather_module_get_age(time_t now) {
+  if (!s_weather_data.is_valid) return INT32_MAX;
+  int32_t age = (int32_t)(now - s_weather_data.updated_at);
+  return (age < 0) ? 0 : age;  // Phone clock ahead of the watch
+}
+
 void weather_module_set_scale(int scale) {
   s_scale = (scale == 2) ? 2 : 1;
 }
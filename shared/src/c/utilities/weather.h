@@ -10,18 +10,29 @@ typedef struct {
   uint8_t moon_phase;       // Moon phase 0-100 (0=new, 50=full, 100=new)
   char moon_phase_name[20]; // Moon phase name
   int16_t moon_phase_icon; // Moon phase icon
+  time_t updated_at;        // Unix time the phone fetched this data
   bool is_valid;            // Whether we have valid data
 } WeatherData;
 
-// Initialize weather module
+// Persisted snapshot of the last valid data (kept clear of the MESSAGE_KEY_* range)
+#define WEATHER_PERSIST_KEY 1
+#define WEATHER_SNAPSHOT_MAX_AGE_S (6 * 60 * 60)  // Older snapshots are dropped at startup
+
+// Initialize weather module (restores the persisted snapshot if still fresh)
 void weather_module_init(void);
 
 // Update weather data from JSON string
 void weather_module_update(const char *json_data);
 
+// Persist the current data; posted as work after an update, not run in the handler
+void weather_module_save(void);
+
 // Get current weather data
 WeatherData* weather_module_get_data(void);
 
+// Seconds since the current data was fetched (INT32_MAX if there is none)
+int32_t weather_module_get_age(time_t now);
+
 // Get weather icon resource ID from WMO code
 uint32_t weather_module_get_icon_resource(uint16_t code, bool is_night);
 
@@ -0,0 +1,96 @@
+#include "heart_rate_module.h"
+
+static bool s_shown = false;
+static bool s_pushed = false;
+static int s_bpm = 0;
+
+#if defined(PBL_HEALTH)
+static HealthMetricAlert *s_alert_high = NULL;
+static HealthMetricAlert *s_alert_low = NULL;
+
+static void cancel_alerts(void) {
+  if (s_alert_high) {
+    health_service_cancel_metric_alert(s_alert_high);
+    s_alert_high = NULL;
+  }
+  if (s_alert_low) {
+    health_service_cancel_metric_alert(s_alert_low);
+    s_alert_low = NULL;
+  }
+}
+
+// Fire once the rate is a band away from the value on screen, either way
+static void arm_alerts(void) {
+  cancel_alerts();
+  if (s_shown && s_pushed && s_bpm > 0) {
+    s_alert_high = health_service_register_metric_alert(HealthMetricHeartRateBPM, s_bpm + HEART_RATE_BAND_BPM);
+    s_alert_low = health_service_register_metric_alert(HealthMetricHeartRateBPM, s_bpm - HEART_RATE_BAND_BPM + 1);
+  }
+}
+
+static bool read_bpm(void) {
+  int bpm = (int)health_service_peek_current_value(HealthMetricHeartRateBPM);
+  int delta = bpm > s_bpm ? bpm - s_bpm : s_bpm - bpm;
+  if (bpm == s_bpm || (bpm > 0 && s_bpm > 0 && delta < HEART_RATE_BAND_BPM)) return false;
+  s_bpm = bpm;
+  return true;
+}
+#endif
+
+void heart_rate_module_set_shown(bool shown) {
+  if (shown == s_shown) return;
+  s_shown = shown;
+#if defined(PBL_HEALTH)
+  if (shown) {
+    health_service_set_heart_rate_sample_period(HEART_RATE_SAMPLE_PERIOD_S);
+    read_bpm();
+  } else {
+    // 0 hands the sensor back to the system default
+    health_service_set_heart_rate_sample_period(0);
+    s_bpm = 0;
+  }
+  arm_alerts();
+#endif
+}
+
+void heart_rate_module_set_pushed(bool pushed) {
+  if (pushed == s_pushed) return;
+  s_pushed = pushed;
+#if defined(PBL_HEALTH)
+  arm_alerts();
+#endif
+}
+
+void heart_rate_module_update(void) {
+  if (!s_shown) return;
+#if defined(PBL_HEALTH)
+  if (health_service_get_heart_rate_sample_period_expiration_sec() < HEART_RATE_RENEW_S) {
+    health_service_set_heart_rate_sample_period(HEART_RATE_SAMPLE_PERIOD_S);
+  }
+  if (!s_pushed || !s_alert_high || !s_alert_low) {
+    // Polled while health events are off, or while a direction is not covered
+    if (read_bpm()) arm_alerts();
+  }
+#endif
+}
+
+bool heart_rate_module_health_event(HealthEventType event) {
+#if defined(PBL_HEALTH)
+  if (!s_shown || event != HealthEventMetricAlert) return false;
+  bool changed = read_bpm();
+  // Re-armed around the value on screen
+  arm_alerts();
+  return changed;
+#else
+  return false;
+#endif
+}
+
+int heart_rate_module_get_bpm(void) {
+  return s_shown ? s_bpm : 0;
+}
+
+void heart_rate_module_deinit(void) {
+  heart_rate_module_set_shown(false);
+  s_pushed = false;
+}
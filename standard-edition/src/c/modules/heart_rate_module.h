@@ -0,0 +1,32 @@
+#pragma once
+#include <pebble.h>
+
+// Heart Rate Module - Reads BPM only while a module slot shows it
+//
+// While shown, the sensor is asked for a sample every
+// HEART_RATE_SAMPLE_PERIOD_S and metric alerts are armed HEART_RATE_BAND_BPM
+// above and below the value on screen, so the firmware pushes
+// HealthEventMetricAlert when the rate moves instead of the face polling it.
+// If an alert cannot be registered, the value is read on the minute instead.
+// While hidden, the sample period goes back to the system default, the
+// alerts are cancelled and nothing is read.
+
+#define HEART_RATE_SAMPLE_PERIOD_S 60     // The slot only redraws once a minute
+#define HEART_RATE_RENEW_S (5 * 60)       // Renew the period request this close to expiry
+#define HEART_RATE_BAND_BPM 3             // Smaller moves keep the value on screen
+
+void heart_rate_module_set_shown(bool shown);
+
+// Health events subscribed (pushed) or not (read on every minute update)
+void heart_rate_module_set_pushed(bool pushed);
+
+// Minute tick: keeps the sample period request alive, reads BPM when not pushed
+void heart_rate_module_update(void);
+
+// Returns true when the BPM to show changed
+bool heart_rate_module_health_event(HealthEventType event);
+
+// BPM to show, 0 while hidden or unknown
+int heart_rate_module_get_bpm(void);
+
+void heart_rate_module_deinit(void);
@@ -10,3 +10,6 @@ void moon_view_module_hide(void);
 
 // Set whether to use line style (rect) for the sun tracker bar
 void moon_view_module_set_line_style(bool use_line);
+
+// Show today's steps per hour beneath the moon (applies on the next show)
+void moon_view_module_set_step_history(bool show);
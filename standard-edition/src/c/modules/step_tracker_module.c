@@ -1,17 +1,23 @@
 #include "step_tracker_module.h"
+#include "../shared_modules/render_graph_module.h"
+#include "../shared_modules/face_renderer_module.h"
 
-static BitmapLayer *s_walk_layer = NULL;
-static BitmapLayer *s_flag_layer = NULL;
 static GBitmap *s_walking_bitmap = NULL;
 static GBitmap *s_flag_bitmap = NULL;
+static GRect s_left_icon_frame;
+static GRect s_right_icon_frame;
 static int s_step_count = 0;
 static int s_step_goal = 8000;
-static Layer *s_parent_canvas_layer = NULL;
 static int s_last_health_step_count = 0;
 static time_t s_last_health_update = 0;
 
+#if !RENDER_IMMEDIATE
+static BitmapLayer *s_walk_layer = NULL;
+static BitmapLayer *s_flag_layer = NULL;
+#endif
+
+void step_tracker_module_health_event(HealthEventType event) {
 #if defined(PBL_HEALTH)
-static void health_handler(HealthEventType event, void *context) {
   // Update step count when health data changes
   if (event == HealthEventMovementUpdate || event == HealthEventSignificantUpdate) {
     // Throttle updates to at most once per 60 seconds
@@ -25,17 +31,17 @@ static void health_handler(HealthEventType event, void *context) {
     if (new_count - s_last_health_step_count >= 50 || new_count < s_last_health_step_count) {
       s_step_count = new_count;
       s_last_health_step_count = new_count;
-      if (s_parent_canvas_layer) {
-        layer_mark_dirty(s_parent_canvas_layer);
-      }
+      render_graph_invalidate(RENDER_INPUT_STEPS);
+      render_graph_flush();
     }
   }
-}
 #endif
+}
 
-void step_tracker_module_init(Window *window, GRect bounds, Layer *canvas_layer) {
+void step_tracker_module_init(Window *window, GRect bounds) {
+#if !RENDER_IMMEDIATE
   Layer *window_layer = window_get_root_layer(window);
-  s_parent_canvas_layer = canvas_layer;
+#endif
   
   // Load bitmap resources
   s_walking_bitmap = gbitmap_create_with_resource(RESOURCE_ID_WALKING_IMAGE);
@@ -49,12 +55,15 @@ void step_tracker_module_init(Window *window, GRect bounds, Layer *canvas_layer)
     icon_x += 8;
     icon_y -= 3;
 #endif
-    s_walk_layer = bitmap_layer_create(GRect(icon_x, icon_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE));
+    s_left_icon_frame = GRect(icon_x, icon_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE);
+#if !RENDER_IMMEDIATE
+    s_walk_layer = bitmap_layer_create(s_left_icon_frame);
     if (s_walk_layer) {
       bitmap_layer_set_bitmap(s_walk_layer, s_walking_bitmap);
       bitmap_layer_set_compositing_mode(s_walk_layer, GCompOpSet);
       layer_add_child(window_layer, bitmap_layer_get_layer(s_walk_layer));
     }
+#endif
   }
 
   // Create flag icon layer
@@ -65,12 +74,15 @@ void step_tracker_module_init(Window *window, GRect bounds, Layer *canvas_layer)
     flag_x -= 8;
     flag_y -= 4;
 #endif
-    s_flag_layer = bitmap_layer_create(GRect(flag_x, flag_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE));
+    s_right_icon_frame = GRect(flag_x, flag_y, WALKING_ICON_SIZE, WALKING_ICON_SIZE);
+#if !RENDER_IMMEDIATE
+    s_flag_layer = bitmap_layer_create(s_right_icon_frame);
     if (s_flag_layer) {
       bitmap_layer_set_bitmap(s_flag_layer, s_flag_bitmap);
       bitmap_layer_set_compositing_mode(s_flag_layer, GCompOpSet);
       layer_add_child(window_layer, bitmap_layer_get_layer(s_flag_layer));
     }
+#endif
   }
   
   // Initialize step count
@@ -146,41 +158,35 @@ void step_tracker_module_draw(Layer *layer, GContext *ctx, GRect bounds, int rad
   }
 }
 
+#if RENDER_IMMEDIATE
+void step_tracker_module_draw_icons(GContext *ctx, GRect bounds) {
+  face_renderer_draw_bitmap(ctx, s_walking_bitmap, s_left_icon_frame);
+  face_renderer_draw_bitmap(ctx, s_flag_bitmap, s_right_icon_frame);
+}
+#endif
+
 void step_tracker_module_update(void) {
 #if defined(PBL_HEALTH)
-  s_step_count = (int)health_service_sum_today(HealthMetricStepCount);
-#endif
-  if (s_parent_canvas_layer) {
-    layer_mark_dirty(s_parent_canvas_layer);
+  int count = (int)health_service_sum_today(HealthMetricStepCount);
+  if (count != s_step_count) {
+    s_step_count = count;
+    render_graph_invalidate(RENDER_INPUT_STEPS);
   }
+#endif
 }
 
 void step_tracker_module_set_goal(int goal) {
   s_step_goal = goal;
-  if (s_parent_canvas_layer) {
-    layer_mark_dirty(s_parent_canvas_layer);
-  }
+  render_graph_invalidate(RENDER_INPUT_STEPS);
 }
 
 int step_tracker_module_get_count(void) {
   return s_step_count;
 }
 
-void step_tracker_module_subscribe(void) {
-#if defined(PBL_HEALTH)
-  health_service_events_subscribe(health_handler, NULL);
-  s_step_count = (int)health_service_sum_today(HealthMetricStepCount);
-#endif
-}
-
-void step_tracker_module_unsubscribe(void) {
-#if defined(PBL_HEALTH)
-  health_service_events_unsubscribe();
-#endif
-}
-
 void step_tracker_module_deinit(void) {
   // Destroy bitmap layers
+#if !RENDER_IMMEDIATE
   if (s_walk_layer) {
     bitmap_layer_destroy(s_walk_layer);
     s_walk_layer = NULL;
@@ -189,6 +195,7 @@ void step_tracker_module_deinit(void) {
     bitmap_layer_destroy(s_flag_layer);
     s_flag_layer = NULL;
   }
+#endif
   
   // Destroy bitmaps
   if (s_walking_bitmap) {
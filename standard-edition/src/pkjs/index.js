@@ -2,7 +2,199 @@
 var Clay = require('@rebble/clay');
 var clayConfig = require('./config.json');
 var customClay = require('./custom-clay');
-var clay = new Clay(clayConfig, customClay);
+var clay = new Clay(clayConfig, customClay, { autoHandleEvents: false });
+
+// ============================================================================
+// AppMessage Outbox
+// ============================================================================
+
+// Sends are serialised: only one message is in flight at a time, config
+// always goes ahead of weather, and a queued payload of the same kind is
+// replaced (weather) or merged (config) instead of being sent twice.
+var OUTBOX_PRIORITY = { config: 0, weather: 1 };
+var OUTBOX_RETRY_BASE_MS = 1000;
+var OUTBOX_RETRY_MAX_MS = 60 * 1000;
+var OUTBOX_MAX_ATTEMPTS = 5;         // Then the entry is dropped until the next send of its kind
+
+// Log every delivered message as a replayable trace line
+// (pebble logs > trace.log, then python tools/replay.py trace.log)
+var OUTBOX_TRACE = false;
+
+var outboxQueue = [];
+var outboxInFlight = null;
+var outboxRetryTimer = null;
+
+function outboxFind(kind) {
+  for (var i = 0; i < outboxQueue.length; i++) {
+    if (outboxQueue[i].kind === kind) {
+      return outboxQueue[i];
+    }
+  }
+  return null;
+}
+
+function outboxInsert(entry) {
+  var i = 0;
+  while (i < outboxQueue.length && outboxQueue[i].priority <= entry.priority) {
+    i++;
+  }
+  outboxQueue.splice(i, 0, entry);
+}
+
+function outboxTrace(entry) {
+  if (OUTBOX_TRACE) {
+    console.log('Trace: ' + JSON.stringify({ time: Date.now(), kind: entry.kind, payload: entry.payload }));
+  }
+}
+
+// Merge keys from `older` that are not overridden by `newer`
+function outboxMergeUnder(newer, older) {
+  for (var key in older) {
+    if (older.hasOwnProperty(key) && !newer.hasOwnProperty(key)) {
+      newer[key] = older[key];
+    }
+  }
+}
+
+// NACK, or a throw from sendAppMessage: requeue with backoff or give up
+function outboxFailed(entry, e) {
+  outboxInFlight = null;
+  entry.attempts++;
+  console.log('Outbox: ' + entry.kind + ' failed (attempt ' + entry.attempts + '): ' +
+              (e && e.message ? e.message : JSON.stringify(e)));
+
+  // A newer payload of the same kind was queued while this one was in flight
+  var newer = outboxFind(entry.kind);
+  if (newer) {
+    if (entry.kind === 'config') {
+      outboxMergeUnder(newer.payload, entry.payload);
+    }
+  } else if (entry.attempts >= OUTBOX_MAX_ATTEMPTS) {
+    console.log('Outbox: giving up on ' + entry.kind + ' until it is sent again');
+  } else {
+    outboxInsert(entry);
+  }
+
+  var delay = Math.min(OUTBOX_RETRY_BASE_MS * Math.pow(2, entry.attempts - 1), OUTBOX_RETRY_MAX_MS);
+  outboxRetryTimer = setTimeout(function() {
+    outboxRetryTimer = null;
+    outboxPump();
+  }, delay);
+}
+
+function outboxPump() {
+  if (outboxInFlight || outboxRetryTimer || outboxQueue.length === 0) {
+    return;
+  }
+
+  var entry = outboxQueue.shift();
+  outboxInFlight = entry;
+
+  try {
+    Pebble.sendAppMessage(entry.payload, function() {
+      console.log('Outbox: ' + entry.kind + ' sent');
+      outboxTrace(entry);
+      outboxInFlight = null;
+      outboxPump();
+    }, function(e) {
+      outboxFailed(entry, e);
+    });
+  } catch (e) {
+    // Unless a callback already settled the entry before the throw
+    if (outboxInFlight === entry) {
+      outboxFailed(entry, e);
+    }
+  }
+}
+
+// Queue a message for the watch. kind is 'config' or 'weather'.
+function outboxSend(kind, payload) {
+  var queued = outboxFind(kind);
+  if (queued) {
+    if (kind === 'config') {
+      outboxMergeUnder(payload, queued.payload);
+    }
+    queued.payload = payload;
+    queued.attempts = 0;
+  } else {
+    outboxInsert({ kind: kind, priority: OUTBOX_PRIORITY[kind], payload: payload, attempts: 0 });
+  }
+  outboxPump();
+}
+
+// ============================================================================
+// Location and Forecast Cache
+// ============================================================================
+
+var LOCATION_CACHE_KEY = 'weather-location';
+var LOCATION_TTL_MS = 3 * 60 * 60 * 1000; // Reuse a fix across a few hourly refreshes
+var LOCATION_MAX_AGE_MS = 5 * 60 * 1000;  // Oldest OS fix accepted once the TTL is up
+var LOCATION_DECIMALS = 2;                // ~1.1 km grid so repeat requests share a URL
+var LOCATION_MIN_MOVE_M = 1000;           // Smaller moves keep the cached forecast
+var FORECAST_CACHE_KEY = 'weather-forecast';
+var FORECAST_TTL_MS = 60 * 60 * 1000;     // Mirrors WEATHER_STALE_AGE_S, counted from the payload timestamp
+
+function readCache(key) {
+  try {
+    return JSON.parse(localStorage.getItem(key));
+  } catch (e) {
+    return null;
+  }
+}
+
+function writeCache(key, value) {
+  try {
+    localStorage.setItem(key, JSON.stringify(value));
+  } catch (e) {
+    console.log('Cache write failed for ' + key + ': ' + e.message);
+  }
+}
+
+function roundCoordinate(value) {
+  var factor = Math.pow(10, LOCATION_DECIMALS);
+  return Math.round(value * factor) / factor;
+}
+
+// Equirectangular approximation, accurate enough at kilometre scale
+function distanceMeters(lat1, lon1, lat2, lon2) {
+  var rad = Math.PI / 180;
+  var x = (lon2 - lon1) * rad * Math.cos((lat1 + lat2) / 2 * rad);
+  var y = (lat2 - lat1) * rad;
+  return Math.sqrt(x * x + y * y) * 6371000;
+}
+
+// Calls back with rounded coordinates, only asking the OS for a new fix after the TTL
+function getLocation(callback) {
+  var cached = readCache(LOCATION_CACHE_KEY);
+  if (cached && Date.now() - cached.time < LOCATION_TTL_MS) {
+    console.log('Using cached location: ' + cached.latitude + ', ' + cached.longitude);
+    callback(cached.latitude, cached.longitude);
+    return;
+  }
+
+  console.log('Getting location for weather update...');
+
+  navigator.geolocation.getCurrentPosition(
+    function(pos) {
+      var location = {
+        latitude: roundCoordinate(pos.coords.latitude),
+        longitude: roundCoordinate(pos.coords.longitude),
+        time: Date.now()
+      };
+      console.log('Location obtained: ' + location.latitude + ', ' + location.longitude);
+      writeCache(LOCATION_CACHE_KEY, location);
+      callback(location.latitude, location.longitude);
+    },
+    function(err) {
+      console.log('Location error: ' + err.message);
+      // An old fix is still better than no weather at all
+      if (cached) {
+        callback(cached.latitude, cached.longitude);
+      }
+    },
+    { timeout: 15000, maximumAge: LOCATION_MAX_AGE_MS }
+  );
+}
 
 // ============================================================================
 // Weather Data Functions
@@ -56,6 +248,26 @@ function getMoonPhaseInfo(phase) {
   return phaseNames[0];
 }
 
+// Derive the watch payload from a parsed Open-Meteo response
+function buildWeatherData(response) {
+  // Calculate moon phase
+  var now = new Date();
+  var moonPhase = calculateMoonPhase(now);
+  var moonInfo = getMoonPhaseInfo(moonPhase);
+  
+  // Create weather data object
+  return {
+    temperature: Math.round(response.current.temperature_2m),
+    weatherCode: response.current.weather_code,
+    sunrise: response.daily.sunrise[0],
+    sunset: response.daily.sunset[0],
+    moonPhase: Math.round(moonPhase * 100), // 0-100
+    moonPhaseName: moonInfo.name,
+    moonPhaseIcon: moonInfo.icon,
+    timestamp: Math.floor(Date.now() / 1000) // seconds, fits the watch's int32
+  };
+}
+
 // Fetch weather data from Open-Meteo API
 function fetchWeatherData(latitude, longitude) {
   console.log('Fetching weather for: ' + latitude + ', ' + longitude);
@@ -78,33 +290,23 @@ function fetchWeatherData(latitude, longitude) {
         var response = JSON.parse(xhr.responseText);
         console.log('Weather data received:', JSON.stringify(response));
         
-        // Calculate moon phase
-        var now = new Date();
-        var moonPhase = calculateMoonPhase(now);
-        var moonInfo = getMoonPhaseInfo(moonPhase);
-        
-        // Create weather data object
-        var weatherData = {
-          temperature: Math.round(response.current.temperature_2m),
-          weatherCode: response.current.weather_code,
-          sunrise: response.daily.sunrise[0],
-          sunset: response.daily.sunset[0],
-          moonPhase: Math.round(moonPhase * 100), // 0-100
-          moonPhaseName: moonInfo.name,
-          moonPhaseIcon: moonInfo.icon,
-          timestamp: Date.now()
-        };
+        var weatherData = buildWeatherData(response);
         
         console.log('Sending weather data:', JSON.stringify(weatherData));
         
-        // Send to watchface as JSON string
-        Pebble.sendAppMessage({
+        var payload = {
           'WEATHER_DATA': JSON.stringify(weatherData)
-        }, function() {
-          console.log('Weather data sent successfully');
-        }, function(e) {
-          console.log('Failed to send weather data: ' + JSON.stringify(e));
+        };
+        writeCache(FORECAST_CACHE_KEY, {
+          latitude: latitude,
+          longitude: longitude,
+          expires: weatherData.timestamp * 1000 + FORECAST_TTL_MS * powerScale(),
+          response: response,
+          payload: payload
         });
+
+        // Send to watchface as JSON string
+        outboxSend('weather', payload);
         
       } catch (e) {
         console.log('Error parsing weather data: ' + e.message);
@@ -121,32 +323,67 @@ function fetchWeatherData(latitude, longitude) {
   xhr.send();
 }
 
-// Get location and fetch weather
-function updateWeather() {
-  // Skip weather fetch if both weather display and moon view are disabled
+// False when both weather display and moon view are disabled
+function isWeatherEnabled() {
   try {
     var settings = JSON.parse(localStorage.getItem('clay-settings')) || {};
-    var showWeather = settings.SHOW_WEATHER;
-    var showMoonView = settings.SHOW_MOON_VIEW;
     // Clay stores toggles as true/false; treat missing as default (true)
-    if (showWeather === false && showMoonView === false) {
-      console.log('Weather and moon view both disabled, skipping fetch');
+    return !(settings.SHOW_WEATHER === false && settings.SHOW_MOON_VIEW === false);
+  } catch (e) {
+    return true;
+  }
+}
+
+// Get location and fetch weather
+function updateWeather() {
+  if (!isWeatherEnabled()) {
+    console.log('Weather and moon view both disabled, skipping fetch');
+    return;
+  }
+
+  getLocation(function(latitude, longitude) {
+    // Skip the HTTP round trip when we have not moved and the forecast is fresh
+    var forecast = readCache(FORECAST_CACHE_KEY);
+    if (forecast && Date.now() < forecast.expires &&
+        distanceMeters(latitude, longitude, forecast.latitude, forecast.longitude) < LOCATION_MIN_MOVE_M) {
+      console.log('Position unchanged, reusing cached forecast');
+      outboxSend('weather', forecast.payload);
       return;
     }
-  } catch (e) {}
+    fetchWeatherData(latitude, longitude);
+  });
+}
 
-  console.log('Getting location for weather update...');
-  
-  navigator.geolocation.getCurrentPosition(
-    function(pos) {
-      console.log('Location obtained: ' + pos.coords.latitude + ', ' + pos.coords.longitude);
-      fetchWeatherData(pos.coords.latitude, pos.coords.longitude);
-    },
-    function(err) {
-      console.log('Location error: ' + err.message);
-    },
-    { timeout: 15000, maximumAge: 600000 }
-  );
+// ============================================================================
+// Render Budget
+// ============================================================================
+
+// Mirrors RenderLevel in render_budget_module.h
+var RENDER_LEVEL_NAMES = ['full', 'no antialiasing', 'minute ticker', 'no decorative ring'];
+var RENDER_LEVEL_CACHE_KEY = 'render-level';
+
+// ============================================================================
+// Power Governor
+// ============================================================================
+
+// Mirrors PowerTier in power_governor_module.h
+var POWER_TIER_NAMES = ['full', 'minute ticker', 'no wrist tap', 'polled health'];
+var POWER_TIER_CACHE_KEY = 'power-tier';
+var BACKSTOP_INTERVAL_MS = 3 * 60 * 60 * 1000;
+
+var backstopTimer = null;
+
+// Refresh spacing doubles with every tier the watch has shed, as it does on the watch
+function powerScale() {
+  var cached = readCache(POWER_TIER_CACHE_KEY);
+  return cached ? 1 << cached.tier : 1;
+}
+
+function scheduleBackstop() {
+  if (backstopTimer) {
+    clearInterval(backstopTimer);
+  }
+  backstopTimer = setInterval(updateWeather, BACKSTOP_INTERVAL_MS * powerScale());
 }
 
 // ============================================================================
@@ -156,11 +393,31 @@ function updateWeather() {
 Pebble.addEventListener('ready', function() {
   console.log('PebbleKit JS ready!');
   
-  // Fetch weather on startup
-  updateWeather();
+  // Push the last forecast right away, revalidate in the background only once it expired
+  var forecast = readCache(FORECAST_CACHE_KEY);
+  if (forecast && forecast.payload && isWeatherEnabled()) {
+    console.log('Sending cached weather data');
+    outboxSend('weather', forecast.payload);
+  }
+  if (!forecast || Date.now() >= forecast.expires) {
+    updateWeather();
+  }
   
-  // Update weather every 60 minutes
-  setInterval(updateWeather, 60 * 60 * 1000);
+  // The watch requests a refresh when its data goes stale; this is only a backstop
+  scheduleBackstop();
+});
+
+Pebble.addEventListener('showConfiguration', function() {
+  Pebble.openURL(clay.generateUrl());
+});
+
+Pebble.addEventListener('webviewclosed', function(e) {
+  if (!e || !e.response) {
+    return;
+  }
+
+  // Route config through the outbox so it cannot collide with a weather push
+  outboxSend('config', clay.getSettings(e.response));
 });
 
 Pebble.addEventListener('appmessage', function(e) {
@@ -170,4 +427,22 @@ Pebble.addEventListener('appmessage', function(e) {
   if (e.payload.REQUEST_WEATHER) {
     updateWeather();
   }
+
+  // Render budget level pushed by the watch whenever it sheds or restores a feature
+  if (e.payload.RENDER_LEVEL !== undefined) {
+    var level = e.payload.RENDER_LEVEL;
+    console.log('Render level: ' + level + ' (' + (RENDER_LEVEL_NAMES[level] || 'unknown') + ')');
+    writeCache(RENDER_LEVEL_CACHE_KEY, { level: level, time: Date.now() });
+  }
+
+  // Power tier pushed by the watch on launch and whenever the battery crosses a step
+  if (e.payload.POWER_TIER !== undefined) {
+    var tier = e.payload.POWER_TIER;
+    console.log('Power tier: ' + tier + ' (' + (POWER_TIER_NAMES[tier] || 'unknown') + ')');
+    var previous = readCache(POWER_TIER_CACHE_KEY);
+    writeCache(POWER_TIER_CACHE_KEY, { tier: tier, time: Date.now() });
+    if (!previous || previous.tier !== tier) {
+      scheduleBackstop();
+    }
+  }
 });
\ No newline at end of file
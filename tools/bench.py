@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+"""
+Microbenchmarks for the shared utilities.
+
+Builds tools/host/bench_main.c against an edition (tools/host_build.py) and
+times the helpers in shared/src/c/utilities that run on every tick or every
+AppMessage: format_date_string for each DateFormatType, from_string_to_tm,
+weather_module_update with its JSON extractors, weather_module_get_temperature
+and weather_module_get_icon_resource.
+
+  ns/op      fastest of --rounds timed rounds
+  allocs/op  heap calls per operation
+  bytes/op   heap bytes requested per operation
+
+Host timings only rank changes against each other; the watch is two orders
+of magnitude slower. Save a baseline before changing one of these helpers and
+compare after.
+
+Usage:
+  python tools/bench.py                          # standard-edition, basalt
+  python tools/bench.py --filter=weather --rounds=9
+  python tools/bench.py --save=/tmp/before       # keep a baseline, then change something and
+  python tools/bench.py --compare=/tmp/before    # print the ns/op change per case
+  HOST_LOCALE=fr_FR python tools/bench.py        # date names from another language table
+"""
+from __future__ import print_function
+
+import json
+import os
+import subprocess
+import sys
+
+import host_build
+
+DRIVER = os.path.join(host_build.HOST_DIR, 'bench_main.c')
+BASELINE_NAME = 'bench.json'
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def parse(output):
+    results = []
+    for line in output.splitlines():
+        parts = line.split()
+        if parts[:1] == ['bench']:
+            results.append({'name': parts[1], 'iterations': int(parts[2]), 'ns_per_op': float(parts[3]),
+                            'allocs_per_op': float(parts[4]), 'bytes_per_op': float(parts[5])})
+    return results
+
+
+def run(edition, platform, rounds, min_ms, filter_text):
+    binary = host_build.build(edition, platform, [DRIVER], name='bench')
+    cmd = [binary, '--rounds', str(rounds), '--min-ms', str(min_ms)]
+    if filter_text:
+        cmd += ['--filter', filter_text]
+    return parse(subprocess.check_output(cmd).decode())
+
+# ============================================================================
+# REPORT
+# ============================================================================
+
+def print_report(label, results, previous=None):
+    before = dict((result['name'], result) for result in previous or [])
+    print('%s: ns/op, allocs/op, bytes/op' % label)
+    width = max([len(result['name']) for result in results] + [0])
+    for result in results:
+        line = '  %-*s %9.1f %8.2f %8.1f' % (width, result['name'], result['ns_per_op'],
+                                            result['allocs_per_op'], result['bytes_per_op'])
+        old = before.get(result['name'])
+        if old and old['ns_per_op']:
+            change = (result['ns_per_op'] - old['ns_per_op']) / old['ns_per_op'] * 100
+            line += '   was %9.1f (%+.1f%%)' % (old['ns_per_op'], change)
+        print(line)
+
+
+def main(argv):
+    edition, platform = 'standard-edition', 'basalt'
+    rounds, min_ms, filter_text, save, compare = 5, 20, None, None, None
+    for arg in argv:
+        if arg in ('-h', '--help'):
+            return host_build.usage(__doc__)
+        elif arg.startswith('--platform='):
+            platform = arg.split('=', 1)[1]
+        elif arg.startswith('--rounds='):
+            rounds = int(arg.split('=', 1)[1])
+        elif arg.startswith('--min-ms='):
+            min_ms = int(arg.split('=', 1)[1])
+        elif arg.startswith('--filter='):
+            filter_text = arg.split('=', 1)[1]
+        elif arg.startswith('--save='):
+            save = arg.split('=', 1)[1]
+        elif arg.startswith('--compare='):
+            compare = arg.split('=', 1)[1]
+        elif host_build.edition_arg(arg):
+            edition = host_build.edition_arg(arg)
+        else:
+            return host_build.usage(__doc__, 'unknown argument: %s' % arg)
+
+    results = run(edition, platform, rounds, min_ms, filter_text)
+    previous = None
+    if compare:
+        with open(os.path.join(compare, BASELINE_NAME)) as f:
+            previous = json.load(f)
+    print_report('%s %s' % (edition, platform), results, previous)
+    if save:
+        if not os.path.isdir(save):
+            os.makedirs(save)
+        with open(os.path.join(save, BASELINE_NAME), 'w') as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,338 @@
+#!/usr/bin/env python
+"""
+Bitmap resource pipeline for Constellation.
+
+For every bitmap in an edition's package.json this quantises the source PNG
+into per-platform variants the Pebble SDK picks up through file tags:
+
+  name~bw.png     black / white / clear      (aplite, diorite, flint)
+  name~color.png  Pebble 64-colour palette with 2-bit alpha, so anti-aliased
+                  edges keep four levels   (basalt, chalk, emery, gabbro)
+
+With "memoryFormat": "Smallest" the SDK then stores each variant in the
+smallest format its palette allows (1Bit, 1BitPalette, 2BitPalette,
+4BitPalette or 8Bit). "storageFormat" is chosen per asset: raw pbi when it
+is no larger than the variant PNGs it replaces (no decode at load), png
+otherwise.
+
+Variants are written next to the sources (shared/resources is used by both
+editions), each through a temporary file and a rename so a reader never sees
+a partial PNG. build.sh generates them once for every edition before the
+parallel builds start and sets BITMAP_VARIANTS_READY=1, so the wscripts skip
+the step; a plain "pebble build" still runs it.
+
+Usage:
+  python tools/bitmap_pipeline.py <edition-dir> ...                 # generate + report
+  python tools/bitmap_pipeline.py <edition-dir> --update-manifest   # also write formats
+  python tools/bitmap_pipeline.py <edition-dir> ... --quiet         # generate only
+
+Pure Python (zlib + struct), runs under the SDK's interpreter without extra deps.
+"""
+from __future__ import print_function
+
+import json
+import os
+import struct
+import sys
+import zlib
+
+PLATFORM_GROUPS = {
+    'bw': ['aplite', 'diorite', 'flint'],
+    'color': ['basalt', 'chalk', 'emery', 'gabbro'],
+}
+VARIANT_TAGS = ['~bw', '~color']
+PEBBLE_LEVELS = (0x00, 0x55, 0xAA, 0xFF)
+ALPHA_THRESHOLD = 128
+BW_THRESHOLD = 128
+
+# ============================================================================
+# PNG I/O
+# ============================================================================
+
+def _paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """Returns (width, height, rows) where rows are lists of (r, g, b, a)."""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        raise ValueError('%s is not a PNG' % path)
+
+    pos, idat, plte, trns = 8, b'', None, None
+    width = height = depth = ctype = interlace = 0
+    while pos < len(data):
+        length, = struct.unpack('>I', data[pos:pos + 4])
+        kind = data[pos + 4:pos + 8]
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, ctype, _, _, interlace = struct.unpack('>IIBBBBB', chunk)
+        elif kind == b'PLTE':
+            plte = bytearray(chunk)
+        elif kind == b'tRNS':
+            trns = bytearray(chunk)
+        elif kind == b'IDAT':
+            idat += chunk
+    if interlace:
+        raise ValueError('%s: interlaced PNGs are not supported' % path)
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[ctype]
+    bpp = max(1, channels * depth // 8)
+    stride = (width * channels * depth + 7) // 8
+    raw = bytearray(zlib.decompress(idat))
+
+    rows, prev, i = [], bytearray(stride), 0
+    for _ in range(height):
+        ftype = raw[i]
+        line = raw[i + 1:i + 1 + stride]
+        i += 1 + stride
+        for x in range(stride):
+            a = line[x - bpp] if x >= bpp else 0
+            b = prev[x]
+            c = prev[x - bpp] if x >= bpp else 0
+            if ftype == 1:
+                line[x] = (line[x] + a) & 0xFF
+            elif ftype == 2:
+                line[x] = (line[x] + b) & 0xFF
+            elif ftype == 3:
+                line[x] = (line[x] + ((a + b) >> 1)) & 0xFF
+            elif ftype == 4:
+                line[x] = (line[x] + _paeth(a, b, c)) & 0xFF
+        rows.append(_unpack_row(line, width, ctype, depth, plte, trns))
+        prev = line
+    return width, height, rows
+
+
+def _samples(line, count, depth):
+    if depth == 8:
+        return list(line[:count])
+    if depth == 16:
+        return [line[2 * k] for k in range(count)]
+    per_byte = 8 // depth
+    mask = (1 << depth) - 1
+    out = []
+    for k in range(count):
+        byte = line[k // per_byte]
+        shift = 8 - depth * (k % per_byte + 1)
+        out.append((byte >> shift) & mask)
+    return out
+
+
+def _unpack_row(line, width, ctype, depth, plte, trns):
+    scale = 255 // ((1 << depth) - 1) if depth < 8 else 1
+    if ctype == 3:
+        pixels = []
+        for idx in _samples(line, width, depth):
+            alpha = trns[idx] if trns is not None and idx < len(trns) else 255
+            pixels.append((plte[3 * idx], plte[3 * idx + 1], plte[3 * idx + 2], alpha))
+        return pixels
+    channels = {0: 1, 2: 3, 4: 2, 6: 4}[ctype]
+    s = [v * scale for v in _samples(line, width * channels, depth)]
+    if ctype == 0:
+        return [(v, v, v, 255) for v in s]
+    if ctype == 4:
+        return [(s[2 * k], s[2 * k], s[2 * k], s[2 * k + 1]) for k in range(width)]
+    if ctype == 2:
+        return [(s[3 * k], s[3 * k + 1], s[3 * k + 2], 255) for k in range(width)]
+    return [tuple(s[4 * k:4 * k + 4]) for k in range(width)]
+
+
+def write_palette_png(path, width, height, rows):
+    """Writes an 8-bit palettised PNG (PLTE + tRNS) from RGBA rows; returns its size."""
+    palette, index = [], {}
+    raw = bytearray()
+    for row in rows:
+        raw.append(0)
+        for px in row:
+            if px not in index:
+                index[px] = len(palette)
+                palette.append(px)
+            raw.append(index[px])
+
+    def chunk(kind, body):
+        return (struct.pack('>I', len(body)) + kind + body +
+                struct.pack('>I', zlib.crc32(kind + body) & 0xFFFFFFFF))
+
+    plte = bytearray()
+    trns = bytearray()
+    for r, g, b, a in palette:
+        plte += bytearray((r, g, b))
+        trns.append(a)
+    out = b'\x89PNG\r\n\x1a\n'
+    out += chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 3, 0, 0, 0))
+    out += chunk(b'PLTE', bytes(plte))
+    if any(a != 255 for a in trns):
+        out += chunk(b'tRNS', bytes(trns))
+    out += chunk(b'IDAT', zlib.compress(bytes(raw), 9))
+    out += chunk(b'IEND', b'')
+
+    # Only touch the file when the content changed, so waf does not rebuild resources
+    if os.path.exists(path):
+        with open(path, 'rb') as f:
+            if f.read() == out:
+                return len(out)
+    temp = '%s.%d.tmp' % (path, os.getpid())
+    with open(temp, 'wb') as f:
+        f.write(out)
+    os.rename(temp, path)
+    return len(out)
+
+# ============================================================================
+# QUANTISATION
+# ============================================================================
+
+def _snap(value):
+    return min(PEBBLE_LEVELS, key=lambda level: abs(level - value))
+
+
+def quantise(rows, group):
+    """bw is on/off at ALPHA_THRESHOLD; colour keeps GColor8's four alpha levels."""
+    out = []
+    for row in rows:
+        qrow = []
+        for r, g, b, a in row:
+            if group == 'bw':
+                if a < ALPHA_THRESHOLD:
+                    qrow.append((0, 0, 0, 0))
+                    continue
+                v = 255 if (r * 299 + g * 587 + b * 114) // 1000 >= BW_THRESHOLD else 0
+                qrow.append((v, v, v, 255))
+            else:
+                alpha = _snap(a)
+                qrow.append((_snap(r), _snap(g), _snap(b), alpha) if alpha else (0, 0, 0, 0))
+        out.append(qrow)
+    return out
+
+
+def smallest_format(rows):
+    """Mirrors the SDK's 'Smallest' choice for a quantised image."""
+    colors = set(px for row in rows for px in row)
+    if colors <= set([(0, 0, 0, 255), (255, 255, 255, 255)]):
+        return '1Bit'
+    if len(colors) <= 2:
+        return '1BitPalette'
+    if len(colors) <= 4:
+        return '2BitPalette'
+    if len(colors) <= 16:
+        return '4BitPalette'
+    return '8Bit'
+
+
+FORMAT_BITS = {'1Bit': 1, '1BitPalette': 1, '2BitPalette': 2, '4BitPalette': 4, '8Bit': 8}
+
+
+def heap_bytes(width, height, fmt):
+    """Pixel data + palette bytes the firmware allocates for a GBitmap."""
+    bits = FORMAT_BITS[fmt]
+    if fmt == '1Bit':
+        row = ((width + 31) // 32) * 4  # word-aligned rows
+    else:
+        row = (width * bits + 7) // 8
+    palette = (1 << bits) if fmt.endswith('Palette') else 0
+    return row * height + palette
+
+# ============================================================================
+# MANIFEST
+# ============================================================================
+
+def resolve_source(edition, relpath):
+    for base in (os.path.join(edition, 'resources'),
+                 os.path.join(edition, '..', 'shared', 'resources')):
+        path = os.path.join(base, relpath)
+        if os.path.exists(path):
+            return os.path.normpath(path)
+    return None
+
+
+def variant_path(path, tag):
+    stem, ext = os.path.splitext(path)
+    return stem + tag + ext
+
+
+def bitmap_entries(manifest):
+    for entry in manifest['pebble']['resources']['media']:
+        if entry.get('type') == 'bitmap' and not entry.get('menuIcon'):
+            yield entry
+
+
+def process(edition, update_manifest=False, quiet=False):
+    manifest_path = os.path.join(edition, 'package.json')
+    with open(manifest_path) as f:
+        manifest = json.load(f)
+    targets = manifest['pebble'].get('targetPlatforms', [])
+
+    report = []
+    for entry in bitmap_entries(manifest):
+        source = resolve_source(edition, entry['file'])
+        if not source:
+            print('warning: %s not found, skipped' % entry['file'], file=sys.stderr)
+            continue
+        width, height, rows = read_png(source)
+
+        result = {'name': entry['name'], 'size': (width, height), 'groups': {}}
+        pbi_fits = True
+        for group, platforms in sorted(PLATFORM_GROUPS.items()):
+            if not any(p in targets for p in platforms):
+                continue
+            qrows = quantise(rows, group)
+            png_size = write_palette_png(variant_path(source, '~' + group), width, height, qrows)
+            fmt = smallest_format(qrows)
+            heap = heap_bytes(width, height, fmt)
+            result['groups'][group] = (fmt, heap, heap_bytes(width, height, '8Bit'))
+            # The variant is what gets packed, so that is the PNG pbi competes with
+            pbi_fits = pbi_fits and heap <= png_size
+
+        # Raw pbi skips PNG decode at load time; only worth it when it is not bigger
+        storage = 'pbi' if pbi_fits else 'png'
+        result['storage'] = storage
+        if update_manifest:
+            entry['memoryFormat'] = 'Smallest'
+            entry['storageFormat'] = storage
+        report.append(result)
+
+    if update_manifest:
+        with open(manifest_path, 'w') as f:
+            f.write(json.dumps(manifest, indent=2) + '\n')
+    if not quiet:
+        print_report(edition, report)
+    return report
+
+
+def print_report(edition, report):
+    print('Bitmap heap report: %s' % os.path.basename(os.path.abspath(edition)))
+    print('  %-36s %-8s %-8s %-24s %s' % ('resource', 'size', 'storage', 'bw', 'color'))
+    totals = {}
+    for r in report:
+        cols = []
+        for group in ('bw', 'color'):
+            if group in r['groups']:
+                fmt, heap, full = r['groups'][group]
+                totals[group] = totals.get(group, (0, 0))
+                totals[group] = (totals[group][0] + heap, totals[group][1] + full)
+                cols.append('%s %dB' % (fmt, heap))
+            else:
+                cols.append('-')
+        print('  %-36s %-8s %-8s %-24s %s' % (r['name'], '%dx%d' % r['size'], r['storage'],
+                                              cols[0], cols[1]))
+    for group, (heap, full) in sorted(totals.items()):
+        print('  total %-5s %6d B (vs %d B as 8Bit)' % (group, heap, full))
+
+
+def main(argv):
+    args = [a for a in argv if not a.startswith('--')]
+    if not args:
+        print(__doc__.strip())
+        return 1
+    for edition in args:
+        process(edition, update_manifest='--update-manifest' in argv, quiet='--quiet' in argv)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,275 @@
+#!/usr/bin/env python
+"""
+Emulator scenario runner for Constellation.
+
+Builds each edition with SCENARIO_LOG=1 (see wscript and
+utilities/scenario_log.h), installs it on the local QEMU emulator for every
+target platform and plays a scripted scenario against it: Clay settings and
+weather payloads pushed as AppMessages, wrist taps, battery changes and time
+jumps through the pebble tool, and screenshots. Nothing needs the network;
+messages go straight to the emulator's phone proxy.
+
+The face logs one "SCN <event> <ms> <heap used> <heap peak>" line per event,
+and the run reports per platform:
+
+  first frame  ms from prv_init to the first face frame drawn
+  moon view    ms from the tap to the first moon view frame (median)
+  heap face    heap in use once the face is up
+  heap peak    highest heap use seen at any frame or event
+
+Logs, screenshots and results.json go to <edition>/build/scenarios/<platform>/.
+The SCENARIO_LOG build is left installed; rebuild without it for daily use.
+
+Scenario files are JSON lists of steps, run in order:
+
+  {"wait": 2}                           seconds
+  {"wait_for": "moon_frame", "timeout": 20}
+  {"tap": "x+"}                         pebble emu-tap direction
+  {"battery": 15, "charging": false}    pebble emu-battery
+  {"time": "23:59:50"}                  pebble emu-set-time
+  {"config": {"SHOW_SECOND_TICKER": 1}} AppMessage as Clay sends it
+  {"message": {"WEATHER_DATA": "..."}}  any other AppMessage
+  {"screenshot": "face"}                <platform dir>/face.png
+
+Keys an edition does not define are dropped. Pushing messages needs
+libpebble2 (installed with the pebble tool; run this script with that
+Python, or pip install libpebble2).
+
+Usage:
+  python tools/emu_scenarios.py                         # both editions, every platform
+  python tools/emu_scenarios.py standard-edition --platform=basalt,aplite
+  python tools/emu_scenarios.py --no-build --scenario=my_scenario.json
+"""
+from __future__ import print_function
+
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+import uuid
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+EDITIONS = ['standard-edition', 'chronomark-edition']
+DEFAULT_SCENARIO = os.path.join(ROOT, 'tools', 'scenarios', 'default.json')
+SCN_LINE = re.compile(r'SCN (\w+) (\d+) (\d+) (\d+)')
+FIRST_MESSAGE_KEY = 10000
+
+# ============================================================================
+# BUILD
+# ============================================================================
+
+def manifest(edition):
+    with open(os.path.join(ROOT, edition, 'package.json')) as f:
+        return json.load(f)['pebble']
+
+
+def build(edition):
+    env = dict(os.environ, SCENARIO_LOG='1')
+    cwd = os.path.join(ROOT, edition)
+    # Defines are picked up at configure time, so start clean
+    subprocess.check_call(['pebble', 'clean'], cwd=cwd, env=env)
+    subprocess.check_call(['pebble', 'build'], cwd=cwd, env=env)
+
+
+def message_keys(edition, pebble):
+    """Key name -> id, from the build when it wrote them out."""
+    path = os.path.join(ROOT, edition, 'build', 'js', 'message_keys.json')
+    if os.path.isfile(path):
+        with open(path) as f:
+            return json.load(f)
+    return dict((name, FIRST_MESSAGE_KEY + i) for i, name in enumerate(pebble.get('messageKeys', [])))
+
+# ============================================================================
+# EMULATOR
+# ============================================================================
+
+class Emulator(object):
+    def __init__(self, edition, platform, out_dir):
+        self.edition = edition
+        self.platform = platform
+        self.out_dir = out_dir
+        self.pebble = manifest(edition)
+        self.keys = message_keys(edition, self.pebble)
+        self.log_path = os.path.join(out_dir, 'log.txt')
+        self.logs = None
+        self.connection = None
+        self.appmessage = None
+        self.cursor = 0
+
+    def pebble_tool(self, *args):
+        subprocess.check_call(['pebble'] + list(args) + ['--emulator', self.platform],
+                              cwd=os.path.join(ROOT, self.edition))
+
+    def start(self):
+        # install --logs keeps streaming, so the launch lines are captured too
+        log = open(self.log_path, 'w')
+        self.logs = subprocess.Popen(['pebble', 'install', '--emulator', self.platform, '--logs'],
+                                     cwd=os.path.join(ROOT, self.edition), stdout=log,
+                                     stderr=subprocess.STDOUT)
+        log.close()
+
+    def stop(self):
+        if self.connection:
+            try:
+                self.appmessage.shutdown()
+                self.connection.transport.ws.close()
+            except Exception:
+                pass
+        if self.logs:
+            self.logs.terminate()
+            self.logs.wait()
+        subprocess.call(['pebble', 'kill'])
+
+    def events(self):
+        with open(self.log_path) as f:
+            return [(m.group(1), int(m.group(2)), int(m.group(3)), int(m.group(4)))
+                    for m in SCN_LINE.finditer(f.read())]
+
+    def wait_for(self, event, timeout):
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            events = self.events()
+            for i in range(self.cursor, len(events)):
+                if events[i][0] == event:
+                    self.cursor = i + 1
+                    return True
+            if self.logs.poll() is not None:
+                break
+            time.sleep(0.2)
+        print('  %s: no "%s" within %ds' % (self.platform, event, timeout), file=sys.stderr)
+        return False
+
+    def _connect(self):
+        try:
+            from libpebble2.communication import PebbleConnection
+            from libpebble2.communication.transports.websocket import WebsocketTransport
+            from libpebble2.services.appmessage import AppMessageService
+        except ImportError:
+            raise SystemExit('emu_scenarios: libpebble2 is needed to push messages '
+                             '(run with the pebble tool\'s Python, or pip install libpebble2)')
+        with open(os.path.join(tempfile.gettempdir(), 'pb-emulator.json')) as f:
+            info = json.load(f)[self.platform]
+        port = list(info.values())[0]['pypkjs']['port']
+        self.connection = PebbleConnection(WebsocketTransport('ws://localhost:%d/' % port))
+        self.connection.connect()
+        self.connection.run_async()
+        self.appmessage = AppMessageService(self.connection)
+
+    def send(self, payload):
+        if not self.connection:
+            self._connect()
+        from libpebble2.services.appmessage import CString, Int32
+        dictionary = {}
+        for name, value in sorted(payload.items()):
+            if name in self.keys:
+                if isinstance(value, bool) or isinstance(value, int):
+                    dictionary[self.keys[name]] = Int32(int(value))
+                else:
+                    dictionary[self.keys[name]] = CString(value if isinstance(value, str) else json.dumps(value))
+        self.appmessage.send_message(uuid.UUID(self.pebble['uuid']), dictionary)
+
+    def step(self, step):
+        if 'wait' in step:
+            time.sleep(step['wait'])
+        elif 'wait_for' in step:
+            self.wait_for(step['wait_for'], step.get('timeout', 20))
+        elif 'tap' in step:
+            self.pebble_tool('emu-tap', '--direction', step['tap'])
+        elif 'battery' in step:
+            args = ['emu-battery', '--percent', str(step['battery'])]
+            self.pebble_tool(*(args + (['--charging'] if step.get('charging') else [])))
+        elif 'time' in step:
+            self.pebble_tool('emu-set-time', str(step['time']))
+        elif 'config' in step:
+            self.send(step['config'])
+        elif 'message' in step:
+            self.send(step['message'])
+        elif 'screenshot' in step:
+            self.pebble_tool('screenshot', '--no-open', os.path.join(self.out_dir, step['screenshot'] + '.png'))
+        else:
+            raise SystemExit('emu_scenarios: unknown step %s' % json.dumps(step))
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def summarise(events):
+    result = {'first_frame_ms': None, 'moon_view_ms': None, 'heap_face': None, 'heap_peak': None}
+    shown = None
+    moon = []
+    for event, ms, used, peak in events:
+        if event == 'face_frame' and result['first_frame_ms'] is None:
+            result['first_frame_ms'], result['heap_face'] = ms, used
+        elif event == 'moon_show':
+            shown = ms
+        elif event == 'moon_frame' and shown is not None:
+            moon.append(ms - shown)
+            shown = None
+        result['heap_peak'] = max(result['heap_peak'] or 0, peak)
+    if moon:
+        result['moon_view_ms'] = sorted(moon)[len(moon) // 2]
+    result['moon_views'] = len(moon)
+    return result
+
+
+def run(edition, platform, scenario):
+    out_dir = os.path.join(ROOT, edition, 'build', 'scenarios', platform)
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+    emulator = Emulator(edition, platform, out_dir)
+    emulator.start()
+    try:
+        if emulator.wait_for('launch', 180):
+            for step in scenario:
+                emulator.step(step)
+    finally:
+        emulator.stop()
+    result = summarise(emulator.events())
+    with open(os.path.join(out_dir, 'results.json'), 'w') as f:
+        json.dump(result, f, indent=2, sort_keys=True)
+    return result
+
+
+def print_table(rows):
+    def cell(value, unit=''):
+        return '-' if value is None else '%d%s' % (value, unit)
+    print('  %-20s %-8s %12s %10s %10s %10s' % ('edition', 'platform', 'first frame', 'moon view',
+                                               'heap face', 'heap peak'))
+    for edition, platform, result in rows:
+        print('  %-20s %-8s %12s %10s %10s %10s' % (
+            edition, platform, cell(result['first_frame_ms'], ' ms'), cell(result['moon_view_ms'], ' ms'),
+            cell(result['heap_face'], ' B'), cell(result['heap_peak'], ' B')))
+
+
+def main(argv):
+    editions, platforms, scenario_path, do_build = [], None, DEFAULT_SCENARIO, True
+    for arg in argv:
+        if arg.startswith('--platform='):
+            platforms = arg.split('=', 1)[1].split(',')
+        elif arg.startswith('--scenario='):
+            scenario_path = arg.split('=', 1)[1]
+        elif arg == '--no-build':
+            do_build = False
+        else:
+            editions.append(os.path.basename(os.path.normpath(arg)))
+    with open(scenario_path) as f:
+        scenario = json.load(f)
+
+    rows = []
+    for edition in editions or EDITIONS:
+        if do_build:
+            build(edition)
+        for platform in manifest(edition)['targetPlatforms']:
+            if platforms and platform not in platforms:
+                continue
+            print('%s %s: running %s' % (edition, platform, os.path.basename(scenario_path)))
+            rows.append((edition, platform, run(edition, platform, scenario)))
+    print_table(rows)
+    return 0 if all(r['first_frame_ms'] is not None for _, _, r in rows) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,276 @@
+#!/usr/bin/env python
+"""
+Footprint report for Constellation.
+
+For every edition and target platform this reads the built
+build/<platform>/pebble-app.elf and reports:
+
+  text / data / bss   loaded into app RAM, shared with the heap
+  ram                 text + data + bss
+  top functions       largest symbols from .symtab
+  resources           size of build/<platform>/app_resources.pbpack
+  bitmap_heap         decoded heap cost of the bitmaps that can be loaded at
+                      once (tools/bitmap_pipeline.py); of the splash/center
+                      logos and of the weather icons only the largest counts
+
+ram, resources and bitmap_heap are compared against
+tools/footprint_budget.json; text, data and bss are their breakdown and are
+only reported. Anything over budget, or a budgeted metric that could not be
+measured (no build yet), makes the script exit non-zero.
+
+Budgets start from the platform: resources at the resource pack ceiling, ram
+at the app RAM left once the bitmap heap budget and HEAP_RESERVE are taken
+out. --update-budget records what was measured (missing metrics keep their
+budget, or get the platform default), so after a build it pins ram and
+resources to the current size and any code growth is flagged.
+
+Usage:
+  python tools/footprint.py [edition ...]                 # report + compare
+  python tools/footprint.py [edition ...] --update-budget # record current values
+  python tools/footprint.py --top=20                      # more functions
+
+Pure Python ELF reader, no binutils needed.
+"""
+from __future__ import print_function
+
+import json
+import os
+import struct
+import sys
+
+import bitmap_pipeline
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+BUDGET_PATH = os.path.join(ROOT, 'tools', 'footprint_budget.json')
+EDITIONS = ['standard-edition', 'chronomark-edition']
+METRICS = ['text', 'data', 'bss', 'ram', 'resources', 'bitmap_heap']
+BUDGETED = ['ram', 'resources', 'bitmap_heap']
+DEFAULT_TOP = 10
+
+# App RAM per platform; code, data and bss come out of it before the heap
+APP_RAM = {'aplite': 24 * 1024, 'basalt': 64 * 1024, 'chalk': 64 * 1024, 'diorite': 64 * 1024,
+           'emery': 128 * 1024, 'flint': 64 * 1024, 'gabbro': 128 * 1024}
+# Largest resource pack the SDK will install
+RESOURCE_LIMIT = {'aplite': 96 * 1024, 'basalt': 256 * 1024, 'chalk': 256 * 1024, 'diorite': 256 * 1024,
+                  'emery': 256 * 1024, 'flint': 256 * 1024, 'gabbro': 256 * 1024}
+HEAP_RESERVE = 4 * 1024         # layers, text buffers and timers besides bitmaps
+
+# Bitmaps of which at most one is loaded at a time, and ones the app never loads
+EXCLUSIVE = [('logo', lambda name: name.endswith('_LOGO_IMAGE')),
+             ('weather icon', lambda name: name.startswith('WEATHER_'))]
+NOT_LOADED = ['MENU_ICON']
+
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+# ============================================================================
+# ELF
+# ============================================================================
+
+def _sections(data):
+    if data[:4] != b'\x7fELF' or data[4:5] != b'\x01':
+        raise ValueError('not a 32-bit ELF file')
+    shoff, = struct.unpack_from('<I', data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x2E)
+    sections = []
+    for i in range(shnum):
+        fields = struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize)
+        sections.append(dict(zip(('name', 'type', 'flags', 'addr', 'offset', 'size',
+                                  'link', 'info', 'align', 'entsize'), fields)))
+    names = sections[shstrndx]
+    for s in sections:
+        s['name'] = _cstr(data, names['offset'] + s['name'])
+    return sections
+
+
+def _cstr(data, offset):
+    end = data.index(b'\x00', offset)
+    return data[offset:end].decode('ascii', 'replace')
+
+
+def elf_sizes(data, sections):
+    """Berkeley-style totals, the same split arm-none-eabi-size prints."""
+    text = dat = bss = 0
+    for s in sections:
+        if not s['flags'] & SHF_ALLOC:
+            continue
+        if s['type'] == SHT_NOBITS:
+            bss += s['size']
+        elif s['flags'] & SHF_WRITE:
+            dat += s['size']
+        else:
+            text += s['size']
+    return {'text': text, 'data': dat, 'bss': bss, 'ram': text + dat + bss}
+
+
+def elf_functions(data, sections):
+    symbols = {}
+    for s in sections:
+        if s['type'] != SHT_SYMTAB:
+            continue
+        strtab = sections[s['link']]
+        for off in range(s['offset'], s['offset'] + s['size'], s['entsize']):
+            name, _, size, info, _, _ = struct.unpack_from('<IIIBBH', data, off)
+            if info & 0xF == STT_FUNC and size:
+                label = _cstr(data, strtab['offset'] + name)
+                symbols[label] = max(size, symbols.get(label, 0))
+    return sorted(symbols.items(), key=lambda item: -item[1])
+
+# ============================================================================
+# MEASURE
+# ============================================================================
+
+def measure(edition):
+    edition_dir = os.path.join(ROOT, edition)
+    with open(os.path.join(edition_dir, 'package.json')) as f:
+        targets = json.load(f)['pebble'].get('targetPlatforms', [])
+    bitmaps = bitmap_pipeline.process(edition_dir, quiet=True)
+
+    results = {}
+    for platform in targets:
+        build = os.path.join(edition_dir, 'build', platform)
+        row = dict((m, None) for m in METRICS)
+        row['functions'] = []
+
+        elf = os.path.join(build, 'pebble-app.elf')
+        if os.path.exists(elf):
+            with open(elf, 'rb') as f:
+                data = f.read()
+            sections = _sections(data)
+            row.update(elf_sizes(data, sections))
+            row['functions'] = elf_functions(data, sections)
+
+        pbpack = os.path.join(build, 'app_resources.pbpack')
+        if os.path.exists(pbpack):
+            row['resources'] = os.path.getsize(pbpack)
+
+        group = next(g for g, ps in bitmap_pipeline.PLATFORM_GROUPS.items() if platform in ps)
+        row['bitmaps'] = [(b['name'],) + b['groups'][group][:2] for b in bitmaps
+                          if b['name'] not in NOT_LOADED]
+        row['bitmap_heap'] = peak_bitmap_heap(row['bitmaps'])
+        results[platform] = row
+    return results
+
+
+def exclusive_group(name):
+    for label, member in EXCLUSIVE:
+        if member(name):
+            return label
+    return None
+
+
+def peak_bitmap_heap(bitmaps):
+    """Every bitmap once, except that each exclusive group counts its largest only."""
+    total, largest = 0, {}
+    for name, _, heap in bitmaps:
+        label = exclusive_group(name)
+        if label:
+            largest[label] = max(heap, largest.get(label, 0))
+        else:
+            total += heap
+    return total + sum(largest.values())
+
+
+def default_budget(platform, bitmap_heap):
+    return {'ram': APP_RAM[platform] - bitmap_heap - HEAP_RESERVE,
+            'resources': RESOURCE_LIMIT[platform],
+            'bitmap_heap': bitmap_heap}
+
+# ============================================================================
+# REPORT
+# ============================================================================
+
+def _fmt(value):
+    return '-' if value is None else str(value)
+
+
+def compare(edition, results, budget, top):
+    regressions = []
+    print('Footprint report: %s' % edition)
+    for platform, row in sorted(results.items()):
+        limits = budget.get(edition, {}).get(platform, {})
+        print('  %s' % platform)
+        print('    %-12s %10s %10s' % ('metric', 'current', 'budget'))
+        for metric in METRICS:
+            value, limit = row[metric], limits.get(metric)
+            flag = ''
+            if metric in BUDGETED and limit is None:
+                flag = '  NO BUDGET'
+                regressions.append('%s/%s %s has no budget' % (edition, platform, metric))
+            elif metric in BUDGETED and value is None:
+                flag = '  NOT MEASURED'
+                regressions.append('%s/%s %s not measured' % (edition, platform, metric))
+            elif metric in BUDGETED and value > limit:
+                flag = '  REGRESSION +%d B' % (value - limit)
+                regressions.append('%s/%s %s' % (edition, platform, metric))
+            print('    %-12s %10s %10s%s' % (metric, _fmt(value), _fmt(limit), flag))
+
+        if row['functions']:
+            print('    largest functions:')
+            for name, size in row['functions'][:top]:
+                print('      %6d  %s' % (size, name))
+        print('    bitmap heap:')
+        for name, fmt, heap in sorted(row['bitmaps'], key=lambda b: -b[2]):
+            label = exclusive_group(name)
+            print('      %6d  %-12s %s%s' % (heap, fmt, name, ' (one %s at a time)' % label if label else ''))
+        if row['text'] is None:
+            print('    (no pebble-app.elf, run ./build.sh first)')
+    print('')
+    return regressions
+
+
+def update_budget(budget, edition, results):
+    for platform, row in results.items():
+        old = budget.setdefault(edition, {}).get(platform, {})
+        defaults = default_budget(platform, row['bitmap_heap'])
+        limits = {}
+        for metric in BUDGETED:
+            if row[metric] is not None:
+                limits[metric] = row[metric]
+            elif old.get(metric) is not None:
+                limits[metric] = old[metric]
+            else:
+                limits[metric] = defaults[metric]
+        budget[edition][platform] = limits
+
+
+def main(argv):
+    editions = [a for a in argv if not a.startswith('--')] or EDITIONS
+    top = DEFAULT_TOP
+    for arg in argv:
+        if arg.startswith('--top='):
+            top = int(arg.split('=', 1)[1])
+
+    budget = {}
+    if os.path.exists(BUDGET_PATH):
+        with open(BUDGET_PATH) as f:
+            budget = json.load(f)
+
+    regressions = []
+    for edition in editions:
+        edition = os.path.basename(os.path.normpath(edition))
+        results = measure(edition)
+        regressions += compare(edition, results, budget, top)
+        if '--update-budget' in argv:
+            update_budget(budget, edition, results)
+
+    if '--update-budget' in argv:
+        with open(BUDGET_PATH, 'w') as f:
+            f.write(json.dumps(budget, indent=2, sort_keys=True) + '\n')
+        print('Budget written to %s' % os.path.relpath(BUDGET_PATH, ROOT))
+        return 0
+
+    if regressions:
+        print('Over budget or not measured:')
+        for r in regressions:
+            print('  %s' % r)
+        return 1
+    print('All metrics within budget.')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,140 @@
+#!/usr/bin/env python
+"""
+Fuzzer for the shared utilities' JSON and date paths.
+
+Builds tools/host/fuzz_main.c against an edition with AddressSanitizer and
+UndefinedBehaviorSanitizer (tools/host_build.py) and feeds weather payloads
+through weather_module_update, from_string_to_tm and the icon / temperature
+lookups, and header bytes through format_date_string with small buffers.
+Every buffer is allocated at its exact size, so an overread or overrun stops
+the run with the sanitizer report and the input is kept under
+
+  <edition>/build/fuzz/crash-<hash>
+
+Engines:
+  default      built-in mutator over the seed payloads in fuzz_main.c
+  --afl        afl-fuzz with afl-clang-fast / afl-gcc, seeds as the corpus
+  --libfuzzer  clang -fsanitize=fuzzer, corpus in <edition>/build/fuzz/corpus
+
+Usage:
+  python tools/fuzz.py                          # 100000 inputs, standard-edition
+  python tools/fuzz.py --runs=2000000 --seed=7
+  python tools/fuzz.py <edition>/build/fuzz/crash-1a2b3c4d   # replay saved inputs
+  python tools/fuzz.py --afl                    # runs until stopped
+  python tools/fuzz.py --libfuzzer -- -max_total_time=600
+
+Exits non-zero when the sanitizer reports an error.
+"""
+from __future__ import print_function
+
+import os
+import subprocess
+import sys
+
+import host_build
+
+ROOT = host_build.ROOT
+DRIVER = os.path.join(host_build.HOST_DIR, 'fuzz_main.c')
+SANITIZE = ['-fsanitize=address,undefined', '-fno-omit-frame-pointer', '-fno-sanitize-recover=undefined']
+AFL_COMPILERS = ['afl-clang-fast', 'afl-gcc']
+
+# ============================================================================
+# BUILD
+# ============================================================================
+
+def _find(program):
+    for directory in os.environ.get('PATH', '').split(os.pathsep):
+        path = os.path.join(directory, program)
+        if os.path.isfile(path) and os.access(path, os.X_OK):
+            return path
+    return None
+
+
+def build(edition, platform, engine):
+    defines = list(SANITIZE)
+    compiler = None
+    if engine == 'afl':
+        compiler = next((c for c in AFL_COMPILERS if _find(c)), None)
+        if not compiler or not _find('afl-fuzz'):
+            raise SystemExit('fuzz: afl-fuzz and one of %s are needed for --afl' % ', '.join(AFL_COMPILERS))
+    elif engine == 'libfuzzer':
+        compiler = 'clang'
+        defines = ['-fsanitize=fuzzer,address,undefined', '-fno-omit-frame-pointer', '-DHOST_LIBFUZZER']
+        if not _find(compiler):
+            raise SystemExit('fuzz: clang is needed for --libfuzzer')
+
+    saved = os.environ.get('CC')
+    if compiler:
+        os.environ['CC'] = compiler
+    try:
+        return host_build.build(edition, platform, [DRIVER], defines=defines, name='fuzz-' + engine)
+    finally:
+        if saved is None:
+            os.environ.pop('CC', None)
+        else:
+            os.environ['CC'] = saved
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def sanitizer_env():
+    env = dict(os.environ)
+    # Abort so fuzz_main.c's signal handler can keep the input
+    env.setdefault('ASAN_OPTIONS', 'abort_on_error=1')
+    env.setdefault('UBSAN_OPTIONS', 'abort_on_error=1:print_stacktrace=1')
+    return env
+
+
+def main(argv):
+    edition, platform, engine = 'standard-edition', 'basalt', 'builtin'
+    runs, seed, files, passthrough = 100000, 1, [], []
+    for i, arg in enumerate(argv):
+        if arg == '--':
+            passthrough = argv[i + 1:]
+            break
+        if arg in ('-h', '--help'):
+            return host_build.usage(__doc__)
+        elif arg.startswith('--platform='):
+            platform = arg.split('=', 1)[1]
+        elif arg.startswith('--runs='):
+            runs = int(arg.split('=', 1)[1])
+        elif arg.startswith('--seed='):
+            seed = int(arg.split('=', 1)[1])
+        elif arg == '--afl':
+            engine = 'afl'
+        elif arg == '--libfuzzer':
+            engine = 'libfuzzer'
+        elif os.path.isfile(arg):
+            files.append(os.path.abspath(arg))
+        elif host_build.edition_arg(arg):
+            edition = host_build.edition_arg(arg)
+        else:
+            return host_build.usage(__doc__, 'unknown argument: %s' % arg)
+
+    binary = build(edition, platform, engine)
+    out_dir = os.path.join(ROOT, edition, 'build', 'fuzz')
+    corpus = os.path.join(out_dir, 'corpus')
+    for path in (out_dir, corpus):
+        if not os.path.isdir(path):
+            os.makedirs(path)
+    env = sanitizer_env()
+
+    if engine != 'builtin':
+        subprocess.check_call([binary, '--write-seeds', corpus], env=env)
+    if engine == 'afl':
+        cmd = ['afl-fuzz', '-m', 'none', '-i', corpus, '-o', os.path.join(out_dir, 'afl')] + passthrough
+        cmd += ['--', binary, '--artifacts', out_dir, '@@']
+    elif engine == 'libfuzzer':
+        cmd = [binary, corpus, '-artifact_prefix=' + out_dir + os.sep] + passthrough
+    else:
+        cmd = [binary, '--runs', str(runs), '--seed', str(seed), '--artifacts', out_dir] + files
+    status = subprocess.call(cmd, env=env)
+    if status:
+        print('fuzz: failed (status %d); inputs are kept in %s' % (status, out_dir), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
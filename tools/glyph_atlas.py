@@ -0,0 +1,87 @@
+#!/usr/bin/env python
+"""
+AM/PM badge atlas generator for Constellation.
+
+Draws the strip used by time_display_module: four 14x8 cells holding the
+active AM, inactive AM, active PM and inactive PM badges, pixel for pixel
+the four separate bitmaps they replace. Active badges are white with black
+lettering, inactive ones dark grey with black lettering, so the bitmap
+pipeline stores the strip as 2BitPalette.
+
+The digits are not part of the atlas: the time stays a text layer in the
+LECO system font, whose outlines are not available outside the firmware.
+
+Usage:
+  python tools/glyph_atlas.py [edition ...]    # writes <edition>/resources/ampm_badges.png
+"""
+from __future__ import print_function
+
+import os
+import sys
+
+import bitmap_pipeline
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+EDITIONS = ['standard-edition', 'chronomark-edition']
+OUTPUT = 'ampm_badges.png'
+
+BLACK = (0, 0, 0, 255)
+WHITE = (255, 255, 255, 255)
+INACTIVE = (67, 67, 79, 255)
+
+# 14x8 badges, '#' badge colour, '.' black lettering
+BADGES = {
+    'AM': ['##############',
+           '###..###.##.##',
+           '##.##.##....##',
+           '##.##.##.##.##',
+           '##....##.##.##',
+           '##.##.##.##.##',
+           '##.##.##.##.##',
+           '##############'],
+    'PM': ['##############',
+           '##...###.##.##',
+           '##.##.##....##',
+           '##.##.##.##.##',
+           '##...###.##.##',
+           '##.#####.##.##',
+           '##.#####.##.##',
+           '##############'],
+}
+BADGE_WIDTH = 14
+BADGE_HEIGHT = 8
+
+# Cell order must match time_display_module.c
+CELLS = [('AM', WHITE), ('AM', INACTIVE), ('PM', WHITE), ('PM', INACTIVE)]
+
+# ============================================================================
+# DRAWING
+# ============================================================================
+
+def draw_badge(rows, ox, pattern, color):
+    for y, line in enumerate(pattern):
+        for x, ch in enumerate(line):
+            rows[y][ox + x] = color if ch == '#' else BLACK
+
+
+def build():
+    width, height = BADGE_WIDTH * len(CELLS), BADGE_HEIGHT
+    rows = [[BLACK] * width for _ in range(height)]
+    for i, (name, color) in enumerate(CELLS):
+        draw_badge(rows, i * BADGE_WIDTH, BADGES[name], color)
+    return width, height, rows
+
+
+def main(argv):
+    editions = argv or EDITIONS
+    width, height, rows = build()
+    for edition in editions:
+        edition = os.path.basename(os.path.normpath(edition))
+        path = os.path.join(ROOT, edition, 'resources', OUTPUT)
+        bitmap_pipeline.write_palette_png(path, width, height, rows)
+        print('%s: %dx%d' % (os.path.relpath(path, ROOT), width, height))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,162 @@
+#!/usr/bin/env python
+"""
+Heap fragmentation forecast for Constellation.
+
+Builds each edition for the host (tools/host_build.py) with the watch heap
+model in tools/host/heap_model.c: first fit, 8-byte headers and alignment,
+free blocks merged, sized like the platform's app heap. tools/host/heap_main.c
+then replays a long session of the allocations that churn the heap: moon view
+open/close, weather icon swaps and a settings toggle that rebuilds part of
+the face (center logo on Chronomark, the step tracker on Standard).
+
+The heap is app RAM minus the app's text + data + bss, read from
+build/<platform>/pebble-app.elf when the edition has been built, otherwise
+estimated. Per platform the report shows the largest free block over time
+(lowest per day), failed allocations, and which bitmaps would no longer fit
+in the largest free block at the worst point of the session, splash logos
+and moon view background included.
+
+Usage:
+  python tools/heap_model.py [edition ...]                # every target platform, 7 days
+  python tools/heap_model.py --platform=aplite --days=28
+  python tools/heap_model.py --taps-per-day=100 --toggle=SHOW_WEATHER
+  python tools/heap_model.py --heap=20000                 # override the heap size
+"""
+from __future__ import print_function
+
+import json
+import os
+import subprocess
+import sys
+
+import footprint
+import host_build
+import power_model
+
+ROOT = host_build.ROOT
+DRIVER = os.path.join(host_build.HOST_DIR, 'heap_main.c')
+MODEL = os.path.join(host_build.HOST_DIR, 'heap_model.c')
+EDITIONS = ['standard-edition', 'chronomark-edition']
+DEFAULT_TOGGLES = {'standard-edition': 'SHOW_STEP_TRACKER', 'chronomark-edition': 'USE_CENTER_LOGO'}
+
+APP_RAM = footprint.APP_RAM
+STATIC_ESTIMATE = 12 * 1024     # when no pebble-app.elf has been built yet
+
+# ============================================================================
+# HEAP SIZE
+# ============================================================================
+
+def heap_size(edition, platform):
+    """(bytes, how the static part was found)"""
+    elf = os.path.join(ROOT, edition, 'build', platform, 'pebble-app.elf')
+    if os.path.exists(elf):
+        with open(elf, 'rb') as f:
+            data = f.read()
+        static = footprint.elf_sizes(data, footprint._sections(data))['ram']
+        return APP_RAM[platform] - static, 'static %d B from pebble-app.elf' % static
+    return APP_RAM[platform] - STATIC_ESTIMATE, 'static %d B estimated' % STATIC_ESTIMATE
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def run(edition, platform, heap, args):
+    toggle = args['toggle'] or DEFAULT_TOGGLES[edition]
+    binary = host_build.build(edition, platform, [DRIVER], extra_sources=[MODEL],
+                              defines=['-DHOST_HEAP_MODEL=1', '-DHOST_HEAP_SIZE=%d' % heap],
+                              name='heap')
+    pairs = ['%s=%d' % (key, int(value)) for key, value in power_model.toggles(edition) if key != toggle]
+    cmd = [binary, '--days', str(args['days']), '--taps-per-day', str(args['taps_per_day']),
+           '--weather-minutes', str(args['weather_minutes']), '--config-hours', str(args['config_hours']),
+           '--toggle', toggle] + pairs
+    result = {'toggle': toggle, 'resources': [], 'samples': [], 'summary': None}
+    for line in subprocess.check_output(cmd).decode().splitlines():
+        parts = line.split()
+        if parts[:1] == ['resource']:
+            result['resources'].append((parts[1], int(parts[2])))
+        elif parts[:1] == ['sample']:
+            result['samples'].append([int(v) for v in parts[1:]])
+        elif parts[:1] == ['summary']:
+            keys = ['size', 'peak', 'min_largest', 'failures', 'largest_failure', 'allocations']
+            result['summary'] = dict(zip(keys, [int(v) for v in parts[1:]]))
+    return result
+
+# ============================================================================
+# REPORT
+# ============================================================================
+
+def print_report(edition, platform, note, result, days):
+    s = result['summary']
+    print('%s %s: heap %d B (%s), %d days, toggling %s' % (edition, platform, s['size'], note, days,
+                                                          result['toggle']))
+    print('  peak use %d B, %d allocations, %d failed%s' % (
+        s['peak'], s['allocations'], s['failures'],
+        ' (largest %d B)' % s['largest_failure'] if s['failures'] else ''))
+
+    print('  %-5s %8s %14s %12s' % ('day', 'used', 'largest free', 'free blocks'))
+    by_day = {}
+    for minute, used, largest, blocks, _ in result['samples']:
+        day = by_day.setdefault(minute // (24 * 60), [0, None, 0])
+        day[0] = max(day[0], used)
+        day[1] = largest if day[1] is None else min(day[1], largest)
+        day[2] = max(day[2], blocks)
+    for day in sorted(by_day):
+        used, largest, blocks = by_day[day]
+        print('  %-5d %8d %14d %12d' % (day, used, largest, blocks))
+    print('  lowest largest free block: %d B' % s['min_largest'])
+
+    misfits = [(name, size) for name, size in result['resources'] if size > s['min_largest']]
+    if misfits:
+        print('  no longer fit at the worst point:')
+        for name, size in sorted(misfits, key=lambda r: -r[1]):
+            print('    %6d B  %s' % (size, name))
+    else:
+        largest_name, largest_size = max(result['resources'], key=lambda r: r[1])
+        print('  every bitmap still fits (largest: %s, %d B)' % (largest_name, largest_size))
+
+
+def main(argv):
+    args = {'platforms': None, 'days': 7, 'taps_per_day': 24, 'weather_minutes': 30, 'config_hours': 12,
+            'toggle': None, 'heap': None}
+    editions = []
+    for arg in argv:
+        if arg in ('-h', '--help'):
+            return host_build.usage(__doc__)
+        elif arg.startswith('--platform='):
+            args['platforms'] = arg.split('=', 1)[1].split(',')
+        elif arg.startswith('--days='):
+            args['days'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--taps-per-day='):
+            args['taps_per_day'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--weather-minutes='):
+            args['weather_minutes'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--config-hours='):
+            args['config_hours'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--toggle='):
+            args['toggle'] = arg.split('=', 1)[1]
+        elif arg.startswith('--heap='):
+            args['heap'] = int(arg.split('=', 1)[1])
+        elif host_build.edition_arg(arg):
+            editions.append(host_build.edition_arg(arg))
+        else:
+            return host_build.usage(__doc__, 'unknown argument: %s' % arg)
+
+    status = 0
+    for edition in editions or EDITIONS:
+        with open(os.path.join(ROOT, edition, 'package.json')) as f:
+            targets = json.load(f)['pebble']['targetPlatforms']
+        for platform in targets:
+            if args['platforms'] and platform not in args['platforms']:
+                continue
+            heap, note = heap_size(edition, platform)
+            if args['heap']:
+                heap, note = args['heap'], 'from --heap'
+            result = run(edition, platform, heap, args)
+            print_report(edition, platform, note, result, args['days'])
+            if result['summary']['failures']:
+                status = 1
+    return status
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,222 @@
+#include <time.h>
+
+#include "host.h"
+#include "utilities/date_format.h"
+#include "utilities/weather.h"
+
+// Utilities microbenchmark
+//
+// Times the pure-C helpers in shared/src/c/utilities that run on every tick
+// or every AppMessage: format_date_string for each DateFormatType,
+// from_string_to_tm, weather_module_update (and through it the JSON
+// extractors), weather_module_get_temperature and
+// weather_module_get_icon_resource. Every case is repeated --rounds times
+// and the fastest round is kept, which is the most stable figure on a busy
+// machine. Heap calls that reach malloc/calloc/realloc are counted by the
+// wrappers below (glibc's internal allocations bypass them). Report on stdout for tools/bench.py:
+//
+//   bench <name> <iterations> <ns/op> <allocs/op> <bytes/op>
+//
+// Usage: bench [--rounds N] [--min-ms N] [--filter SUBSTRING]
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+// volatile: GCC otherwise assumes malloc leaves globals alone
+static volatile bool s_counting;
+static volatile uint64_t s_allocs;
+static volatile uint64_t s_alloc_bytes;
+
+// glibc lets the executable replace these; the real ones stay reachable
+void *malloc(size_t size) {
+  if (s_counting) {
+    s_allocs++;
+    s_alloc_bytes += size;
+  }
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+  if (s_counting) {
+    s_allocs++;
+    s_alloc_bytes += count * size;
+  }
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  if (s_counting) {
+    s_allocs++;
+    s_alloc_bytes += size;
+  }
+  return __libc_realloc(ptr, size);
+}
+
+// ============================================================================
+// CASES
+// ============================================================================
+
+typedef struct {
+  const char *name;
+  void (*run)(uint32_t iterations);
+} BenchCase;
+
+static const char WEATHER_FULL[] =
+    "{\"temperature\":18,\"weatherCode\":2,\"sunrise\":\"2026-06-15T05:31\","
+    "\"sunset\":\"2026-06-15T21:12\",\"moonPhase\":42,\"moonPhaseName\":\"Waxing Gibbous\","
+    "\"moonPhaseIcon\":3,\"timestamp\":1781516400}";
+static const char WEATHER_SHORT[] = "{\"temperature\":-4,\"weatherCode\":71}";
+
+static volatile uint32_t s_sink;
+static char s_buffer[32];
+static struct tm s_tm;
+
+static void run_format(DateFormatType format, uint32_t iterations) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    s_tm.tm_min = (int)(i % 60);
+    s_tm.tm_mday = 1 + (int)(i % 28);
+    format_date_string(s_buffer, sizeof(s_buffer), &s_tm, format, 8123 + (int)(i & 255),
+                       6100 + (int)(i & 255), i & 1, 60 + (int)(i & 63));
+    s_sink += (uint8_t)s_buffer[0];
+  }
+}
+
+#define FORMAT_CASE(fn, format) \
+  static void fn(uint32_t iterations) { run_format(format, iterations); }
+
+FORMAT_CASE(bench_weekday, DATE_FORMAT_WEEKDAY)
+FORMAT_CASE(bench_month_day, DATE_FORMAT_MONTH_DAY)
+FORMAT_CASE(bench_yyyy_mm_dd, DATE_FORMAT_YYYY_MM_DD)
+FORMAT_CASE(bench_dd_mm_yyyy, DATE_FORMAT_DD_MM_YYYY)
+FORMAT_CASE(bench_mm_dd_yyyy, DATE_FORMAT_MM_DD_YYYY)
+FORMAT_CASE(bench_month_year, DATE_FORMAT_MONTH_YEAR)
+FORMAT_CASE(bench_weekday_day, DATE_FORMAT_WEEKDAY_DAY)
+FORMAT_CASE(bench_step_count, DATE_FORMAT_STEP_COUNT)
+FORMAT_CASE(bench_distance, DATE_FORMAT_DISTANCE)
+FORMAT_CASE(bench_heart_rate, DATE_FORMAT_HEART_RATE)
+
+static void bench_from_string_to_tm(uint32_t iterations) {
+  struct tm out;
+  for (uint32_t i = 0; i < iterations; i++) {
+    from_string_to_tm((i & 1) ? "2026-06-15T05:31" : "2026-12-29T21:12", &out);
+    s_sink += (uint32_t)out.tm_min;
+  }
+}
+
+static void bench_weather_update_full(uint32_t iterations) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    weather_module_update(WEATHER_FULL);
+  }
+  s_sink += (uint32_t)weather_module_get_data()->temperature;
+}
+
+static void bench_weather_update_short(uint32_t iterations) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    weather_module_update(WEATHER_SHORT);
+  }
+  s_sink += (uint32_t)weather_module_get_data()->temperature;
+}
+
+static void bench_temperature(uint32_t iterations) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    weather_module_set_scale(1 + (int)(i & 1));
+    s_sink += (uint32_t)weather_module_get_temperature();
+  }
+}
+
+static void bench_icon_resource(uint32_t iterations) {
+  static const uint16_t codes[] = { 0, 1, 2, 3, 45, 48, 51, 61, 71, 80, 95, 99, 4 };
+  for (uint32_t i = 0; i < iterations; i++) {
+    s_sink += weather_module_get_icon_resource(codes[i % ARRAY_LENGTH(codes)], i & 1);
+  }
+}
+
+static const BenchCase CASES[] = {
+  { "format_date_string/weekday", bench_weekday },
+  { "format_date_string/month_day", bench_month_day },
+  { "format_date_string/yyyy_mm_dd", bench_yyyy_mm_dd },
+  { "format_date_string/dd_mm_yyyy", bench_dd_mm_yyyy },
+  { "format_date_string/mm_dd_yyyy", bench_mm_dd_yyyy },
+  { "format_date_string/month_year", bench_month_year },
+  { "format_date_string/weekday_day", bench_weekday_day },
+  { "format_date_string/step_count", bench_step_count },
+  { "format_date_string/distance", bench_distance },
+  { "format_date_string/heart_rate", bench_heart_rate },
+  { "from_string_to_tm", bench_from_string_to_tm },
+  { "weather_module_update/full", bench_weather_update_full },
+  { "weather_module_update/short", bench_weather_update_short },
+  { "weather_module_get_temperature", bench_temperature },
+  { "weather_module_get_icon_resource", bench_icon_resource },
+};
+
+// ============================================================================
+// TIMING
+// ============================================================================
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t time_run(const BenchCase *bench, uint32_t iterations) {
+  uint64_t start = now_ns();
+  bench->run(iterations);
+  return now_ns() - start;
+}
+
+void host_scenario(int argc, char **argv) {
+  int rounds = 5;
+  int min_ms = 20;
+  const char *filter = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+      rounds = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+      min_ms = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    }
+  }
+
+  // HOST_LOCALE picks the name tables, as the watch language would
+  date_format_init();
+
+  memset(&s_tm, 0, sizeof(s_tm));
+  s_tm.tm_year = 126;
+  s_tm.tm_mon = 5;
+  s_tm.tm_hour = 10;
+  s_tm.tm_wday = 1;
+  s_tm.tm_yday = 165;
+
+  for (size_t c = 0; c < ARRAY_LENGTH(CASES); c++) {
+    const BenchCase *bench = &CASES[c];
+    if (filter && !strstr(bench->name, filter)) {
+      continue;
+    }
+
+    // Grow the iteration count until one round takes at least min_ms
+    bench->run(16);
+    uint32_t iterations = 64;
+    while (time_run(bench, iterations) < (uint64_t)min_ms * 1000000ULL && iterations < (1u << 30)) {
+      iterations *= 2;
+    }
+
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < rounds; r++) {
+      uint64_t elapsed = time_run(bench, iterations);
+      if (elapsed < best) {
+        best = elapsed;
+      }
+    }
+
+    s_allocs = s_alloc_bytes = 0;
+    s_counting = true;
+    bench->run(iterations);
+    s_counting = false;
+
+    printf("bench %s %u %.1f %.3f %.1f\n", bench->name, iterations, (double)best / iterations,
+           (double)s_allocs / iterations, (double)s_alloc_bytes / iterations);
+  }
+}
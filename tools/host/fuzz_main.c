@@ -0,0 +1,303 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "host.h"
+#include "utilities/date_format.h"
+#include "utilities/weather.h"
+
+// Utilities fuzzer (build with -fsanitize=address,undefined, see tools/fuzz.py)
+//
+// One input drives the JSON path and the date formatter:
+//
+//   bytes 0-7   format_date_string: format, buffer size, date, time and
+//               name table language, step / distance / heart rate values
+//               and units
+//   bytes 8-    weather payload, handed to weather_module_update as the
+//               NUL-terminated string an AppMessage cstring would be; the
+//               parsed sunrise / sunset go through from_string_to_tm and the
+//               weather code through weather_module_get_icon_resource
+//
+// Every buffer is allocated at its exact size so the sanitizer catches any
+// read or write past the end. Without file arguments the built-in seeds are
+// mutated for --runs inputs; with file arguments each file is run once, which
+// is what afl-fuzz needs (fuzz @@). Built with -DHOST_LIBFUZZER and
+// -fsanitize=fuzzer the inputs come from libFuzzer instead. When a sanitizer
+// aborts (ASAN_OPTIONS / UBSAN_OPTIONS abort_on_error=1) or the input
+// crashes, it is written to <artifacts>/crash-<hash>.
+//
+// Usage: fuzz [--runs N] [--seed N] [--artifacts DIR] [--write-seeds DIR] [file ...]
+
+#define HEADER_SIZE 8
+#define MAX_INPUT 512
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+#ifdef HOST_LIBFUZZER
+int LLVMFuzzerRunDriver(int *argc, char ***argv, int (*callback)(const uint8_t *, size_t));
+#endif
+
+static const char *SEEDS[] = {
+  "\x01\x20\x05\x1d\x0a\x1e\x40\x21"
+  "{\"temperature\":18,\"weatherCode\":2,\"sunrise\":\"2026-06-15T05:31\","
+  "\"sunset\":\"2026-06-15T21:12\",\"moonPhase\":42,\"moonPhaseName\":\"Waxing Gibbous\","
+  "\"moonPhaseIcon\":3,\"timestamp\":1781516400}",
+  "\x08\x0c\x0b\x1c\x17\x3b\x7f\x01"
+  "{\"temperature\":-4,\"weatherCode\":71}",
+  "\x09\x04\x00\x01\x00\x00\x00\x00"
+  "{\"sunrise\":\"\",\"sunset\":\"2026-1\",\"moonPhaseName\":\"\"}",
+  "\x00\x01\x03\x0f\x0c\x00\xff\xff"
+  "{\"temperature\":\"cold\",\"weatherCode\":,\"sunrise\":\"",
+  "\x0b\x1f\x08\x08\x08\x08\x08\x08"
+  "{\"moonPhaseName\":\"Waning Crescent Waning Crescent\",\"timestamp\":-1}",
+};
+
+// Dictionary for mutations: the keys and punctuation the parser looks for
+static const char *TOKENS[] = {
+  "\"temperature\":", "\"weatherCode\":", "\"sunrise\":\"", "\"sunset\":\"", "\"moonPhase\":",
+  "\"moonPhaseName\":\"", "\"moonPhaseIcon\":", "\"timestamp\":", "\"", ":", ",", "{", "}",
+  "-", "2147483648", "2026-06-15T05:31",
+};
+
+static uint8_t s_input[MAX_INPUT];
+static size_t s_input_size;
+static const char *s_artifacts = ".";
+static uint64_t s_rng = 0x9e3779b97f4a7c15ULL;
+static volatile size_t s_sink;
+
+// ============================================================================
+// TARGETS
+// ============================================================================
+
+// Every name table, multi-byte letters included, and one without a table
+static const char *LOCALES[] = { "en_US", "fr_FR", "de_DE", "es_ES", "it_IT", "pt_PT", "zh_CN" };
+
+static void fuzz_format(const uint8_t *header) {
+  setenv("HOST_LOCALE", LOCALES[(header[4] >> 5) % ARRAY_LENGTH(LOCALES)], 1);
+  date_format_init();
+
+  struct tm tm = {
+    .tm_year = 100 + header[2] % 100,
+    .tm_mon = header[2] % 12,
+    .tm_mday = 1 + header[3] % 31,
+    .tm_hour = header[4] % 24,
+    .tm_min = header[5] % 60,
+    .tm_wday = header[3] % 7,
+    .tm_yday = (header[2] * 3 + header[3]) % 366,
+  };
+  // Health values stay inside what a watch can report in a day
+  int steps = (header[6] << 8 | header[7]) * 4;
+  int distance = (header[7] << 11 | header[6] << 3) % 500000;
+  int heart_rate = header[6] % 2 ? header[7] : 0;
+
+  size_t size = 1 + header[1] % 32;
+  char *buffer = malloc(size);
+  format_date_string(buffer, size, &tm, (DateFormatType)(header[0] % (DATE_FORMAT_STEP_HISTORY + 1)),
+                     steps, distance, header[5] & 1, heart_rate);
+  // Callers hand the result straight to a text layer
+  s_sink += strlen(buffer);
+  free(buffer);
+}
+
+static void fuzz_weather(const uint8_t *data, size_t size) {
+  char *json = malloc(size + 1);
+  memcpy(json, data, size);
+  json[size] = '\0';
+  weather_module_update(json);
+
+  WeatherData *weather = weather_module_get_data();
+  struct tm parsed;
+  from_string_to_tm(weather->sunrise, &parsed);
+  from_string_to_tm(weather->sunset, &parsed);
+  from_string_to_tm(json, &parsed);
+  weather_module_get_icon_resource(weather->weather_code, weather->moon_phase & 1);
+  for (int scale = 1; scale <= 2; scale++) {
+    weather_module_set_scale(scale);
+    weather_module_get_temperature();
+  }
+  free(json);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  uint8_t header[HEADER_SIZE] = {0};
+  memcpy(header, data, size < HEADER_SIZE ? size : HEADER_SIZE);
+  fuzz_format(header);
+  fuzz_weather(data + (size < HEADER_SIZE ? size : HEADER_SIZE), size < HEADER_SIZE ? 0 : size - HEADER_SIZE);
+  return 0;
+}
+
+// ============================================================================
+// DRIVER
+// ============================================================================
+
+static uint32_t next_random(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 7;
+  s_rng ^= s_rng << 17;
+  return (uint32_t)(s_rng >> 16);
+}
+
+static uint32_t input_hash(void) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < s_input_size; i++) {
+    hash = (hash ^ s_input[i]) * 16777619u;
+  }
+  return hash;
+}
+
+static bool write_file(const char *path, const uint8_t *data, size_t size) {
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = write(fd, data, size) == (ssize_t)size;
+  close(fd);
+  return ok;
+}
+
+// Runs from the signal handler, so only async-signal-safe calls
+static void save_crash(int sig) {
+  static const char HEX[] = "0123456789abcdef";
+  char path[512];
+  size_t len = strlen(s_artifacts);
+  if (len + 16 < sizeof(path)) {
+    uint32_t hash = input_hash();
+    memcpy(path, s_artifacts, len);
+    memcpy(path + len, "/crash-", 7);
+    len += 7;
+    for (int shift = 28; shift >= 0; shift -= 4) {
+      path[len++] = HEX[(hash >> shift) & 0xf];
+    }
+    path[len] = '\0';
+    if (write_file(path, s_input, s_input_size)) {
+      static const char NOTE[] = "fuzz: input written to ";
+      write(STDERR_FILENO, NOTE, sizeof(NOTE) - 1);
+      write(STDERR_FILENO, path, len);
+      write(STDERR_FILENO, "\n", 1);
+    }
+  }
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+static void run_input(void) {
+  LLVMFuzzerTestOneInput(s_input, s_input_size);
+}
+
+static void load_seed(size_t index) {
+  s_input_size = HEADER_SIZE + strlen(SEEDS[index] + HEADER_SIZE);
+  memcpy(s_input, SEEDS[index], s_input_size);
+}
+
+static void mutate(void) {
+  int count = 1 + next_random() % 4;
+  for (int m = 0; m < count; m++) {
+    size_t at = s_input_size ? next_random() % s_input_size : 0;
+    switch (next_random() % 6) {
+      case 0:  // Flip a bit
+        if (s_input_size) {
+          s_input[at] ^= (uint8_t)(1 << (next_random() % 8));
+        }
+        break;
+      case 1:  // Random byte
+        if (s_input_size) {
+          s_input[at] = (uint8_t)next_random();
+        }
+        break;
+      case 2:  // Delete a run
+        if (s_input_size) {
+          size_t n = 1 + next_random() % (s_input_size - at);
+          memmove(s_input + at, s_input + at + n, s_input_size - at - n);
+          s_input_size -= n;
+        }
+        break;
+      case 3:  // Truncate
+        s_input_size = at;
+        break;
+      case 4:  // Insert a token
+      case 5: {
+        const char *token = TOKENS[next_random() % ARRAY_LENGTH(TOKENS)];
+        size_t n = strlen(token);
+        if (s_input_size + n <= MAX_INPUT) {
+          memmove(s_input + at + n, s_input + at, s_input_size - at);
+          memcpy(s_input + at, token, n);
+          s_input_size += n;
+        }
+        break;
+      }
+    }
+  }
+}
+
+static bool run_file(const char *path) {
+  FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "fuzz: cannot open %s\n", path);
+    return false;
+  }
+  s_input_size = fread(s_input, 1, MAX_INPUT, file);
+  if (file != stdin) {
+    fclose(file);
+  }
+  run_input();
+  return true;
+}
+
+void host_scenario(int argc, char **argv) {
+  uint32_t runs = 100000;
+  const char *seeds_dir = NULL;
+  int files = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+      runs = (uint32_t)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+      s_rng ^= strtoull(argv[++i], NULL, 10) * 0x2545f4914f6cdd1dULL;
+    } else if (strcmp(argv[i], "--artifacts") == 0 && i + 1 < argc) {
+      s_artifacts = argv[++i];
+    } else if (strcmp(argv[i], "--write-seeds") == 0 && i + 1 < argc) {
+      seeds_dir = argv[++i];
+    }
+  }
+  signal(SIGABRT, save_crash);
+  signal(SIGSEGV, save_crash);
+  signal(SIGBUS, save_crash);
+
+  if (seeds_dir) {
+    for (size_t s = 0; s < ARRAY_LENGTH(SEEDS); s++) {
+      char path[512];
+      snprintf(path, sizeof(path), "%s/seed-%u", seeds_dir, (unsigned)s);
+      load_seed(s);
+      write_file(path, s_input, s_input_size);
+    }
+    return;
+  }
+#ifdef HOST_LIBFUZZER
+  LLVMFuzzerRunDriver(&argc, &argv, LLVMFuzzerTestOneInput);
+  return;
+#endif
+
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] == '-' && argv[i][1] == '-') {
+      i++;  // Option value
+    } else if (argv[i][0] != '-' || argv[i][1] == '\0') {
+      files += run_file(argv[i]) ? 1 : 0;
+    }
+  }
+  if (files) {
+    printf("files %d\n", files);
+    return;
+  }
+
+  for (size_t s = 0; s < ARRAY_LENGTH(SEEDS); s++) {
+    load_seed(s);
+    run_input();
+  }
+  for (uint32_t run = 0; run < runs; run++) {
+    load_seed(next_random() % ARRAY_LENGTH(SEEDS));
+    mutate();
+    if (next_random() % 4 == 0) {
+      mutate();
+    }
+    run_input();
+  }
+  printf("runs %u\n", runs + (uint32_t)ARRAY_LENGTH(SEEDS));
+}
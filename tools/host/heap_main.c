@@ -0,0 +1,114 @@
+#include <time.h>
+
+#include "host.h"
+
+// Heap fragmentation scenario
+//
+// Built with -DHOST_HEAP_MODEL=1 and heap_model.c. Runs the face for
+// --days simulated days of the allocation churn a week of wear brings:
+// moon view open/close on wrist taps, weather pushes whose icon changes
+// (the code cycles and day turns to night), and a settings save every
+// --config-hours that flips --toggle. Between events the heap model is
+// sampled, so each line shows the heap as the next allocation would find it:
+//
+//   resource <name> <heap bytes>              every bitmap, as charged
+//   sample <minute> <used> <largest free> <free blocks> <failures>
+//   summary <size> <peak> <min largest free> <failures> <largest failure> <allocations>
+//
+// Usage: heap [--days N] [--taps-per-day N] [--weather-minutes N]
+//             [--config-hours N] [--toggle NAME] [--sample-minutes N] [NAME=value ...]
+
+static const int WEATHER_CODES[] = { 0, 1, 2, 3, 45, 61, 63, 71, 80, 95 };
+
+static void push_weather(int index) {
+  char weather[160];
+  snprintf(weather, sizeof(weather),
+           "{\"temperature\":%d,\"weatherCode\":%d,\"sunrise\":\"05:31\",\"sunset\":\"21:12\",\"moonPhase\":%d}",
+           8 + index % 12, WEATHER_CODES[index % ARRAY_LENGTH(WEATHER_CODES)], index % 30);
+  host_inbox_begin();
+  host_inbox_cstring("WEATHER_DATA", weather);
+  host_inbox_send();
+}
+
+void host_scenario(int argc, char **argv) {
+  int days = 7;
+  int taps_per_day = 24;
+  int weather_minutes = 30;
+  int config_hours = 12;
+  int sample_minutes = 60;
+  const char *toggle = NULL;
+  char *pairs[64];
+  int pair_count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+      days = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--taps-per-day") == 0 && i + 1 < argc) {
+      taps_per_day = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--weather-minutes") == 0 && i + 1 < argc) {
+      weather_minutes = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--config-hours") == 0 && i + 1 < argc) {
+      config_hours = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--toggle") == 0 && i + 1 < argc) {
+      toggle = argv[++i];
+    } else if (strcmp(argv[i], "--sample-minutes") == 0 && i + 1 < argc) {
+      sample_minutes = atoi(argv[++i]);
+    } else if (pair_count < 63) {
+      pairs[pair_count++] = argv[i];
+    }
+  }
+
+  for (int i = 0; i < host_resource_count; i++) {
+    if (host_resources[i].heap_bytes) {
+      printf("resource %s %u\n", host_resources[i].name, host_resources[i].heap_bytes);
+    }
+  }
+
+  host_health_set(HealthMetricStepCount, 3200);
+  host_health_set(HealthMetricWalkedDistanceMeters, 2400);
+  host_run_for_ms(3000);
+  if (pair_count) {
+    host_inbox_send_pairs(pair_count, pairs);
+  }
+  host_run_for_ms(1000);
+
+  // Taps spread over the waking hours, 07:00 to 23:00
+  int tap_every = taps_per_day > 0 ? 16 * 60 / taps_per_day : 0;
+  char toggle_pair[80];
+  bool toggled = false;
+  int weather_index = 0;
+  size_t min_largest = host_heap_stats()->largest_free;
+
+  for (int minute = 0; minute < days * 24 * 60; minute++) {
+    time_t now = (time_t)(host_now_ms() / 1000);
+    int hour = localtime(&now)->tm_hour;
+    int minute_of_day = hour * 60 + localtime(&now)->tm_min;
+
+    if (tap_every && hour >= 7 && hour < 23 && minute_of_day % tap_every == 0) {
+      host_accel_tap();
+      host_run_for_ms(6000);   // The moon view dismisses itself after 5 s
+    }
+    if (weather_minutes > 0 && minute % weather_minutes == weather_minutes - 1) {
+      push_weather(weather_index++);
+    }
+    if (toggle && config_hours > 0 && minute % (config_hours * 60) == config_hours * 60 - 1) {
+      toggled = !toggled;
+      snprintf(toggle_pair, sizeof(toggle_pair), "%s=%d", toggle, toggled ? 1 : 0);
+      pairs[pair_count] = toggle_pair;
+      host_inbox_send_pairs(pair_count + 1, pairs);
+    }
+    host_run_for_ms(60 * 1000 - (host_now_ms() % (60 * 1000)));
+
+    const HostHeapStats *stats = host_heap_stats();
+    if (stats->largest_free < min_largest) {
+      min_largest = stats->largest_free;
+    }
+    if (sample_minutes > 0 && minute % sample_minutes == 0) {
+      printf("sample %d %zu %zu %u %u\n", minute, stats->used, stats->largest_free, stats->free_blocks,
+             stats->failures);
+    }
+  }
+
+  const HostHeapStats *stats = host_heap_stats();
+  printf("summary %zu %zu %zu %u %zu %u\n", stats->size, stats->peak, min_largest, stats->failures,
+         stats->largest_failure, stats->allocations);
+}
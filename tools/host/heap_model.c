@@ -0,0 +1,173 @@
+#define HOST_HEAP_MODEL_IMPL
+#include "host.h"
+
+// App heap model
+//
+// Built into the host when HOST_HEAP_MODEL is defined (tools/heap_model.py).
+// pebble.h then routes malloc/calloc/realloc/free from the app and from the
+// runtime's layers, windows and bitmaps here. Memory still comes from libc;
+// alongside it every allocation is placed in a model of the watch heap:
+//
+//   - HOST_HEAP_SIZE bytes, one contiguous region
+//   - first fit from the start of the region, the block split at the request
+//   - 8-byte aligned sizes plus an 8-byte header per block
+//   - neighbouring free blocks merged on free
+//
+// A request the model cannot place fails with NULL, as it would on the watch.
+// The runtime charges its objects at their 32-bit firmware sizes through
+// host_heap_charge_next(), and bitmaps for their decoded pixel data.
+
+#ifndef HOST_HEAP_SIZE
+#define HOST_HEAP_SIZE (24 * 1024)
+#endif
+
+#define HEAP_ALIGN 8
+#define HEAP_HEADER 8
+#define HEAP_MAX_BLOCKS 2048
+
+typedef struct {
+  uint32_t offset;
+  uint32_t size;          // header included
+  const void *owner;      // libc pointer handed to the app, NULL when free
+  size_t request;         // bytes the app asked for (libc's side)
+} HeapBlock;
+
+static HeapBlock s_blocks[HEAP_MAX_BLOCKS];
+static int s_block_count = 0;
+static HostHeapStats s_stats;
+static size_t s_charge_next = 0;
+
+static void heap_start(void) {
+  if (s_block_count) return;
+  s_blocks[0] = (HeapBlock){ .offset = 0, .size = HOST_HEAP_SIZE, .owner = NULL };
+  s_block_count = 1;
+  s_stats.size = HOST_HEAP_SIZE;
+}
+
+static void refresh_free_stats(void) {
+  uint32_t largest = 0;
+  s_stats.free_blocks = 0;
+  for (int i = 0; i < s_block_count; i++) {
+    if (!s_blocks[i].owner) {
+      s_stats.free_blocks++;
+      if (s_blocks[i].size > largest) largest = s_blocks[i].size;
+    }
+  }
+  s_stats.largest_free = largest > HEAP_HEADER ? largest - HEAP_HEADER : 0;
+}
+
+static bool heap_place(const void *owner, size_t request, size_t size) {
+  heap_start();
+  uint32_t need = (uint32_t)((size + HEAP_ALIGN - 1) / HEAP_ALIGN * HEAP_ALIGN) + HEAP_HEADER;
+  for (int i = 0; i < s_block_count; i++) {
+    HeapBlock *block = &s_blocks[i];
+    if (block->owner || block->size < need) continue;
+    // Split unless the remainder could not hold a header and one unit
+    if (block->size - need >= HEAP_HEADER + HEAP_ALIGN && s_block_count < HEAP_MAX_BLOCKS) {
+      memmove(&s_blocks[i + 2], &s_blocks[i + 1], (size_t)(s_block_count - i - 1) * sizeof(HeapBlock));
+      s_blocks[i + 1] = (HeapBlock){ .offset = block->offset + need, .size = block->size - need, .owner = NULL };
+      block->size = need;
+      s_block_count++;
+    }
+    block->owner = owner;
+    block->request = request;
+    s_stats.used += block->size;
+    if (s_stats.used > s_stats.peak) s_stats.peak = s_stats.used;
+    s_stats.allocations++;
+    refresh_free_stats();
+    return true;
+  }
+  s_stats.failures++;
+  if (size > s_stats.largest_failure) s_stats.largest_failure = size;
+  return false;
+}
+
+static void heap_release(const void *owner) {
+  for (int i = 0; i < s_block_count; i++) {
+    if (s_blocks[i].owner != owner) continue;
+    s_blocks[i].owner = NULL;
+    s_stats.used -= s_blocks[i].size;
+    // Merge with the next block, then with the previous one
+    if (i + 1 < s_block_count && !s_blocks[i + 1].owner) {
+      s_blocks[i].size += s_blocks[i + 1].size;
+      memmove(&s_blocks[i + 1], &s_blocks[i + 2], (size_t)(s_block_count - i - 2) * sizeof(HeapBlock));
+      s_block_count--;
+    }
+    if (i > 0 && !s_blocks[i - 1].owner) {
+      s_blocks[i - 1].size += s_blocks[i].size;
+      memmove(&s_blocks[i], &s_blocks[i + 1], (size_t)(s_block_count - i - 1) * sizeof(HeapBlock));
+      s_block_count--;
+    }
+    refresh_free_stats();
+    return;
+  }
+}
+
+static size_t heap_charge(size_t size) {
+  size_t charge = s_charge_next ? s_charge_next : size;
+  s_charge_next = 0;
+  return charge;
+}
+
+static size_t heap_request_of(const void *owner) {
+  for (int i = 0; i < s_block_count; i++) {
+    if (s_blocks[i].owner == owner) return s_blocks[i].request;
+  }
+  return 0;
+}
+
+// ============================================================================
+// ALLOCATOR
+// ============================================================================
+
+void *host_heap_malloc(size_t size) {
+  size_t charge = heap_charge(size);
+  void *ptr = malloc(size ? size : 1);
+  if (ptr && !heap_place(ptr, size, charge)) {
+    free(ptr);
+    return NULL;
+  }
+  return ptr;
+}
+
+void *host_heap_calloc(size_t count, size_t size) {
+  void *ptr = host_heap_malloc(count * size);
+  if (ptr) memset(ptr, 0, count * size);
+  return ptr;
+}
+
+void *host_heap_realloc(void *ptr, size_t size) {
+  if (!ptr) return host_heap_malloc(size);
+  if (!size) {
+    host_heap_free(ptr);
+    return NULL;
+  }
+  // Modelled as allocate, copy, free: the old block is held meanwhile
+  size_t old_size = heap_request_of(ptr);
+  void *result = host_heap_malloc(size);
+  if (result) {
+    memcpy(result, ptr, old_size < size ? old_size : size);
+    host_heap_free(ptr);
+  }
+  return result;
+}
+
+void host_heap_free(void *ptr) {
+  if (!ptr) return;
+  heap_release(ptr);
+  free(ptr);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void host_heap_charge_next(size_t size) {
+  s_charge_next = size;
+}
+
+const HostHeapStats *host_heap_stats(void) {
+  heap_start();
+  refresh_free_stats();
+  return &s_stats;
+}
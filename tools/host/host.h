@@ -0,0 +1,193 @@
+#pragma once
+#include "pebble.h"
+
+// Host harness API - drives the watchface from a scenario on the desktop
+//
+// pebble_host.c provides main(): it stores argv, calls the app's main()
+// (renamed pebble_app_main at build time), and when the app enters
+// app_event_loop() hands control to the scenario's host_scenario(). The
+// scenario advances the virtual clock and injects events; after every event
+// the host renders a frame if anything was marked dirty, exactly when the
+// firmware would.
+
+#define HOST_SCREEN_W PBL_DISPLAY_WIDTH
+#define HOST_SCREEN_H PBL_DISPLAY_HEIGHT
+
+// Implemented by each scenario (overdraw_main.c, ...)
+void host_scenario(int argc, char **argv);
+
+// ============================================================================
+// CLOCK AND EVENT LOOP
+// ============================================================================
+
+// Virtual time in ms since the epoch; starts at HOST_START_TIME or --time
+uint64_t host_now_ms(void);
+void host_set_24h(bool use_24h);
+
+// Advance the clock, firing tick events and app timers in order
+void host_run_for_ms(uint64_t duration_ms);
+void host_run_until_ms(uint64_t when_ms);
+
+// ============================================================================
+// INJECTED EVENTS
+// ============================================================================
+
+// Build and deliver an inbox message; keys are message key names
+void host_inbox_begin(void);
+void host_inbox_int(const char *key_name, int32_t value);
+void host_inbox_cstring(const char *key_name, const char *value);
+void host_inbox_send(void);
+
+// Sends "NAME=value" pairs as one inbox message (ints when numeric)
+void host_inbox_send_pairs(int count, char **pairs);
+
+void host_battery_event(uint8_t percent, bool charging);
+void host_health_set(HealthMetric metric, HealthValue value);
+void host_health_event(HealthEventType event);
+void host_accel_tap(void);
+void host_set_connected(bool connected);
+
+// ============================================================================
+// COUNTERS
+// ============================================================================
+
+// Work the app caused since the last reset, for the power model
+typedef struct {
+  uint32_t wakeups;         // handler or callback invocations of any kind
+  uint32_t tick_events;
+  uint32_t timer_events;
+  uint32_t service_events;  // health, battery, connection, accel tap
+  uint32_t frames;
+  uint64_t pixels_written;
+  uint32_t dirty_marks;     // layer invalidations, direct or through text/bitmap setters
+  uint32_t health_calls;
+  uint32_t persist_writes;
+  uint32_t persist_bytes;
+  uint32_t inbox_messages;
+  uint32_t outbox_messages;
+  uint32_t bt_bytes;        // dictionary bytes both ways
+  uint64_t inbox_ns;        // wall-clock time spent in the inbox handler
+} HostCounters;
+
+const HostCounters *host_counters(void);
+void host_reset_counters(void);
+
+// ============================================================================
+// FRAMES
+// ============================================================================
+
+// Per-layer accounting for the last rendered frame
+typedef struct {
+  const Layer *layer;
+  const char *kind;       // "window", "layer", "text", "bitmap"
+  const void *proc;       // update proc for plain layers (resolve with addr2line)
+  GRect frame;            // absolute
+  uint32_t writes;        // pixels written by this layer
+  uint32_t overdraw;      // of those, pixels something else had already written this frame
+  uint64_t hash;          // of every pixel the layer wrote, to spot redraws that changed nothing
+} HostLayerStat;
+
+#define HOST_MAX_LAYER_STATS 48
+
+// Where an invalidation came from (filled in by site_hooks.h, else empty)
+typedef struct {
+  const char *func;
+  const char *file;
+  int line;
+} HostSite;
+
+// A layer dirtied since the previous frame, and by whom
+typedef struct {
+  const Layer *layer;
+  HostSite site;
+  uint16_t inputs;        // render graph inputs behind it, 0 for direct calls
+} HostDirty;
+
+#define HOST_MAX_DIRTY 64
+
+typedef struct {
+  uint32_t index;
+  uint64_t time_ms;
+  GColor8 pixels[HOST_SCREEN_W * HOST_SCREEN_H];
+  uint16_t writes[HOST_SCREEN_W * HOST_SCREEN_H];  // writes per pixel this frame
+  uint32_t total_writes;
+  int layer_count;
+  HostLayerStat layers[HOST_MAX_LAYER_STATS];
+  int dirty_count;
+  HostDirty dirty[HOST_MAX_DIRTY];
+} HostFrame;
+
+// Called after each rendered frame
+typedef void (*HostFrameHandler)(const HostFrame *frame);
+void host_set_frame_handler(HostFrameHandler handler);
+
+// Render now if anything is dirty; returns true when a frame was drawn
+bool host_render(void);
+
+// Pixels that exist on this display (round screens drop the corners)
+bool host_pixel_visible(int x, int y);
+
+// Observe what the app sends (e.g. to answer REQUEST_WEATHER)
+typedef void (*HostOutboxHandler)(DictionaryIterator *iter);
+void host_set_outbox_handler(HostOutboxHandler handler);
+
+// ============================================================================
+// CALL SITES (site_hooks.h)
+// ============================================================================
+
+// Sets the site the next dirtying call is attributed to
+void host_site(const char *func, const char *file, int line);
+
+// Mirror of the render graph so flushes can be traced back to invalidations
+void host_graph_add(const Layer *layer, uint16_t inputs);
+void host_graph_remove(const Layer *layer);
+void host_graph_invalidate(uint16_t changed);
+uint16_t host_graph_tick(uint16_t pending);
+void host_graph_flush(void);
+
+// ============================================================================
+// HEAP MODEL (heap_model.c, built with -DHOST_HEAP_MODEL=1)
+// ============================================================================
+
+typedef struct {
+  size_t size;              // HOST_HEAP_SIZE
+  size_t used;              // allocated blocks, headers included
+  size_t peak;
+  size_t largest_free;      // largest request that would still fit
+  uint32_t free_blocks;
+  uint32_t allocations;
+  uint32_t failures;        // requests that did not fit
+  size_t largest_failure;
+} HostHeapStats;
+
+#if HOST_HEAP_MODEL
+// Charge the next allocation at this size instead of the requested one
+void host_heap_charge_next(size_t size);
+const HostHeapStats *host_heap_stats(void);
+#else
+#define host_heap_charge_next(size) ((void)0)
+#endif
+
+// ============================================================================
+// GENERATED DATA (tools/host_build.py)
+// ============================================================================
+
+typedef struct {
+  const char *name;
+  uint32_t key;
+} HostMessageKey;
+
+typedef struct {
+  const char *name;
+  int16_t width;
+  int16_t height;
+  const uint8_t *argb;    // quantised for this platform, 0x00 = clear
+  uint32_t heap_bytes;    // pixel data and palette the firmware allocates for it
+} HostResource;
+
+extern const HostMessageKey host_message_keys[];
+extern const int host_message_key_count;
+extern const HostResource host_resources[];
+extern const int host_resource_count;
+
+uint32_t host_message_key(const char *name);
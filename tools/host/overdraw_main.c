@@ -0,0 +1,120 @@
+#include "host.h"
+
+// Overdraw scenario
+//
+// Boots the face, lets the splash finish, applies any settings, then
+// accumulates per-pixel write counts and per-layer stats over a simulated
+// run. The report goes to stdout for tools/overdraw.py:
+//
+//   frames <n>
+//   screen <w> <h>
+//   row <y> <sum of writes per pixel, -1 where the display has no pixel>
+//   worst <total writes> <frame index>
+//   layer <kind> <proc> <x> <y> <w> <h> <writes> <overdraw>
+//
+// Usage: overdraw [--minutes N] [--settle MS] [NAME=value ...]
+
+#define MAX_LAYERS 64
+
+typedef struct {
+  const Layer *layer;
+  const char *kind;
+  const void *proc;
+  GRect frame;
+  uint64_t writes;
+  uint64_t overdraw;
+} LayerTotal;
+
+static bool s_measuring;
+static uint32_t s_frames;
+static uint64_t s_sum[HOST_SCREEN_W * HOST_SCREEN_H];
+static uint32_t s_worst_writes;
+static uint32_t s_worst_index;
+static LayerTotal s_layers[MAX_LAYERS];
+static int s_layer_count;
+
+static LayerTotal *layer_total(const HostLayerStat *stat) {
+  for (int i = 0; i < s_layer_count; i++) {
+    if (s_layers[i].layer == stat->layer && s_layers[i].proc == stat->proc) {
+      return &s_layers[i];
+    }
+  }
+  if (s_layer_count == MAX_LAYERS) {
+    return NULL;
+  }
+  LayerTotal *total = &s_layers[s_layer_count++];
+  *total = (LayerTotal){ stat->layer, stat->kind, stat->proc, stat->frame, 0, 0 };
+  return total;
+}
+
+static void frame_handler(const HostFrame *frame) {
+  if (!s_measuring) {
+    return;
+  }
+  s_frames++;
+  for (int i = 0; i < HOST_SCREEN_W * HOST_SCREEN_H; i++) {
+    s_sum[i] += frame->writes[i];
+  }
+  if (frame->total_writes > s_worst_writes) {
+    s_worst_writes = frame->total_writes;
+    s_worst_index = frame->index;
+  }
+  for (int i = 0; i < frame->layer_count; i++) {
+    LayerTotal *total = layer_total(&frame->layers[i]);
+    if (total) {
+      total->frame = frame->layers[i].frame;
+      total->writes += frame->layers[i].writes;
+      total->overdraw += frame->layers[i].overdraw;
+    }
+  }
+}
+
+void host_scenario(int argc, char **argv) {
+  int minutes = 1;
+  int settle_ms = 3000;
+  char *pairs[64];
+  int pair_count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--minutes") == 0 && i + 1 < argc) {
+      minutes = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--settle") == 0 && i + 1 < argc) {
+      settle_ms = atoi(argv[++i]);
+    } else if (pair_count < 64) {
+      pairs[pair_count++] = argv[i];
+    }
+  }
+
+  host_health_set(HealthMetricStepCount, 6400);
+  host_health_set(HealthMetricWalkedDistanceMeters, 4700);
+  host_health_set(HealthMetricHeartRateBPM, 68);
+  host_set_frame_handler(frame_handler);
+  host_run_for_ms((uint64_t)settle_ms);
+  if (pair_count) {
+    host_inbox_send_pairs(pair_count, pairs);
+  }
+  host_run_for_ms(1000);
+
+  s_measuring = true;
+  host_run_for_ms((uint64_t)minutes * 60 * 1000);
+
+  printf("frames %u\n", s_frames);
+  printf("screen %d %d\n", HOST_SCREEN_W, HOST_SCREEN_H);
+  for (int y = 0; y < HOST_SCREEN_H; y++) {
+    printf("row %d", y);
+    for (int x = 0; x < HOST_SCREEN_W; x++) {
+      if (host_pixel_visible(x, y)) {
+        printf(" %llu", (unsigned long long)s_sum[y * HOST_SCREEN_W + x]);
+      } else {
+        printf(" -1");
+      }
+    }
+    printf("\n");
+  }
+  printf("worst %u %u\n", s_worst_writes, s_worst_index);
+  for (int i = 0; i < s_layer_count; i++) {
+    const LayerTotal *t = &s_layers[i];
+    printf("layer %s %p %d %d %d %d %llu %llu\n", t->kind, t->proc,
+           t->frame.origin.x, t->frame.origin.y, t->frame.size.w, t->frame.size.h,
+           (unsigned long long)t->writes, (unsigned long long)t->overdraw);
+  }
+}
@@ -0,0 +1,461 @@
+#pragma once
+
+// Host shim of the Pebble SDK subset Constellation uses
+//
+// Lets the watchface sources compile and run on the desktop against a
+// software framebuffer and a virtual clock (see pebble_host.c / host.h).
+// Select the platform with -DPBL_PLATFORM_<NAME>; the capability macros
+// below follow from it the same way the SDK derives them.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ============================================================================
+// HEAP
+// ============================================================================
+
+// With -DHOST_HEAP_MODEL=1 the app's allocations, and the runtime's on its
+// behalf, also go through the watch heap model in heap_model.c
+#if HOST_HEAP_MODEL
+void *host_heap_malloc(size_t size);
+void *host_heap_calloc(size_t count, size_t size);
+void *host_heap_realloc(void *ptr, size_t size);
+void host_heap_free(void *ptr);
+#ifndef HOST_HEAP_MODEL_IMPL
+#define malloc(size) host_heap_malloc(size)
+#define calloc(count, size) host_heap_calloc((count), (size))
+#define realloc(ptr, size) host_heap_realloc((ptr), (size))
+#define free(ptr) host_heap_free(ptr)
+#endif
+#endif
+
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+
+// ============================================================================
+// PLATFORM
+// ============================================================================
+
+typedef enum {
+  PlatformTypeAplite,
+  PlatformTypeBasalt,
+  PlatformTypeChalk,
+  PlatformTypeDiorite,
+  PlatformTypeEmery,
+  PlatformTypeFlint,
+  PlatformTypeGabbro,
+} PlatformType;
+
+#if defined(PBL_PLATFORM_APLITE)
+#define PBL_PLATFORM_TYPE_CURRENT PlatformTypeAplite
+#define PBL_BW 1
+#define PBL_RECT 1
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_CHALK)
+#define PBL_PLATFORM_TYPE_CURRENT PlatformTypeChalk
+#define PBL_COLOR 1
+#define PBL_ROUND 1
+#define PBL_HEALTH 1
+#define PBL_DISPLAY_WIDTH 180
+#define PBL_DISPLAY_HEIGHT 180
+#elif defined(PBL_PLATFORM_DIORITE)
+#define PBL_PLATFORM_TYPE_CURRENT PlatformTypeDiorite
+#define PBL_BW 1
+#define PBL_RECT 1
+#define PBL_HEALTH 1
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_EMERY)
+#define PBL_PLATFORM_TYPE_CURRENT PlatformTypeEmery
+#define PBL_COLOR 1
+#define PBL_RECT 1
+#define PBL_HEALTH 1
+#define PBL_DISPLAY_WIDTH 200
+#define PBL_DISPLAY_HEIGHT 228
+#elif defined(PBL_PLATFORM_FLINT)
+#define PBL_PLATFORM_TYPE_CURRENT PlatformTypeFlint
+#define PBL_BW 1
+#define PBL_RECT 1
+#define PBL_HEALTH 1
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#elif defined(PBL_PLATFORM_GABBRO)
+#define PBL_PLATFORM_TYPE_CURRENT PlatformTypeGabbro
+#define PBL_COLOR 1
+#define PBL_ROUND 1
+#define PBL_HEALTH 1
+#define PBL_DISPLAY_WIDTH 260
+#define PBL_DISPLAY_HEIGHT 260
+#else
+#ifndef PBL_PLATFORM_BASALT
+#define PBL_PLATFORM_BASALT 1
+#endif
+#define PBL_PLATFORM_TYPE_CURRENT PlatformTypeBasalt
+#define PBL_COLOR 1
+#define PBL_RECT 1
+#define PBL_HEALTH 1
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#endif
+
+#if defined(PBL_COLOR)
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+#else
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_true)
+#endif
+
+#if defined(PBL_ROUND)
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_RECT_ELSE(if_true, if_false) (if_false)
+#else
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_RECT_ELSE(if_true, if_false) (if_true)
+#endif
+
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARNING 50
+#define APP_LOG_LEVEL_INFO 100
+#define APP_LOG_LEVEL_DEBUG 200
+void host_log(int level, const char *fmt, ...);
+#define APP_LOG(level, fmt, ...) host_log((level), (fmt), ##__VA_ARGS__)
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+
+// ============================================================================
+// GEOMETRY AND COLOUR
+// ============================================================================
+
+typedef struct { int16_t x, y; } GPoint;
+typedef struct { int16_t w, h; } GSize;
+typedef struct { GPoint origin; GSize size; } GRect;
+
+#define GPoint(x, y) ((GPoint){(int16_t)(x), (int16_t)(y)})
+#define GSize(w, h) ((GSize){(int16_t)(w), (int16_t)(h)})
+#define GRect(x, y, w, h) ((GRect){{(int16_t)(x), (int16_t)(y)}, {(int16_t)(w), (int16_t)(h)}})
+#define GPointZero GPoint(0, 0)
+#define GRectZero GRect(0, 0, 0, 0)
+
+GPoint grect_center_point(const GRect *rect);
+
+// 8-bit ARGB, two bits per channel like the SDK's GColor8
+typedef union {
+  uint8_t argb;
+} GColor8;
+typedef GColor8 GColor;
+
+#define GColorFromARGB8(v) ((GColor8){ .argb = (uint8_t)(v) })
+#define GColorClear GColorFromARGB8(0x00)
+#define GColorBlack GColorFromARGB8(0xC0)
+#define GColorWhite GColorFromARGB8(0xFF)
+#define GColorDarkGray GColorFromARGB8(0xD5)
+#define GColorLightGray GColorFromARGB8(0xEA)
+#define GColorRed GColorFromARGB8(0xF0)
+#define GColorDarkCandyAppleRed GColorFromARGB8(0xE0)
+#define GColorOrange GColorFromARGB8(0xF4)
+#define GColorYellow GColorFromARGB8(0xFC)
+#define GColorGreen GColorFromARGB8(0xCC)
+#define GColorMalachite GColorFromARGB8(0xDC)
+#define GColorCobaltBlue GColorFromARGB8(0xC6)
+#define GColorPictonBlue GColorFromARGB8(0xDB)
+#define GColorBlue GColorFromARGB8(0xC3)
+#define GColorVividCerulean GColorFromARGB8(0xCB)
+
+static inline bool gcolor_equal(GColor8 a, GColor8 b) { return a.argb == b.argb; }
+
+typedef enum { GCornerNone = 0, GCornersAll = 0xF } GCornerMask;
+typedef enum { GCompOpAssign, GCompOpAssignInverted, GCompOpOr, GCompOpAnd, GCompOpClear, GCompOpSet } GCompOp;
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight } GTextAlignment;
+typedef enum { GTextOverflowModeWordWrap, GTextOverflowModeTrailingEllipsis, GTextOverflowModeFill } GTextOverflowMode;
+typedef enum { GOvalScaleModeFitCircle, GOvalScaleModeFillCircle } GOvalScaleMode;
+typedef enum { GBitmapFormat1Bit, GBitmapFormat8Bit, GBitmapFormat1BitPalette,
+               GBitmapFormat2BitPalette, GBitmapFormat4BitPalette, GBitmapFormat8BitCircular } GBitmapFormat;
+
+#define TRIG_MAX_ANGLE 0x10000
+#define TRIG_MAX_RATIO 0xffff
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+#define TRIGANGLE_TO_DEG(trig_angle) (((trig_angle) * 360) / TRIG_MAX_ANGLE)
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+int32_t atan2_lookup(int16_t y, int16_t x);
+
+// ============================================================================
+// WINDOWS AND LAYERS
+// ============================================================================
+
+typedef struct Window Window;
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct BitmapLayer BitmapLayer;
+typedef struct GBitmap GBitmap;
+typedef struct GContext GContext;
+typedef struct HostFont *GFont;
+
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+typedef void (*WindowHandler)(Window *window);
+typedef struct {
+  WindowHandler load;
+  WindowHandler appear;
+  WindowHandler disappear;
+  WindowHandler unload;
+} WindowHandlers;
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_set_background_color(Window *window, GColor color);
+Layer *window_get_root_layer(const Window *window);
+void window_stack_push(Window *window, bool animated);
+bool window_stack_remove(Window *window, bool animated);
+Window *window_stack_get_top_window(void);
+
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void *layer_get_data(const Layer *layer);
+void layer_destroy(Layer *layer);
+void layer_mark_dirty(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_remove_from_parent(Layer *child);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment);
+
+BitmapLayer *bitmap_layer_create(GRect frame);
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer);
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer);
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode);
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color);
+
+// ============================================================================
+// BITMAPS, FONTS AND DRAWING
+// ============================================================================
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect);
+void gbitmap_destroy(GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+
+// Keys carry the size and weight the host text renderer needs
+#define FONT_KEY_GOTHIC_14 "GOTHIC_14"
+#define FONT_KEY_GOTHIC_14_BOLD "GOTHIC_14_BOLD"
+#define FONT_KEY_GOTHIC_18 "GOTHIC_18"
+#define FONT_KEY_GOTHIC_18_BOLD "GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24_BOLD "GOTHIC_24_BOLD"
+#define FONT_KEY_GOTHIC_28_BOLD "GOTHIC_28_BOLD"
+#define FONT_KEY_LECO_20_BOLD_NUMBERS "LECO_20_BOLD_NUMBERS"
+#define FONT_KEY_LECO_28_LIGHT_NUMBERS "LECO_28_LIGHT_NUMBERS"
+#define FONT_KEY_LECO_32_BOLD_NUMBERS "LECO_32_BOLD_NUMBERS"
+GFont fonts_get_system_font(const char *font_key);
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_antialiased(GContext *ctx, bool enable);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+
+void graphics_draw_pixel(GContext *ctx, GPoint point);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_draw_rect(GContext *ctx, GRect rect);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_fill_radial(GContext *ctx, GRect rect, GOvalScaleMode scale_mode, uint16_t inset,
+                          int32_t angle_start, int32_t angle_end);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow_mode, GTextAlignment alignment, void *text_attributes);
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment);
+
+// ============================================================================
+// EVENT SERVICES
+// ============================================================================
+
+typedef enum { SECOND_UNIT = 1 << 0, MINUTE_UNIT = 1 << 1, HOUR_UNIT = 1 << 2,
+               DAY_UNIT = 1 << 3, MONTH_UNIT = 1 << 4, YEAR_UNIT = 1 << 5 } TimeUnits;
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+
+typedef enum { ACCEL_AXIS_X = 0, ACCEL_AXIS_Y = 1, ACCEL_AXIS_Z = 2 } AccelAxisType;
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+
+typedef struct {
+  uint8_t charge_percent;
+  bool is_charging;
+  bool is_plugged;
+} BatteryChargeState;
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+BatteryChargeState battery_state_service_peek(void);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+
+typedef void (*ConnectionHandler)(bool connected);
+typedef struct {
+  ConnectionHandler pebble_app_connection_handler;
+  ConnectionHandler pebblekit_connection_handler;
+} ConnectionHandlers;
+void connection_service_subscribe(ConnectionHandlers handlers);
+void connection_service_unsubscribe(void);
+bool connection_service_peek_pebble_app_connection(void);
+
+typedef enum {
+  HealthEventSignificantUpdate = 0,
+  HealthEventMovementUpdate,
+  HealthEventSleepUpdate,
+  HealthEventMetricAlert,
+  HealthEventHeartRateUpdate,
+} HealthEventType;
+typedef enum {
+  HealthMetricStepCount,
+  HealthMetricActiveSeconds,
+  HealthMetricWalkedDistanceMeters,
+  HealthMetricSleepSeconds,
+  HealthMetricSleepRestfulSeconds,
+  HealthMetricRestingKCalories,
+  HealthMetricActiveKCalories,
+  HealthMetricHeartRateBPM,
+  HealthMetricHeartRateRawBPM,
+  HEALTH_METRIC_COUNT,
+} HealthMetric;
+typedef int32_t HealthValue;
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+bool health_service_events_unsubscribe(void);
+HealthValue health_service_sum_today(HealthMetric metric);
+HealthValue health_service_peek_current_value(HealthMetric metric);
+typedef struct HealthMetricAlert HealthMetricAlert;
+HealthMetricAlert *health_service_register_metric_alert(HealthMetric metric, HealthValue threshold);
+bool health_service_cancel_metric_alert(HealthMetricAlert *alert);
+bool health_service_set_heart_rate_sample_period(uint16_t interval_sec);
+uint16_t health_service_get_heart_rate_sample_period_expiration_sec(void);
+typedef struct {
+  uint8_t steps;
+  uint8_t orientation;
+  uint16_t vmc;
+  bool is_invalid : 1;
+  uint8_t light : 3;
+  uint8_t padding : 4;
+  uint8_t heart_rate_bpm;
+  uint8_t reserved[6];
+} HealthMinuteData;
+uint32_t health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
+                                           time_t *time_start, time_t *time_end);
+
+#define SECONDS_PER_MINUTE 60
+#define SECONDS_PER_HOUR 3600
+#define SECONDS_PER_DAY 86400
+bool clock_is_24h_style(void);
+time_t time_start_of_today(void);
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+const char *i18n_get_system_locale(void);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer);
+
+void app_event_loop(void);
+
+// ============================================================================
+// APPMESSAGE AND DICTIONARIES
+// ============================================================================
+
+typedef enum {
+  TUPLE_BYTE_ARRAY = 0,
+  TUPLE_CSTRING = 1,
+  TUPLE_UINT = 2,
+  TUPLE_INT = 3,
+} TupleType;
+
+// Same packed layout as the SDK: the value follows the header in place
+typedef struct __attribute__((__packed__)) {
+  uint32_t key;
+  TupleType type:8;
+  uint16_t length;
+  union {
+    uint8_t data[0];
+    char cstring[0];
+    uint8_t uint8;
+    uint16_t uint16;
+    uint32_t uint32;
+    int8_t int8;
+    int16_t int16;
+    int32_t int32;
+  } value[];
+} Tuple;
+
+typedef struct {
+  uint8_t *buffer;
+  uint8_t *end;
+  uint8_t *cursor;
+  uint8_t count;
+} DictionaryIterator;
+
+typedef enum {
+  DICT_OK = 0,
+  DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+} DictionaryResult;
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key);
+Tuple *dict_read_first(DictionaryIterator *iter);
+Tuple *dict_read_next(DictionaryIterator *iter);
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value);
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value);
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char * const cstring);
+
+typedef enum {
+  APP_MSG_OK = 0,
+  APP_MSG_SEND_TIMEOUT = 1 << 1,
+  APP_MSG_NOT_CONNECTED = 1 << 3,
+  APP_MSG_BUSY = 1 << 10,
+} AppMessageResult;
+typedef void (*AppMessageInboxReceived)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageOutboxSent)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator *iterator, AppMessageResult reason, void *context);
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback);
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
+AppMessageResult app_message_outbox_send(void);
+
+// ============================================================================
+// PERSISTENT STORAGE
+// ============================================================================
+
+#define PERSIST_DATA_MAX_LENGTH 256
+bool persist_exists(const uint32_t key);
+bool persist_read_bool(const uint32_t key);
+int32_t persist_read_int(const uint32_t key);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size);
+int persist_write_bool(const uint32_t key, const bool value);
+int persist_write_int(const uint32_t key, const int32_t value);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+int persist_write_string(const uint32_t key, const char *cstring);
+int persist_delete(const uint32_t key);
@@ -0,0 +1,1803 @@
+#include <malloc.h>
+#include <math.h>
+#include <stdarg.h>
+
+#include "host.h"
+
+// Host runtime behind pebble.h
+//
+// A deliberately small model of the firmware: one framebuffer, a layer tree
+// redrawn top-down whenever something is dirty, a virtual millisecond clock
+// that fires tick events and app timers in order, and in-memory AppMessage
+// and persist. Drawing is exact for rectangles, lines, circles, radials and
+// bitmaps; text is approximated with segmented boxes of the right size so
+// its pixel footprint is close without shipping the system fonts.
+
+#define HOST_START_TIME 1781516460ULL    // 2026-06-15 09:41:00 UTC
+#define MAX_TIMERS 32
+#define MAX_PERSIST 64
+#define MAX_WINDOWS 8
+#define DICT_BUFFER_SIZE 1024
+#define MAX_PENDING_SITES 32
+#define HOST_ACK_MS 100                  // Phone round trip before an outbox ack
+
+int pebble_app_main(void);
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+typedef enum { KIND_ROOT, KIND_PLAIN, KIND_TEXT, KIND_BITMAP } LayerKind;
+
+struct Layer {
+  GRect frame;
+  GRect bounds;
+  Layer *parent;
+  Layer *first_child;
+  Layer *next_sibling;
+  LayerUpdateProc update_proc;
+  bool hidden;
+  LayerKind kind;
+  void *owner;
+  uint8_t data[];
+};
+
+struct Window {
+  Layer *root;
+  WindowHandlers handlers;
+  GColor background;
+  bool loaded;
+};
+
+struct TextLayer {
+  Layer *layer;
+  const char *text;
+  GFont font;
+  GColor text_color;
+  GColor background;
+  GTextAlignment alignment;
+};
+
+struct BitmapLayer {
+  Layer *layer;
+  const GBitmap *bitmap;
+  GColor background;
+  GCompOp compositing;
+};
+
+struct GBitmap {
+  GRect bounds;
+  const uint8_t *argb;
+  int stride;
+  void *heap_data;        // stands in for the decoded pixels on the watch heap
+};
+
+// 32-bit firmware object sizes, charged to the heap model (approximate);
+// windows, text and bitmap layers embed their Layer there
+#define WATCH_LAYER_SIZE 40
+#define WATCH_WINDOW_SIZE 84
+#define WATCH_TEXT_LAYER_SIZE 64
+#define WATCH_BITMAP_LAYER_SIZE 52
+#define WATCH_GBITMAP_SIZE 24
+
+struct HostFont {
+  char key[32];
+  int size;
+  bool bold;
+  bool numbers;
+};
+
+struct GContext {
+  GPoint offset;          // absolute origin of the current layer's bounds
+  GRect clip;             // absolute
+  GColor fill;
+  GColor stroke;
+  GColor text;
+  uint8_t stroke_width;
+  GCompOp compositing;
+};
+
+struct AppTimer {
+  uint64_t when;
+  uint64_t seq;
+  AppTimerCallback callback;
+  void *data;
+  bool active;
+};
+
+static int s_argc;
+static char **s_argv;
+static uint64_t s_now_ms;
+static bool s_24h = true;
+
+static Window *s_windows[MAX_WINDOWS];
+static int s_window_count;
+static bool s_dirty;
+
+static HostFrame s_frame;
+static uint32_t s_stamp[HOST_SCREEN_W * HOST_SCREEN_H];
+static uint32_t s_primitive;
+static HostLayerStat *s_stat;
+static HostFrameHandler s_frame_handler;
+static HostCounters s_counters;
+
+static HostSite s_site;
+static struct {
+  const Layer *layer;
+  uint16_t inputs;
+} s_graph[HOST_MAX_LAYER_STATS];
+static int s_graph_count;
+static struct {
+  HostSite site;
+  uint16_t inputs;
+} s_pending[MAX_PENDING_SITES];
+static int s_pending_count;
+
+static TimeUnits s_tick_units;
+static TickHandler s_tick_handler;
+static AppTimer s_timers[MAX_TIMERS];
+static uint64_t s_timer_seq;
+
+static AccelTapHandler s_tap_handler;
+static BatteryChargeState s_battery = { .charge_percent = 80 };
+static BatteryStateHandler s_battery_handler;
+static bool s_connected = true;
+static ConnectionHandlers s_connection_handlers;
+static HealthEventHandler s_health_handler;
+static void *s_health_context;
+static HealthValue s_health[HEALTH_METRIC_COUNT];
+static uint16_t s_hr_sample_period_s;
+static uint64_t s_hr_sample_period_until_ms;
+
+struct HealthMetricAlert {
+  bool armed;
+  HealthMetric metric;
+  HealthValue threshold;
+};
+static HealthMetricAlert s_health_alerts[4];
+
+// Steps per minute for the last two days, filled from step count increases
+#define HOST_MINUTE_LOG (2 * 24 * 60)
+static uint16_t s_minute_steps[HOST_MINUTE_LOG];   // slot minute % HOST_MINUTE_LOG
+static uint64_t s_minute_newest;                    // minutes since the epoch of the newest slot
+
+static AppMessageInboxReceived s_inbox_handler;
+static uint8_t s_inbox_buffer[DICT_BUFFER_SIZE];
+static DictionaryIterator s_inbox;
+static uint8_t s_outbox_buffer[DICT_BUFFER_SIZE];
+static DictionaryIterator s_outbox;
+static HostOutboxHandler s_outbox_handler;
+static AppMessageOutboxSent s_outbox_sent;
+static AppMessageOutboxFailed s_outbox_failed;
+static AppTimer *s_ack_timer;
+
+static struct {
+  uint32_t key;
+  int size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} s_persist[MAX_PERSIST];
+static int s_persist_count;
+
+// ============================================================================
+// ENTRY POINT AND LOGGING
+// ============================================================================
+
+int main(int argc, char **argv) {
+  setenv("TZ", "UTC0", 1);
+  tzset();
+  const char *start = getenv("HOST_START_TIME");
+  s_now_ms = (start ? strtoull(start, NULL, 10) : HOST_START_TIME) * 1000ULL;
+  s_argc = argc;
+  s_argv = argv;
+  // The app's main() has no return statement, which only main() may omit
+  pebble_app_main();
+  return 0;
+}
+
+void app_event_loop(void) {
+  host_render();
+  host_scenario(s_argc, s_argv);
+}
+
+void host_log(int level, const char *fmt, ...) {
+  if (!getenv("HOST_LOG")) {
+    return;
+  }
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "[%llu] %d ", (unsigned long long)s_now_ms, level);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
+
+// ============================================================================
+// CLOCK
+// ============================================================================
+
+// The app's time() calls resolve here ahead of libc
+time_t time(time_t *tloc) {
+  time_t now = (time_t)(s_now_ms / 1000);
+  if (tloc) {
+    *tloc = now;
+  }
+  return now;
+}
+
+time_t time_start_of_today(void) {
+  time_t now = time(NULL);
+  struct tm midnight = *localtime(&now);
+  midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+  return mktime(&midnight);
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+  uint16_t ms = (uint16_t)(s_now_ms % 1000);
+  time(tloc);
+  if (out_ms) {
+    *out_ms = ms;
+  }
+  return ms;
+}
+
+// The heap model when built in, else the process heap as glibc counts it
+size_t heap_bytes_used(void) {
+#if HOST_HEAP_MODEL
+  return host_heap_stats()->used;
+#else
+  return mallinfo2().uordblks;
+#endif
+}
+
+size_t heap_bytes_free(void) {
+#if HOST_HEAP_MODEL
+  return host_heap_stats()->size - host_heap_stats()->used;
+#else
+  return mallinfo2().fordblks;
+#endif
+}
+
+uint64_t host_now_ms(void) {
+  return s_now_ms;
+}
+
+void host_set_24h(bool use_24h) {
+  s_24h = use_24h;
+}
+
+bool clock_is_24h_style(void) {
+  return s_24h;
+}
+
+const char *i18n_get_system_locale(void) {
+  const char *locale = getenv("HOST_LOCALE");
+  return locale ? locale : "en_US";
+}
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  s_tick_units = tick_units;
+  s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+  s_tick_units = 0;
+  s_tick_handler = NULL;
+}
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    if (!s_timers[i].active) {
+      s_timers[i] = (AppTimer){ s_now_ms + timeout_ms, s_timer_seq++, callback, callback_data, true };
+      return &s_timers[i];
+    }
+  }
+  fprintf(stderr, "host: out of app timers\n");
+  abort();
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+  if (!timer || !timer->active) {
+    return false;
+  }
+  timer->when = s_now_ms + new_timeout_ms;
+  timer->seq = s_timer_seq++;
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+  if (timer) {
+    timer->active = false;
+  }
+}
+
+static AppTimer *next_timer(void) {
+  AppTimer *next = NULL;
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    AppTimer *t = &s_timers[i];
+    if (t->active && (!next || t->when < next->when || (t->when == next->when && t->seq < next->seq))) {
+      next = t;
+    }
+  }
+  return next;
+}
+
+static TimeUnits units_between(time_t before, time_t after) {
+  struct tm a = *localtime(&before);
+  struct tm b = *localtime(&after);
+  TimeUnits units = SECOND_UNIT;
+  if (a.tm_min != b.tm_min || a.tm_hour != b.tm_hour || a.tm_yday != b.tm_yday) units |= MINUTE_UNIT;
+  if (a.tm_hour != b.tm_hour || a.tm_yday != b.tm_yday) units |= HOUR_UNIT;
+  if (a.tm_yday != b.tm_yday || a.tm_year != b.tm_year) units |= DAY_UNIT;
+  if (a.tm_mon != b.tm_mon || a.tm_year != b.tm_year) units |= MONTH_UNIT;
+  if (a.tm_year != b.tm_year) units |= YEAR_UNIT;
+  return units;
+}
+
+void host_run_until_ms(uint64_t when_ms) {
+  while (true) {
+    uint64_t next_second = (s_now_ms / 1000 + 1) * 1000;
+    AppTimer *timer = next_timer();
+    if (timer && timer->when <= next_second) {
+      if (timer->when > when_ms) {
+        break;
+      }
+      if (timer->when > s_now_ms) {
+        s_now_ms = timer->when;
+      }
+      AppTimerCallback callback = timer->callback;
+      void *data = timer->data;
+      timer->active = false;
+      s_counters.wakeups++;
+      s_counters.timer_events++;
+      callback(data);
+    } else {
+      if (next_second > when_ms) {
+        break;
+      }
+      time_t before = (time_t)(s_now_ms / 1000);
+      s_now_ms = next_second;
+      time_t now = (time_t)(s_now_ms / 1000);
+      TimeUnits changed = units_between(before, now);
+      if (s_tick_handler && (changed & s_tick_units)) {
+        s_counters.wakeups++;
+        s_counters.tick_events++;
+        s_tick_handler(localtime(&now), changed);
+      }
+    }
+    host_render();
+  }
+  s_now_ms = when_ms;
+}
+
+void host_run_for_ms(uint64_t duration_ms) {
+  host_run_until_ms(s_now_ms + duration_ms);
+}
+
+// ============================================================================
+// WINDOWS AND LAYERS
+// ============================================================================
+
+static void record_dirty(const Layer *layer, HostSite site, uint16_t inputs) {
+  for (int i = 0; i < s_frame.dirty_count; i++) {
+    HostDirty *d = &s_frame.dirty[i];
+    if (d->layer == layer && d->site.func == site.func && d->site.line == site.line) {
+      d->inputs |= inputs;
+      return;
+    }
+  }
+  if (s_frame.dirty_count < HOST_MAX_DIRTY) {
+    s_frame.dirty[s_frame.dirty_count++] = (HostDirty){ layer, site, inputs };
+  }
+}
+
+// Attributes the dirty to the pending call site; unhooked calls (the render
+// graph's own flush) are already covered by host_graph_flush()
+static void mark_dirty(const Layer *layer) {
+  s_dirty = true;
+  s_counters.dirty_marks++;
+  HostSite site = s_site;
+  s_site = (HostSite){ 0 };
+  if (!site.func) {
+    for (int i = 0; i < s_frame.dirty_count; i++) {
+      if (s_frame.dirty[i].layer == layer) {
+        return;
+      }
+    }
+  }
+  record_dirty(layer, site, 0);
+}
+
+static Layer *layer_alloc(GRect frame, size_t data_size, LayerKind kind, void *owner) {
+  host_heap_charge_next(WATCH_LAYER_SIZE + data_size);
+  Layer *layer = calloc(1, sizeof(Layer) + data_size);
+  if (!layer) {
+    return NULL;
+  }
+  layer->frame = frame;
+  layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+  layer->kind = kind;
+  layer->owner = owner;
+  return layer;
+}
+
+Window *window_create(void) {
+  host_heap_charge_next(WATCH_WINDOW_SIZE - WATCH_LAYER_SIZE);
+  Window *window = calloc(1, sizeof(Window));
+  if (!window) {
+    return NULL;
+  }
+  window->root = layer_alloc(GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H), 0, KIND_ROOT, window);
+  if (!window->root) {
+    free(window);
+    return NULL;
+  }
+  window->background = GColorWhite;
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (!window) {
+    return;
+  }
+  window_stack_remove(window, false);
+  layer_destroy(window->root);
+  free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor color) {
+  window->background = color;
+  mark_dirty(window->root);
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return window->root;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  (void)animated;
+  s_windows[s_window_count++] = window;
+  if (!window->loaded) {
+    window->loaded = true;
+    if (window->handlers.load) {
+      window->handlers.load(window);
+    }
+  }
+  if (window->handlers.appear) {
+    window->handlers.appear(window);
+  }
+  s_dirty = true;
+}
+
+bool window_stack_remove(Window *window, bool animated) {
+  (void)animated;
+  for (int i = 0; i < s_window_count; i++) {
+    if (s_windows[i] == window) {
+      memmove(&s_windows[i], &s_windows[i + 1], (size_t)(s_window_count - i - 1) * sizeof(Window *));
+      s_window_count--;
+      if (window->handlers.disappear) {
+        window->handlers.disappear(window);
+      }
+      if (window->loaded && window->handlers.unload) {
+        window->loaded = false;
+        window->handlers.unload(window);
+      }
+      s_dirty = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+Window *window_stack_get_top_window(void) {
+  return s_window_count ? s_windows[s_window_count - 1] : NULL;
+}
+
+Layer *layer_create(GRect frame) {
+  return layer_alloc(frame, 0, KIND_PLAIN, NULL);
+}
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+  return layer_alloc(frame, data_size, KIND_PLAIN, NULL);
+}
+
+void *layer_get_data(const Layer *layer) {
+  return (void *)layer->data;
+}
+
+void layer_destroy(Layer *layer) {
+  if (!layer) {
+    return;
+  }
+  layer_remove_from_parent(layer);
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    child->parent = NULL;
+  }
+  free(layer);
+}
+
+void layer_mark_dirty(Layer *layer) {
+  mark_dirty(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  layer_remove_from_parent(child);
+  child->parent = parent;
+  Layer **link = &parent->first_child;
+  while (*link) {
+    link = &(*link)->next_sibling;
+  }
+  *link = child;
+  s_dirty = true;
+}
+
+void layer_remove_from_parent(Layer *child) {
+  if (!child || !child->parent) {
+    return;
+  }
+  for (Layer **link = &child->parent->first_child; *link; link = &(*link)->next_sibling) {
+    if (*link == child) {
+      *link = child->next_sibling;
+      break;
+    }
+  }
+  child->parent = NULL;
+  child->next_sibling = NULL;
+  s_dirty = true;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden != hidden) {
+    layer->hidden = hidden;
+    mark_dirty(layer);
+  }
+}
+
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return layer->bounds;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  layer->frame = frame;
+  layer->bounds.size = frame.size;
+  mark_dirty(layer);
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  host_heap_charge_next(WATCH_TEXT_LAYER_SIZE - WATCH_LAYER_SIZE);
+  TextLayer *text_layer = calloc(1, sizeof(TextLayer));
+  if (!text_layer) {
+    return NULL;
+  }
+  text_layer->layer = layer_alloc(frame, 0, KIND_TEXT, text_layer);
+  if (!text_layer->layer) {
+    free(text_layer);
+    return NULL;
+  }
+  text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  text_layer->text_color = GColorBlack;
+  text_layer->background = GColorWhite;
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  if (text_layer) {
+    layer_destroy(text_layer->layer);
+    free(text_layer);
+  }
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  text_layer->text = text;
+  mark_dirty(text_layer->layer);
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+  text_layer->font = font;
+  mark_dirty(text_layer->layer);
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+  text_layer->text_color = color;
+  mark_dirty(text_layer->layer);
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  text_layer->background = color;
+  mark_dirty(text_layer->layer);
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment) {
+  text_layer->alignment = alignment;
+  mark_dirty(text_layer->layer);
+}
+
+BitmapLayer *bitmap_layer_create(GRect frame) {
+  host_heap_charge_next(WATCH_BITMAP_LAYER_SIZE - WATCH_LAYER_SIZE);
+  BitmapLayer *bitmap_layer = calloc(1, sizeof(BitmapLayer));
+  if (!bitmap_layer) {
+    return NULL;
+  }
+  bitmap_layer->layer = layer_alloc(frame, 0, KIND_BITMAP, bitmap_layer);
+  if (!bitmap_layer->layer) {
+    free(bitmap_layer);
+    return NULL;
+  }
+  bitmap_layer->background = GColorClear;
+  bitmap_layer->compositing = GCompOpAssign;
+  return bitmap_layer;
+}
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer) {
+  if (bitmap_layer) {
+    layer_destroy(bitmap_layer->layer);
+    free(bitmap_layer);
+  }
+}
+
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer) {
+  return bitmap_layer->layer;
+}
+
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap) {
+  bitmap_layer->bitmap = bitmap;
+  mark_dirty(bitmap_layer->layer);
+}
+
+void bitmap_layer_set_compositing_mode(BitmapLayer *bitmap_layer, GCompOp mode) {
+  bitmap_layer->compositing = mode;
+  mark_dirty(bitmap_layer->layer);
+}
+
+void bitmap_layer_set_background_color(BitmapLayer *bitmap_layer, GColor color) {
+  bitmap_layer->background = color;
+  mark_dirty(bitmap_layer->layer);
+}
+
+// ============================================================================
+// BITMAPS AND FONTS
+// ============================================================================
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+  if (resource_id == 0 || (int)resource_id > host_resource_count) {
+    return NULL;
+  }
+  const HostResource *resource = &host_resources[resource_id - 1];
+  host_heap_charge_next(WATCH_GBITMAP_SIZE);
+  GBitmap *bitmap = calloc(1, sizeof(GBitmap));
+  if (!bitmap) {
+    return NULL;
+  }
+#if HOST_HEAP_MODEL
+  host_heap_charge_next(resource->heap_bytes);
+  bitmap->heap_data = malloc(1);
+  if (!bitmap->heap_data) {
+    free(bitmap);
+    return NULL;
+  }
+#endif
+  bitmap->bounds = GRect(0, 0, resource->width, resource->height);
+  bitmap->argb = resource->argb;
+  bitmap->stride = resource->width;
+  return bitmap;
+}
+
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect) {
+  host_heap_charge_next(WATCH_GBITMAP_SIZE);
+  GBitmap *bitmap = calloc(1, sizeof(GBitmap));
+  if (!bitmap) {
+    return NULL;
+  }
+  *bitmap = *base_bitmap;
+  bitmap->heap_data = NULL;   // shares the base bitmap's pixels
+  bitmap->bounds = GRect(base_bitmap->bounds.origin.x + sub_rect.origin.x,
+                         base_bitmap->bounds.origin.y + sub_rect.origin.y,
+                         sub_rect.size.w, sub_rect.size.h);
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap) {
+    free(bitmap->heap_data);
+  }
+  free(bitmap);
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return bitmap->bounds;
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+  static struct HostFont s_fonts[16];
+  static int s_font_count;
+  for (int i = 0; i < s_font_count; i++) {
+    if (strcmp(s_fonts[i].key, font_key) == 0) {
+      return &s_fonts[i];
+    }
+  }
+  struct HostFont *font = &s_fonts[s_font_count++];
+  snprintf(font->key, sizeof(font->key), "%s", font_key);
+  const char *digits = strpbrk(font_key, "0123456789");
+  font->size = digits ? atoi(digits) : 14;
+  font->bold = strstr(font_key, "BOLD") != NULL;
+  font->numbers = strstr(font_key, "NUMBERS") != NULL;
+  return font;
+}
+
+// ============================================================================
+// RASTERISER
+// ============================================================================
+
+// Columns [x0, x1) of a screen row that exist on the display
+static void visible_row(int y, int *x0, int *x1) {
+#if defined(PBL_ROUND)
+  // Per-row span of the display circle, worked out once
+  static int16_t s_row_x0[HOST_SCREEN_H], s_row_x1[HOST_SCREEN_H];
+  static bool s_rows_ready;
+  if (!s_rows_ready) {
+    float r = HOST_SCREEN_W / 2.0f;
+    for (int row = 0; row < HOST_SCREEN_H; row++) {
+      float dy = row + 0.5f - HOST_SCREEN_H / 2.0f;
+      int first = HOST_SCREEN_W, last = 0;
+      for (int x = 0; x < HOST_SCREEN_W; x++) {
+        float dx = x + 0.5f - HOST_SCREEN_W / 2.0f;
+        if (dx * dx + dy * dy <= r * r) {
+          if (x < first) first = x;
+          last = x + 1;
+        }
+      }
+      s_row_x0[row] = (int16_t)first;
+      s_row_x1[row] = (int16_t)(last > first ? last : first);
+    }
+    s_rows_ready = true;
+  }
+  *x0 = s_row_x0[y];
+  *x1 = s_row_x1[y];
+#else
+  (void)y;
+  *x0 = 0;
+  *x1 = HOST_SCREEN_W;
+#endif
+}
+
+bool host_pixel_visible(int x, int y) {
+  if (x < 0 || y < 0 || x >= HOST_SCREEN_W || y >= HOST_SCREEN_H) {
+    return false;
+  }
+  int x0, x1;
+  visible_row(y, &x0, &x1);
+  return x >= x0 && x < x1;
+}
+
+// Local coordinates; one primitive never counts a pixel twice
+static inline void write_pixel(int index, GColor color) {
+  if (s_stamp[index] == s_primitive) {
+    s_frame.pixels[index] = color;
+    return;
+  }
+  s_stamp[index] = s_primitive;
+  if (s_frame.writes[index]++ && s_stat) {
+    s_stat->overdraw++;
+  }
+  if (s_stat) {
+    s_stat->writes++;
+    s_stat->hash = (s_stat->hash ^ ((uint64_t)index << 8 | color.argb)) * 0x100000001b3ULL;
+  }
+  s_frame.total_writes++;
+  s_frame.pixels[index] = color;
+}
+
+// Local coordinates, columns [x0, x1) of row y; clipped once for the whole run
+static void put_span(GContext *ctx, int y, int x0, int x1, GColor color) {
+  if ((color.argb & 0xC0) == 0) {
+    return;
+  }
+  int ay = y + ctx->offset.y;
+  if (ay < ctx->clip.origin.y || ay >= ctx->clip.origin.y + ctx->clip.size.h) {
+    return;
+  }
+  int vx0, vx1;
+  visible_row(ay, &vx0, &vx1);
+  int ax0 = x0 + ctx->offset.x, ax1 = x1 + ctx->offset.x;
+  if (ax0 < ctx->clip.origin.x) ax0 = ctx->clip.origin.x;
+  if (ax1 > ctx->clip.origin.x + ctx->clip.size.w) ax1 = ctx->clip.origin.x + ctx->clip.size.w;
+  if (ax0 < vx0) ax0 = vx0;
+  if (ax1 > vx1) ax1 = vx1;
+  for (int ax = ax0; ax < ax1; ax++) {
+    write_pixel(ay * HOST_SCREEN_W + ax, color);
+  }
+}
+
+static void put(GContext *ctx, int x, int y, GColor color) {
+  put_span(ctx, y, x, x + 1, color);
+}
+
+static void fill_box(GContext *ctx, int x, int y, int w, int h, GColor color) {
+  for (int yy = y; yy < y + h; yy++) {
+    put_span(ctx, yy, x, x + w, color);
+  }
+}
+
+static void brush(GContext *ctx, int x, int y) {
+  int w = ctx->stroke_width ? ctx->stroke_width : 1;
+  if (w == 1) {
+    put(ctx, x, y, ctx->stroke);
+    return;
+  }
+  float r = w / 2.0f;
+  for (int dy = -w; dy <= w; dy++) {
+    for (int dx = -w; dx <= w; dx++) {
+      if (dx * dx + dy * dy <= r * r) {
+        put(ctx, x + dx, y + dy, ctx->stroke);
+      }
+    }
+  }
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) { ctx->fill = color; }
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) { ctx->stroke = color; }
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width) { ctx->stroke_width = stroke_width; }
+void graphics_context_set_text_color(GContext *ctx, GColor color) { ctx->text = color; }
+void graphics_context_set_antialiased(GContext *ctx, bool enable) { (void)ctx; (void)enable; }
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) { ctx->compositing = mode; }
+
+void graphics_draw_pixel(GContext *ctx, GPoint point) {
+  s_primitive++;
+  put(ctx, point.x, point.y, ctx->stroke);
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+  s_primitive++;
+  int x = p0.x, y = p0.y;
+  int dx = abs(p1.x - p0.x), sx = p0.x < p1.x ? 1 : -1;
+  int dy = -abs(p1.y - p0.y), sy = p0.y < p1.y ? 1 : -1;
+  int err = dx + dy;
+  while (true) {
+    brush(ctx, x, y);
+    if (x == p1.x && y == p1.y) {
+      break;
+    }
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x += sx; }
+    if (e2 <= dx) { err += dx; y += sy; }
+  }
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+  s_primitive++;
+  int x0 = rect.origin.x, y0 = rect.origin.y;
+  int x1 = x0 + rect.size.w - 1, y1 = y0 + rect.size.h - 1;
+  for (int x = x0; x <= x1; x++) {
+    put(ctx, x, y0, ctx->stroke);
+    put(ctx, x, y1, ctx->stroke);
+  }
+  for (int y = y0; y <= y1; y++) {
+    put(ctx, x0, y, ctx->stroke);
+    put(ctx, x1, y, ctx->stroke);
+  }
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+  s_primitive++;
+  int r = corner_mask ? corner_radius : 0;
+  int w = rect.size.w, h = rect.size.h;
+  for (int y = 0; y < h; y++) {
+    // Rounded corners only trim the first and last r columns of a row
+    int inset = 0;
+    if (r && (y < r || y >= h - r)) {
+      int cy = y < r ? r : h - r - 1;
+      while (inset < r && (inset - r) * (inset - r) + (y - cy) * (y - cy) > r * r) {
+        inset++;
+      }
+    }
+    put_span(ctx, rect.origin.y + y, rect.origin.x + inset, rect.origin.x + w - inset, ctx->fill);
+  }
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  s_primitive++;
+  float half = (ctx->stroke_width ? ctx->stroke_width : 1) / 2.0f;
+  float outer2 = (radius + half) * (radius + half);
+  float inner2 = radius > half ? (radius - half) * (radius - half) : 0.0f;
+  int reach = radius + (int)half + 1;
+  for (int dy = -reach; dy <= reach; dy++) {
+    float rest = outer2 - (float)(dy * dy);
+    if (rest < 0) {
+      continue;
+    }
+    // Pixels with inner2 <= d^2 <= outer2, as one or two runs
+    int span = (int)sqrtf(rest);
+    float hole2 = inner2 - (float)(dy * dy);
+    int hole = hole2 > 0 ? (int)ceilf(sqrtf(hole2)) - 1 : -1;
+    if (hole < 0) {
+      put_span(ctx, p.y + dy, p.x - span, p.x + span + 1, ctx->stroke);
+    } else {
+      put_span(ctx, p.y + dy, p.x - span, p.x - hole, ctx->stroke);
+      put_span(ctx, p.y + dy, p.x + hole + 1, p.x + span + 1, ctx->stroke);
+    }
+  }
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  s_primitive++;
+  int r = radius;
+  for (int dy = -r; dy <= r; dy++) {
+    int reach = (int)sqrtf((float)(r * r + r - dy * dy));
+    put_span(ctx, p.y + dy, p.x - reach, p.x + reach + 1, ctx->fill);
+  }
+}
+
+// Stand-in for the angle clockwise from 12 o'clock: 0..4 per turn and
+// monotonic in the real angle, so comparisons hold without atan2f
+static float pseudo_angle(float up, float right) {
+  float q = 1.0f - up / (fabsf(up) + fabsf(right));
+  return right >= 0 ? q : 4.0f - q;
+}
+
+static float pseudo_trig_angle(int32_t angle) {
+  int32_t turns = angle >= 0 ? angle / TRIG_MAX_ANGLE : -((-angle + TRIG_MAX_ANGLE - 1) / TRIG_MAX_ANGLE);
+  double radians = (angle - turns * TRIG_MAX_ANGLE) * 2.0 * M_PI / TRIG_MAX_ANGLE;
+  return pseudo_angle((float)cos(radians), (float)sin(radians)) + 4.0f * (float)turns;
+}
+
+// Angles run clockwise from 12 o'clock, like the SDK
+void graphics_fill_radial(GContext *ctx, GRect rect, GOvalScaleMode scale_mode, uint16_t inset,
+                          int32_t angle_start, int32_t angle_end) {
+  (void)scale_mode;
+  s_primitive++;
+  float cx = rect.origin.x + rect.size.w / 2.0f;
+  float cy = rect.origin.y + rect.size.h / 2.0f;
+  float outer = (rect.size.w < rect.size.h ? rect.size.w : rect.size.h) / 2.0f;
+  float inner = outer - inset;
+  float outer2 = outer * outer;
+  float inner2 = inner > 0 ? inner * inner : 0;
+  bool full = angle_end - angle_start >= TRIG_MAX_ANGLE;
+  float start = full ? 0.0f : pseudo_trig_angle(angle_start);
+  float end = full ? 0.0f : pseudo_trig_angle(angle_end);
+  int left = rect.origin.x, right = rect.origin.x + rect.size.w;
+  for (int y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+    float dy = y + 0.5f - cy;
+    if (dy * dy > outer2) {
+      continue;
+    }
+    // Ring columns: [x0, hole0) and [hole1, x1)
+    float reach = sqrtf(outer2 - dy * dy);
+    int x0 = (int)ceilf(cx - reach - 0.5f), x1 = (int)floorf(cx + reach - 0.5f) + 1;
+    int hole0 = x1, hole1 = x1;
+    if (inner2 > dy * dy) {
+      float gap = sqrtf(inner2 - dy * dy);
+      hole0 = (int)floorf(cx - gap - 0.5f) + 1;
+      hole1 = (int)ceilf(cx + gap - 0.5f);
+    }
+    if (x0 < left) x0 = left;
+    if (x1 > right) x1 = right;
+    if (hole0 < x0) hole0 = x0;
+    if (hole1 > x1) hole1 = x1;
+    if (full) {
+      put_span(ctx, y, x0, hole0, ctx->fill);
+      put_span(ctx, y, hole1 > hole0 ? hole1 : hole0, x1, ctx->fill);
+      continue;
+    }
+    for (int x = x0; x < x1; x++) {
+      if (x == hole0 && hole1 > hole0) {
+        x = hole1 - 1;
+        continue;
+      }
+      float a = pseudo_angle(-dy, x + 0.5f - cx);
+      while (a < start) {
+        a += 4.0f;
+      }
+      if (a <= end) {
+        put(ctx, x, y, ctx->fill);
+      }
+    }
+  }
+}
+
+// Set composites the 2-bit alpha the colour variants keep over the frame
+static GColor blend_over(GContext *ctx, int x, int y, GColor color) {
+  int alpha = color.argb >> 6;
+  int ax = x + ctx->offset.x, ay = y + ctx->offset.y;
+  if (alpha == 0 || alpha == 3 || ax < 0 || ax >= HOST_SCREEN_W || ay < 0 || ay >= HOST_SCREEN_H) {
+    return color;
+  }
+  uint8_t dst = s_frame.pixels[ay * HOST_SCREEN_W + ax].argb;
+  uint8_t out = 0xC0;
+  for (int shift = 0; shift < 6; shift += 2) {
+    int c = ((color.argb >> shift & 3) * alpha + (dst >> shift & 3) * (3 - alpha) + 1) / 3;
+    out |= c << shift;
+  }
+  return GColorFromARGB8(out);
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  if (!bitmap || bitmap->bounds.size.w <= 0 || bitmap->bounds.size.h <= 0) {
+    return;
+  }
+  s_primitive++;
+  const GRect *b = &bitmap->bounds;
+  for (int y = 0; y < rect.size.h; y++) {
+    for (int x = 0; x < rect.size.w; x++) {
+      int sx = b->origin.x + x % b->size.w;
+      int sy = b->origin.y + y % b->size.h;
+      GColor color = GColorFromARGB8(bitmap->argb[sy * bitmap->stride + sx]);
+      if (ctx->compositing == GCompOpSet) {
+#if defined(PBL_BW)
+        // 1-bit Set only paints the white pixels
+        if (!gcolor_equal(color, GColorWhite)) {
+          continue;
+        }
+#else
+        color = blend_over(ctx, rect.origin.x + x, rect.origin.y + y, color);
+#endif
+      } else {
+        color.argb |= 0xC0;
+      }
+      put(ctx, rect.origin.x + x, rect.origin.y + y, color);
+    }
+  }
+}
+
+// ============================================================================
+// TEXT (approximate)
+// ============================================================================
+
+static const uint8_t DIGIT_SEGMENTS[10] = {
+  0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F,
+};
+
+static int glyph_advance(const struct HostFont *font) {
+  return font->numbers ? (font->size * 6) / 10 : font->size / 2;
+}
+
+static void draw_glyph(GContext *ctx, const struct HostFont *font, unsigned char c, int x, int y, GColor color) {
+  int w = glyph_advance(font) - 2;
+  int h = font->numbers ? (font->size * 3) / 4 : (font->size * 6) / 10;
+  int t = font->bold ? 2 : 1;
+  int top = y + (font->size - h) / 2 + 1;
+  if (w < 2 || c == ' ') {
+    return;
+  }
+  if (c == ':' || c == '.' || c == ',') {
+    fill_box(ctx, x + w / 2 - t / 2, top + h - t, t + 1, t + 1, color);
+    if (c == ':') {
+      fill_box(ctx, x + w / 2 - t / 2, top + h / 3, t + 1, t + 1, color);
+    }
+    return;
+  }
+  uint8_t mask = c >= '0' && c <= '9' ? DIGIT_SEGMENTS[c - '0'] : (uint8_t)(((c * 37u) & 0x7F) | 1);
+  int mid = top + (h - t) / 2;
+  if (mask & 0x01) fill_box(ctx, x, top, w, t, color);
+  if (mask & 0x02) fill_box(ctx, x + w - t, top, t, mid - top + t, color);
+  if (mask & 0x04) fill_box(ctx, x + w - t, mid, t, top + h - mid, color);
+  if (mask & 0x08) fill_box(ctx, x, top + h - t, w, t, color);
+  if (mask & 0x10) fill_box(ctx, x, mid, t, top + h - mid, color);
+  if (mask & 0x20) fill_box(ctx, x, top, t, mid - top + t, color);
+  if (mask & 0x40) fill_box(ctx, x, mid, w, t, color);
+}
+
+// Greedy wrap at spaces; returns line count and fills starts/lengths
+static int layout_lines(const char *text, const struct HostFont *font, GRect box, GTextOverflowMode mode,
+                        int *starts, int *lengths, int max_lines) {
+  int advance = glyph_advance(font);
+  int per_line = advance ? box.size.w / advance : 0;
+  int len = (int)strlen(text);
+  int fit = font->size ? box.size.h / font->size : 1;
+  if (fit < 1) fit = 1;
+  if (fit > max_lines) fit = max_lines;
+  int lines = 0, pos = 0;
+  while (pos < len && lines < fit) {
+    int n = len - pos;
+    const char *nl = memchr(text + pos, '\n', (size_t)n);
+    if (nl) n = (int)(nl - (text + pos));
+    if (mode != GTextOverflowModeTrailingEllipsis && per_line > 0 && n > per_line) {
+      int cut = per_line;
+      while (cut > 0 && text[pos + cut] != ' ') cut--;
+      n = cut > 0 ? cut : per_line;
+    }
+    starts[lines] = pos;
+    lengths[lines] = n;
+    lines++;
+    pos += n;
+    while (pos < len && (text[pos] == ' ' || text[pos] == '\n')) pos++;
+  }
+  return lines;
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow_mode, GTextAlignment alignment, void *text_attributes) {
+  (void)text_attributes;
+  if (!text || !font) {
+    return;
+  }
+  s_primitive++;
+  int starts[16], lengths[16];
+  int lines = layout_lines(text, font, box, overflow_mode, starts, lengths, 16);
+  int advance = glyph_advance(font);
+  for (int line = 0; line < lines; line++) {
+    int width = lengths[line] * advance;
+    int x = box.origin.x;
+    if (alignment == GTextAlignmentCenter) x += (box.size.w - width) / 2;
+    if (alignment == GTextAlignmentRight) x += box.size.w - width;
+    int y = box.origin.y + line * font->size;
+    for (int i = 0; i < lengths[line]; i++) {
+      draw_glyph(ctx, font, (unsigned char)text[starts[line] + i], x + i * advance + 1, y, ctx->text);
+    }
+  }
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment) {
+  (void)alignment;
+  if (!text || !font) {
+    return GSize(0, 0);
+  }
+  int starts[16], lengths[16];
+  int lines = layout_lines(text, font, box, overflow_mode, starts, lengths, 16);
+  int widest = 0;
+  for (int line = 0; line < lines; line++) {
+    if (lengths[line] > widest) widest = lengths[line];
+  }
+  return GSize(widest * glyph_advance(font), lines * font->size);
+}
+
+GPoint grect_center_point(const GRect *rect) {
+  return GPoint(rect->origin.x + rect->size.w / 2, rect->origin.y + rect->size.h / 2);
+}
+
+int32_t sin_lookup(int32_t angle) {
+  return (int32_t)lround(sin(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+  return (int32_t)lround(cos(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x) {
+  double a = atan2(y, x);
+  if (a < 0) {
+    a += 2.0 * M_PI;
+  }
+  return (int32_t)(a / (2.0 * M_PI) * TRIG_MAX_ANGLE) % TRIG_MAX_ANGLE;
+}
+
+// ============================================================================
+// FRAME RENDERING
+// ============================================================================
+
+static void begin_stat(const Layer *layer, const char *kind, GRect abs_frame) {
+  s_stat = NULL;
+  if (s_frame.layer_count < HOST_MAX_LAYER_STATS) {
+    s_stat = &s_frame.layers[s_frame.layer_count++];
+    *s_stat = (HostLayerStat){ layer, kind, (const void *)layer->update_proc, abs_frame, 0, 0, 0xcbf29ce484222325ULL };
+  }
+}
+
+static GRect intersect(GRect a, GRect b) {
+  int x0 = a.origin.x > b.origin.x ? a.origin.x : b.origin.x;
+  int y0 = a.origin.y > b.origin.y ? a.origin.y : b.origin.y;
+  int x1 = a.origin.x + a.size.w < b.origin.x + b.size.w ? a.origin.x + a.size.w : b.origin.x + b.size.w;
+  int y1 = a.origin.y + a.size.h < b.origin.y + b.size.h ? a.origin.y + a.size.h : b.origin.y + b.size.h;
+  return GRect(x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+}
+
+static void render_layer(Layer *layer, GPoint parent_origin, GRect clip) {
+  if (layer->hidden) {
+    return;
+  }
+  GRect abs_frame = GRect(parent_origin.x + layer->frame.origin.x, parent_origin.y + layer->frame.origin.y,
+                          layer->frame.size.w, layer->frame.size.h);
+  GRect layer_clip = intersect(clip, abs_frame);
+  GPoint origin = GPoint(abs_frame.origin.x + layer->bounds.origin.x, abs_frame.origin.y + layer->bounds.origin.y);
+
+  // The firmware hands every layer a freshly reset drawing state
+  GContext ctx = {
+    .offset = origin,
+    .clip = layer_clip,
+    .fill = GColorBlack,
+    .stroke = GColorBlack,
+    .text = GColorBlack,
+    .stroke_width = 1,
+    .compositing = GCompOpAssign,
+  };
+  GRect local = GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+
+  switch (layer->kind) {
+    case KIND_ROOT:
+      begin_stat(layer, "window", abs_frame);
+      ctx.fill = ((Window *)layer->owner)->background;
+      graphics_fill_rect(&ctx, local, 0, GCornerNone);
+      break;
+    case KIND_TEXT: {
+      TextLayer *text_layer = layer->owner;
+      begin_stat(layer, "text", abs_frame);
+      ctx.fill = text_layer->background;
+      graphics_fill_rect(&ctx, local, 0, GCornerNone);
+      ctx.text = text_layer->text_color;
+      graphics_draw_text(&ctx, text_layer->text, text_layer->font, local,
+                         GTextOverflowModeWordWrap, text_layer->alignment, NULL);
+      break;
+    }
+    case KIND_BITMAP: {
+      BitmapLayer *bitmap_layer = layer->owner;
+      begin_stat(layer, "bitmap", abs_frame);
+      ctx.fill = bitmap_layer->background;
+      graphics_fill_rect(&ctx, local, 0, GCornerNone);
+      if (bitmap_layer->bitmap) {
+        GSize size = bitmap_layer->bitmap->bounds.size;
+        ctx.compositing = bitmap_layer->compositing;
+        graphics_draw_bitmap_in_rect(&ctx, bitmap_layer->bitmap,
+                                     GRect((local.size.w - size.w) / 2, (local.size.h - size.h) / 2, size.w, size.h));
+      }
+      break;
+    }
+    case KIND_PLAIN:
+      begin_stat(layer, "layer", abs_frame);
+      break;
+  }
+  if (layer->update_proc) {
+    layer->update_proc(layer, &ctx);
+  }
+  s_stat = NULL;
+
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    render_layer(child, abs_frame.origin, layer_clip);
+  }
+}
+
+bool host_render(void) {
+  Window *window = window_stack_get_top_window();
+  if (!s_dirty || !window) {
+    return false;
+  }
+  s_dirty = false;
+  memset(s_frame.writes, 0, sizeof(s_frame.writes));
+  s_frame.total_writes = 0;
+  s_frame.layer_count = 0;
+  s_frame.time_ms = s_now_ms;
+  render_layer(window->root, GPoint(0, 0), GRect(0, 0, HOST_SCREEN_W, HOST_SCREEN_H));
+  s_counters.frames++;
+  s_counters.pixels_written += s_frame.total_writes;
+  if (s_frame_handler) {
+    s_frame_handler(&s_frame);
+  }
+  s_frame.index++;
+  s_frame.dirty_count = 0;
+  return true;
+}
+
+void host_set_frame_handler(HostFrameHandler handler) {
+  s_frame_handler = handler;
+}
+
+const HostCounters *host_counters(void) {
+  return &s_counters;
+}
+
+void host_reset_counters(void) {
+  s_counters = (HostCounters){ 0 };
+}
+
+static void count_service_event(void) {
+  s_counters.wakeups++;
+  s_counters.service_events++;
+}
+
+// ============================================================================
+// CALL SITES
+// ============================================================================
+
+void host_site(const char *func, const char *file, int line) {
+  s_site = (HostSite){ func, file, line };
+}
+
+static HostSite take_site(void) {
+  HostSite site = s_site;
+  s_site = (HostSite){ 0 };
+  return site;
+}
+
+void host_graph_add(const Layer *layer, uint16_t inputs) {
+  for (int i = 0; i < s_graph_count; i++) {
+    if (s_graph[i].layer == layer) {
+      s_graph[i].inputs = inputs;
+      return;
+    }
+  }
+  if (s_graph_count < HOST_MAX_LAYER_STATS) {
+    s_graph[s_graph_count].layer = layer;
+    s_graph[s_graph_count].inputs = inputs;
+    s_graph_count++;
+  }
+}
+
+void host_graph_remove(const Layer *layer) {
+  for (int i = 0; i < s_graph_count; i++) {
+    if (s_graph[i].layer == layer) {
+      s_graph[i] = s_graph[--s_graph_count];
+      return;
+    }
+  }
+}
+
+static void add_pending(HostSite site, uint16_t inputs) {
+  for (int i = 0; i < s_pending_count; i++) {
+    if (s_pending[i].site.func == site.func && s_pending[i].site.line == site.line) {
+      s_pending[i].inputs |= inputs;
+      return;
+    }
+  }
+  if (s_pending_count < MAX_PENDING_SITES) {
+    s_pending[s_pending_count].site = site;
+    s_pending[s_pending_count].inputs = inputs;
+    s_pending_count++;
+  }
+}
+
+void host_graph_invalidate(uint16_t changed) {
+  add_pending(take_site(), changed);
+}
+
+// Whatever the tick added on top of earlier invalidations belongs to its caller
+uint16_t host_graph_tick(uint16_t pending) {
+  uint16_t known = 0;
+  for (int i = 0; i < s_pending_count; i++) {
+    known |= s_pending[i].inputs;
+  }
+  HostSite site = take_site();
+  if (pending & ~known) {
+    add_pending(site, pending & ~known);
+  }
+  return pending;
+}
+
+void host_graph_flush(void) {
+  take_site();
+  for (int g = 0; g < s_graph_count; g++) {
+    for (int i = 0; i < s_pending_count; i++) {
+      uint16_t hit = s_graph[g].inputs & s_pending[i].inputs;
+      if (hit) {
+        record_dirty(s_graph[g].layer, s_pending[i].site, hit);
+      }
+    }
+  }
+  s_pending_count = 0;
+}
+
+// ============================================================================
+// EVENT SERVICES
+// ============================================================================
+
+void accel_tap_service_subscribe(AccelTapHandler handler) { s_tap_handler = handler; }
+void accel_tap_service_unsubscribe(void) { s_tap_handler = NULL; }
+
+void host_accel_tap(void) {
+  if (s_tap_handler) {
+    count_service_event();
+    s_tap_handler(ACCEL_AXIS_Y, 1);
+    host_render();
+  }
+}
+
+BatteryChargeState battery_state_service_peek(void) { return s_battery; }
+void battery_state_service_subscribe(BatteryStateHandler handler) { s_battery_handler = handler; }
+void battery_state_service_unsubscribe(void) { s_battery_handler = NULL; }
+
+void host_battery_event(uint8_t percent, bool charging) {
+  s_battery = (BatteryChargeState){ percent, charging, charging };
+  if (s_battery_handler) {
+    count_service_event();
+    s_battery_handler(s_battery);
+    host_render();
+  }
+}
+
+void connection_service_subscribe(ConnectionHandlers handlers) { s_connection_handlers = handlers; }
+void connection_service_unsubscribe(void) { s_connection_handlers = (ConnectionHandlers){ 0 }; }
+bool connection_service_peek_pebble_app_connection(void) { return s_connected; }
+
+void host_set_connected(bool connected) {
+  s_connected = connected;
+  if (s_connection_handlers.pebble_app_connection_handler) {
+    count_service_event();
+    s_connection_handlers.pebble_app_connection_handler(connected);
+    host_render();
+  }
+}
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+  s_health_handler = handler;
+  s_health_context = context;
+  return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+  s_health_handler = NULL;
+  return true;
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+  s_counters.health_calls++;
+  return metric < HEALTH_METRIC_COUNT ? s_health[metric] : 0;
+}
+
+HealthValue health_service_peek_current_value(HealthMetric metric) {
+  s_counters.health_calls++;
+  return metric < HEALTH_METRIC_COUNT ? s_health[metric] : 0;
+}
+
+HealthMetricAlert *health_service_register_metric_alert(HealthMetric metric, HealthValue threshold) {
+  if (metric >= HEALTH_METRIC_COUNT) return NULL;
+  for (size_t i = 0; i < ARRAY_LENGTH(s_health_alerts); i++) {
+    if (!s_health_alerts[i].armed) {
+      s_health_alerts[i] = (HealthMetricAlert){ .armed = true, .metric = metric, .threshold = threshold };
+      return &s_health_alerts[i];
+    }
+  }
+  return NULL;
+}
+
+bool health_service_cancel_metric_alert(HealthMetricAlert *alert) {
+  if (!alert || !alert->armed) return false;
+  alert->armed = false;
+  return true;
+}
+
+// Requests last an hour on the watch, then the default period applies again
+bool health_service_set_heart_rate_sample_period(uint16_t interval_sec) {
+  s_hr_sample_period_s = interval_sec;
+  s_hr_sample_period_until_ms = interval_sec ? s_now_ms + 3600 * 1000ULL : 0;
+  return true;
+}
+
+uint16_t health_service_get_heart_rate_sample_period_expiration_sec(void) {
+  if (!s_hr_sample_period_s || s_now_ms >= s_hr_sample_period_until_ms) return 0;
+  return (uint16_t)((s_hr_sample_period_until_ms - s_now_ms) / 1000);
+}
+
+static uint16_t minute_steps(uint64_t minute) {
+  if (minute > s_minute_newest || minute + HOST_MINUTE_LOG <= s_minute_newest) return 0;
+  return s_minute_steps[minute % HOST_MINUTE_LOG];
+}
+
+static void log_minute_steps(HealthValue steps) {
+  uint64_t minute = s_now_ms / 60000;
+  for (uint64_t m = s_minute_newest + 1; m <= minute && m + HOST_MINUTE_LOG > minute; m++) {
+    s_minute_steps[m % HOST_MINUTE_LOG] = 0;
+  }
+  if (minute > s_minute_newest) s_minute_newest = minute;
+  uint32_t total = s_minute_steps[minute % HOST_MINUTE_LOG] + (uint32_t)steps;
+  s_minute_steps[minute % HOST_MINUTE_LOG] = total > UINT16_MAX ? UINT16_MAX : (uint16_t)total;
+}
+
+// Whole minutes only, as the watch files them; the current one is still open
+uint32_t health_service_get_minute_history(HealthMinuteData *minute_data, uint32_t max_records,
+                                           time_t *time_start, time_t *time_end) {
+  s_counters.health_calls++;
+  if (!minute_data || !time_start || !time_end) return 0;
+  uint64_t now_minute = s_now_ms / 60000;
+  uint64_t first = (uint64_t)*time_start / 60;
+  uint64_t last = ((uint64_t)*time_end + 59) / 60;
+  if (first + HOST_MINUTE_LOG <= now_minute) first = now_minute - HOST_MINUTE_LOG + 1;
+  if (last > now_minute) last = now_minute;
+  if (first >= last) return 0;
+  uint32_t count = last - first < max_records ? (uint32_t)(last - first) : max_records;
+  for (uint32_t i = 0; i < count; i++) {
+    uint16_t steps = minute_steps(first + i);
+    minute_data[i] = (HealthMinuteData){ .steps = steps > UINT8_MAX ? UINT8_MAX : (uint8_t)steps };
+  }
+  *time_start = (time_t)(first * 60);
+  *time_end = (time_t)((first + count) * 60);
+  return count;
+}
+
+void host_health_set(HealthMetric metric, HealthValue value) {
+  if (metric < HEALTH_METRIC_COUNT) {
+    HealthValue previous = s_health[metric];
+    s_health[metric] = value;
+    if (metric == HealthMetricStepCount && value > previous) {
+      log_minute_steps(value - previous);
+    }
+    // An armed alert fires when the value crosses its threshold either way
+    for (size_t i = 0; i < ARRAY_LENGTH(s_health_alerts); i++) {
+      HealthMetricAlert *alert = &s_health_alerts[i];
+      if (alert->armed && alert->metric == metric &&
+          (previous < alert->threshold) != (value < alert->threshold)) {
+        host_health_event(HealthEventMetricAlert);
+        break;
+      }
+    }
+  }
+}
+
+void host_health_event(HealthEventType event) {
+  if (s_health_handler) {
+    count_service_event();
+    s_health_handler(event, s_health_context);
+    host_render();
+  }
+}
+
+// ============================================================================
+// DICTIONARIES AND APPMESSAGE
+// ============================================================================
+
+static void dict_begin(DictionaryIterator *iter, uint8_t *buffer) {
+  iter->buffer = buffer;
+  iter->cursor = buffer;
+  iter->end = buffer;
+  iter->count = 0;
+}
+
+static DictionaryResult dict_write(DictionaryIterator *iter, uint32_t key, TupleType type,
+                                   const void *data, uint16_t length) {
+  uint8_t *limit = iter->buffer + DICT_BUFFER_SIZE;
+  if (iter->end + sizeof(Tuple) + length > limit) {
+    return DICT_NOT_ENOUGH_STORAGE;
+  }
+  Tuple *tuple = (Tuple *)iter->end;
+  tuple->key = key;
+  tuple->type = type;
+  tuple->length = length;
+  memcpy(tuple->value->data, data, length);
+  iter->end += sizeof(Tuple) + length;
+  iter->count++;
+  return DICT_OK;
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+  iter->cursor = iter->buffer;
+  return dict_read_next(iter);
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+  if (iter->cursor >= iter->end) {
+    return NULL;
+  }
+  Tuple *tuple = (Tuple *)iter->cursor;
+  iter->cursor += sizeof(Tuple) + tuple->length;
+  return tuple;
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+  for (uint8_t *p = iter->buffer; p < iter->end; ) {
+    Tuple *tuple = (Tuple *)p;
+    if (tuple->key == key) {
+      return tuple;
+    }
+    p += sizeof(Tuple) + tuple->length;
+  }
+  return NULL;
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value) {
+  return dict_write(iter, key, TUPLE_UINT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value) {
+  return dict_write(iter, key, TUPLE_INT, &value, sizeof(value));
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char * const cstring) {
+  return dict_write(iter, key, TUPLE_CSTRING, cstring, (uint16_t)(strlen(cstring) + 1));
+}
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+  (void)size_inbound;
+  (void)size_outbound;
+  return APP_MSG_OK;
+}
+
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+  s_inbox_handler = received_callback;
+}
+
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {
+  AppMessageOutboxSent previous = s_outbox_sent;
+  s_outbox_sent = sent_callback;
+  return previous;
+}
+
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {
+  AppMessageOutboxFailed previous = s_outbox_failed;
+  s_outbox_failed = failed_callback;
+  return previous;
+}
+
+// Acked if the phone is still there when the round trip ends
+static void outbox_ack(void *data) {
+  s_ack_timer = NULL;
+  if (s_connected) {
+    if (s_outbox_sent) s_outbox_sent(&s_outbox, NULL);
+  } else if (s_outbox_failed) {
+    s_outbox_failed(&s_outbox, APP_MSG_SEND_TIMEOUT, NULL);
+  }
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+  if (!s_connected) {
+    return APP_MSG_NOT_CONNECTED;
+  }
+  if (s_ack_timer) {
+    return APP_MSG_BUSY;
+  }
+  dict_begin(&s_outbox, s_outbox_buffer);
+  *iterator = &s_outbox;
+  return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+  s_counters.outbox_messages++;
+  s_counters.bt_bytes += (uint32_t)(s_outbox.end - s_outbox.buffer);
+  if (s_outbox_handler) {
+    s_outbox_handler(&s_outbox);
+  }
+  s_ack_timer = app_timer_register(HOST_ACK_MS, outbox_ack, NULL);
+  return APP_MSG_OK;
+}
+
+void host_set_outbox_handler(HostOutboxHandler handler) {
+  s_outbox_handler = handler;
+}
+
+uint32_t host_message_key(const char *name) {
+  for (int i = 0; i < host_message_key_count; i++) {
+    if (strcmp(host_message_keys[i].name, name) == 0) {
+      return host_message_keys[i].key;
+    }
+  }
+  fprintf(stderr, "host: unknown message key %s\n", name);
+  exit(2);
+}
+
+void host_inbox_begin(void) {
+  dict_begin(&s_inbox, s_inbox_buffer);
+}
+
+void host_inbox_int(const char *key_name, int32_t value) {
+  dict_write_int32(&s_inbox, host_message_key(key_name), value);
+}
+
+void host_inbox_cstring(const char *key_name, const char *value) {
+  dict_write_cstring(&s_inbox, host_message_key(key_name), value);
+}
+
+void host_inbox_send(void) {
+  if (s_inbox_handler) {
+    s_counters.wakeups++;
+    s_counters.inbox_messages++;
+    s_counters.bt_bytes += (uint32_t)(s_inbox.end - s_inbox.buffer);
+    s_inbox.cursor = s_inbox.buffer;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    s_inbox_handler(&s_inbox, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    s_counters.inbox_ns += (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL + (uint64_t)end.tv_nsec -
+                           (uint64_t)start.tv_nsec;
+    host_render();
+  }
+}
+
+void host_inbox_send_pairs(int count, char **pairs) {
+  host_inbox_begin();
+  for (int i = 0; i < count; i++) {
+    char name[64];
+    const char *eq = strchr(pairs[i], '=');
+    if (!eq || eq - pairs[i] >= (int)sizeof(name)) {
+      fprintf(stderr, "host: expected NAME=value, got %s\n", pairs[i]);
+      exit(2);
+    }
+    snprintf(name, sizeof(name), "%.*s", (int)(eq - pairs[i]), pairs[i]);
+    char *end;
+    long value = strtol(eq + 1, &end, 10);
+    if (eq[1] && !*end) {
+      host_inbox_int(name, (int32_t)value);
+    } else {
+      host_inbox_cstring(name, eq + 1);
+    }
+  }
+  host_inbox_send();
+}
+
+// ============================================================================
+// PERSISTENT STORAGE
+// ============================================================================
+
+static int persist_find(uint32_t key) {
+  for (int i = 0; i < s_persist_count; i++) {
+    if (s_persist[i].key == key) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool persist_exists(const uint32_t key) {
+  return persist_find(key) >= 0;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  int i = persist_find(key);
+  if (i < 0) {
+    return -1;
+  }
+  size_t n = (size_t)s_persist[i].size < buffer_size ? (size_t)s_persist[i].size : buffer_size;
+  memcpy(buffer, s_persist[i].data, n);
+  return (int)n;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  int i = persist_find(key);
+  if (i < 0) {
+    if (s_persist_count == MAX_PERSIST) {
+      return -1;
+    }
+    i = s_persist_count++;
+    s_persist[i].key = key;
+  }
+  size_t n = size < PERSIST_DATA_MAX_LENGTH ? size : PERSIST_DATA_MAX_LENGTH;
+  s_counters.persist_writes++;
+  s_counters.persist_bytes += (uint32_t)n;
+  memcpy(s_persist[i].data, data, n);
+  s_persist[i].size = (int)n;
+  return (int)n;
+}
+
+bool persist_read_bool(const uint32_t key) {
+  bool value = false;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size) {
+  int n = persist_read_data(key, buffer, buffer_size);
+  if (n > 0) {
+    buffer[buffer_size - 1] = '\0';
+  }
+  return n;
+}
+
+int persist_write_bool(const uint32_t key, const bool value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_write_int(const uint32_t key, const int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_write_string(const uint32_t key, const char *cstring) {
+  return persist_write_data(key, cstring, strlen(cstring) + 1);
+}
+
+int persist_delete(const uint32_t key) {
+  int i = persist_find(key);
+  if (i >= 0) {
+    s_persist[i] = s_persist[--s_persist_count];
+  }
+  return 0;
+}
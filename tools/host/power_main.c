@@ -0,0 +1,120 @@
+#include <time.h>
+
+#include "host.h"
+
+// Power scenario
+//
+// Runs the face for a simulated day against a fixed event script: ticks,
+// movement updates while awake (some with new steps, some without), sleep
+// updates at night, a battery reading per percent lost from --battery, wrist
+// taps, and a weather push every --weather-minutes plus a reply to every
+// REQUEST_WEATHER. Prints the host counters for tools/power_model.py:
+//
+//   <counter> <value>
+//
+// Usage: power [--hours N] [--weather-minutes N] [--battery N] [NAME=value ...]
+
+static const char WEATHER[] =
+    "{\"temperature\":18,\"weatherCode\":2,\"sunrise\":\"05:31\",\"sunset\":\"21:12\",\"moonPhase\":3}";
+
+static bool s_weather_requested;
+
+static void outbox_handler(DictionaryIterator *iter) {
+  if (dict_find(iter, host_message_key("REQUEST_WEATHER"))) {
+    s_weather_requested = true;
+  }
+}
+
+static void push_weather(void) {
+  host_inbox_begin();
+  host_inbox_cstring("WEATHER_DATA", WEATHER);
+  host_inbox_send();
+}
+
+void host_scenario(int argc, char **argv) {
+  int hours = 24;
+  int weather_minutes = 60;
+  int battery = 90;
+  char *pairs[64];
+  int pair_count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+      hours = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--weather-minutes") == 0 && i + 1 < argc) {
+      weather_minutes = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--battery") == 0 && i + 1 < argc) {
+      battery = atoi(argv[++i]);
+    } else if (pair_count < 64) {
+      pairs[pair_count++] = argv[i];
+    }
+  }
+
+  int steps = 3200;
+  host_health_set(HealthMetricStepCount, steps);
+  host_health_set(HealthMetricWalkedDistanceMeters, steps * 3 / 4);
+  host_health_set(HealthMetricHeartRateBPM, 68);
+  host_set_outbox_handler(outbox_handler);
+  host_run_for_ms(3000);
+  if (pair_count) {
+    host_inbox_send_pairs(pair_count, pairs);
+  }
+  host_run_for_ms(1000);
+  host_battery_event((uint8_t)battery, false);
+
+  // Settings, splash and the first layout are not part of a normal day
+  host_reset_counters();
+  for (int minute = 0; minute < hours * 60; minute++) {
+    host_run_for_ms(30 * 1000);
+
+    time_t now = (time_t)(host_now_ms() / 1000);
+    int hour = localtime(&now)->tm_hour;
+    bool awake = hour >= 7 && hour < 23;
+    if (hour == 0 && localtime(&now)->tm_min == 0) {
+      steps = 0;
+      host_health_set(HealthMetricStepCount, steps);
+    }
+    if (awake && minute % 10 == 0) {
+      // Roughly 9000 steps over the waking day, with idle stretches
+      int walked = (minute * 37) % 300;
+      if (walked >= 60) {
+        steps += walked;
+        host_health_set(HealthMetricStepCount, steps);
+        host_health_set(HealthMetricWalkedDistanceMeters, steps * 3 / 4);
+      }
+      host_health_event(HealthEventMovementUpdate);
+    }
+    if (!awake && minute % 60 == 0) {
+      host_health_event(HealthEventSleepUpdate);
+    }
+    if (awake && minute % 80 == 40) {
+      host_accel_tap();
+    }
+    if (minute % 96 == 95 && battery > 5) {
+      host_battery_event((uint8_t)--battery, false);
+    }
+    if (weather_minutes > 0 && minute % weather_minutes == weather_minutes - 1) {
+      push_weather();
+    }
+    if (s_weather_requested) {
+      s_weather_requested = false;
+      push_weather();
+    }
+
+    host_run_for_ms(30 * 1000);
+  }
+
+  const HostCounters *c = host_counters();
+  printf("hours %d\n", hours);
+  printf("wakeups %u\n", c->wakeups);
+  printf("tick_events %u\n", c->tick_events);
+  printf("timer_events %u\n", c->timer_events);
+  printf("service_events %u\n", c->service_events);
+  printf("frames %u\n", c->frames);
+  printf("pixels_written %llu\n", (unsigned long long)c->pixels_written);
+  printf("health_calls %u\n", c->health_calls);
+  printf("persist_writes %u\n", c->persist_writes);
+  printf("persist_bytes %u\n", c->persist_bytes);
+  printf("inbox_messages %u\n", c->inbox_messages);
+  printf("outbox_messages %u\n", c->outbox_messages);
+  printf("bt_bytes %u\n", c->bt_bytes);
+}
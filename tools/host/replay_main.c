@@ -0,0 +1,160 @@
+#include <malloc.h>
+
+#include "host.h"
+#include "shared_modules/work_queue_module.h"
+
+// AppMessage replay scenario
+//
+// Feeds a message trace into the app's inbox_received_handler one message at
+// a time and reports what each one cost: wall-clock time in the handler and
+// in handler plus redraw, persist writes, layer invalidations, frames and
+// pixels drawn, and the change in live heap once the redraw is done. Costs
+// include the work the handler deferred to the work queue: the clock is run
+// past the last slot the queue could need before the counters are read. The
+// trace is written by tools/replay.py from pkjs "Trace:" log lines:
+//
+//   message <time_ms> <kind>
+//   int <KEY> <value>
+//   str <KEY> <value to end of line>
+//   send
+//
+// Messages are spaced --gap-ms apart (after that deferred work); with
+// --real-time the trace's own timestamps are kept, ticks included. Report
+// on stdout:
+//
+//   message <index> <kind> <bytes> <handler_ns> <total_ns> <persist_writes>
+//           <persist_bytes> <dirty_marks> <frames> <pixels> <heap_delta>
+//
+// Usage: replay --trace FILE [--gap-ms N] [--real-time] [NAME=value ...]
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+// volatile: GCC otherwise assumes malloc leaves globals alone
+static volatile int64_t s_heap_live;
+
+// Live heap in bytes, as the allocator rounded the requests
+void *malloc(size_t size) {
+  void *ptr = __libc_malloc(size);
+  s_heap_live += ptr ? (int64_t)malloc_usable_size(ptr) : 0;
+  return ptr;
+}
+
+void *calloc(size_t count, size_t size) {
+  void *ptr = __libc_calloc(count, size);
+  s_heap_live += ptr ? (int64_t)malloc_usable_size(ptr) : 0;
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+  int64_t before = ptr ? (int64_t)malloc_usable_size(ptr) : 0;
+  void *result = __libc_realloc(ptr, size);
+  if (result || !size) {
+    s_heap_live += (result ? (int64_t)malloc_usable_size(result) : 0) - before;
+  }
+  return result;
+}
+
+void free(void *ptr) {
+  if (ptr) {
+    s_heap_live -= (int64_t)malloc_usable_size(ptr);
+  }
+  __libc_free(ptr);
+}
+
+// ============================================================================
+// REPLAY
+// ============================================================================
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Long enough for a full queue to run one job per slot
+#define WORK_QUEUE_SETTLE_MS (WORK_QUEUE_FIRST_DELAY_MS + WORK_QUEUE_SIZE * WORK_QUEUE_SPACING_MS)
+
+static void send_message(int index, const char *kind) {
+  HostCounters before = *host_counters();
+  int64_t heap_before = s_heap_live;
+  uint64_t start = now_ns();
+  host_inbox_send();
+  host_run_for_ms(WORK_QUEUE_SETTLE_MS);
+  uint64_t total = now_ns() - start;
+  const HostCounters *after = host_counters();
+
+  printf("message %d %s %u %llu %llu %u %u %u %u %llu %lld\n", index, kind,
+         after->bt_bytes - before.bt_bytes,
+         (unsigned long long)(after->inbox_ns - before.inbox_ns), (unsigned long long)total,
+         after->persist_writes - before.persist_writes, after->persist_bytes - before.persist_bytes,
+         after->dirty_marks - before.dirty_marks, after->frames - before.frames,
+         (unsigned long long)(after->pixels_written - before.pixels_written),
+         (long long)(s_heap_live - heap_before));
+}
+
+void host_scenario(int argc, char **argv) {
+  const char *trace_path = NULL;
+  int gap_ms = 1000;
+  bool real_time = false;
+  char *pairs[64];
+  int pair_count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      trace_path = argv[++i];
+    } else if (strcmp(argv[i], "--gap-ms") == 0 && i + 1 < argc) {
+      gap_ms = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--real-time") == 0) {
+      real_time = true;
+    } else if (pair_count < 64) {
+      pairs[pair_count++] = argv[i];
+    }
+  }
+  FILE *trace = trace_path ? fopen(trace_path, "r") : NULL;
+  if (!trace) {
+    fprintf(stderr, "replay: cannot open trace %s\n", trace_path ? trace_path : "(none)");
+    exit(2);
+  }
+
+  host_health_set(HealthMetricStepCount, 6400);
+  host_health_set(HealthMetricWalkedDistanceMeters, 4700);
+  host_health_set(HealthMetricHeartRateBPM, 68);
+  host_run_for_ms(3000);
+  if (pair_count) {
+    host_inbox_send_pairs(pair_count, pairs);
+  }
+  host_run_for_ms(1000);
+
+  // Timestamps are relative to the first message
+  uint64_t start_ms = host_now_ms();
+  long long first_time = -1;
+  char line[2048];
+  char kind[32] = "message";
+  int index = 0;
+  while (fgets(line, sizeof(line), trace)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char key[64];
+    long long time_ms, value;
+    int offset = 0;
+    if (sscanf(line, "message %lld %31s", &time_ms, kind) == 2) {
+      if (first_time < 0) {
+        first_time = time_ms;
+      }
+      if (real_time && time_ms > first_time) {
+        host_run_until_ms(start_ms + (uint64_t)(time_ms - first_time));
+      } else if (!real_time) {
+        host_run_for_ms((uint32_t)gap_ms);
+      }
+      host_inbox_begin();
+    } else if (sscanf(line, "int %63s %lld", key, &value) == 2) {
+      host_inbox_int(key, (int32_t)value);
+    } else if (sscanf(line, "str %63s %n", key, &offset) == 1 && offset) {
+      host_inbox_cstring(key, line + offset);
+    } else if (strcmp(line, "send") == 0) {
+      send_message(index++, kind);
+    }
+  }
+  fclose(trace);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "pebble.h"
+#include "host.h"
+#include "shared_modules/render_graph_module.h"
+
+// Call-site hooks, force-included into every app source except the render
+// graph module itself (tools/host_build.py, hooks=)
+//
+// Each call that can dirty a layer first records __func__/__FILE__/__LINE__
+// so the host can attribute the resulting redraw. The render graph calls are
+// mirrored too: a flush marks layers dirty from inside render_graph_module.c,
+// so it is traced back to the invalidate or tick calls that made it pending.
+// The real headers are included above first, so their declarations are not
+// rewritten.
+
+#define HOST_AT(call) (host_site(__func__, __FILE__, __LINE__), call)
+
+#define layer_mark_dirty(layer) HOST_AT(layer_mark_dirty(layer))
+#define layer_set_hidden(layer, hidden) HOST_AT(layer_set_hidden(layer, hidden))
+#define layer_set_frame(layer, frame) HOST_AT(layer_set_frame(layer, frame))
+#define text_layer_set_text(text_layer, text) HOST_AT(text_layer_set_text(text_layer, text))
+#define text_layer_set_font(text_layer, font) HOST_AT(text_layer_set_font(text_layer, font))
+#define text_layer_set_text_color(text_layer, color) HOST_AT(text_layer_set_text_color(text_layer, color))
+#define text_layer_set_background_color(text_layer, color) \
+  HOST_AT(text_layer_set_background_color(text_layer, color))
+#define bitmap_layer_set_bitmap(bitmap_layer, bitmap) HOST_AT(bitmap_layer_set_bitmap(bitmap_layer, bitmap))
+#define window_set_background_color(window, color) HOST_AT(window_set_background_color(window, color))
+
+#define render_graph_add(layer, inputs) (host_graph_add((layer), (inputs)), render_graph_add(layer, inputs))
+#define render_graph_remove(layer) (host_graph_remove(layer), render_graph_remove(layer))
+#define render_graph_invalidate(changed) HOST_AT((host_graph_invalidate(changed), render_graph_invalidate(changed)))
+#define render_graph_tick(tick_time) HOST_AT(host_graph_tick(render_graph_tick(tick_time)))
+#define render_graph_flush() HOST_AT((host_graph_flush(), render_graph_flush()))
@@ -0,0 +1,174 @@
+#include "host.h"
+
+// Wasted-frame scenario (build with hooks=site_hooks.h)
+//
+// Drives the face through a simulated hour of ticks plus the events that
+// usually arrive in that time - movement updates with and without new steps,
+// an unchanged battery reading and a repeated weather push - and checks every
+// frame against the one before. A dirtied layer whose pixels came out
+// identical is a wasted invalidation and is charged to the call site that
+// dirtied it. Report on stdout for tools/wasted_frames.py:
+//
+//   frames <n> identical <k>
+//   site <func> <file> <line> <inputs> <kind> <proc> <dirties> <wasted>
+//
+// Usage: wasted [--minutes N] [NAME=value ...]
+
+#define MAX_SITES 128
+#define MAX_TRACKED 64
+
+typedef struct {
+  HostSite site;
+  uint16_t inputs;
+  const Layer *layer;
+  const char *kind;
+  const void *proc;
+  uint32_t dirties;
+  uint32_t wasted;
+} SiteTotal;
+
+static bool s_measuring;
+static bool s_have_previous;
+static GColor8 s_previous[HOST_SCREEN_W * HOST_SCREEN_H];
+static uint32_t s_frames;
+static uint32_t s_identical;
+static SiteTotal s_sites[MAX_SITES];
+static int s_site_count;
+static struct {
+  const Layer *layer;
+  uint64_t hash;
+} s_hashes[MAX_TRACKED];
+static int s_hash_count;
+
+static const char WEATHER[] =
+    "{\"temperature\":18,\"weatherCode\":2,\"sunrise\":\"05:31\",\"sunset\":\"21:12\",\"moonPhase\":3}";
+
+static const HostLayerStat *find_stat(const HostFrame *frame, const Layer *layer) {
+  for (int i = 0; i < frame->layer_count; i++) {
+    if (frame->layers[i].layer == layer) {
+      return &frame->layers[i];
+    }
+  }
+  return NULL;
+}
+
+// Hash of the layer's output in the previous frame; 0 when it was not drawn
+static uint64_t *previous_hash(const Layer *layer) {
+  for (int i = 0; i < s_hash_count; i++) {
+    if (s_hashes[i].layer == layer) {
+      return &s_hashes[i].hash;
+    }
+  }
+  if (s_hash_count == MAX_TRACKED) {
+    return NULL;
+  }
+  s_hashes[s_hash_count].layer = layer;
+  s_hashes[s_hash_count].hash = 0;
+  return &s_hashes[s_hash_count++].hash;
+}
+
+static SiteTotal *site_total(const HostDirty *dirty, const HostLayerStat *stat) {
+  for (int i = 0; i < s_site_count; i++) {
+    SiteTotal *t = &s_sites[i];
+    if (t->layer == dirty->layer && t->site.func == dirty->site.func &&
+        t->site.line == dirty->site.line && t->inputs == dirty->inputs) {
+      return t;
+    }
+  }
+  if (s_site_count == MAX_SITES) {
+    return NULL;
+  }
+  SiteTotal *t = &s_sites[s_site_count++];
+  *t = (SiteTotal){ dirty->site, dirty->inputs, dirty->layer,
+                    stat ? stat->kind : "hidden", stat ? stat->proc : NULL, 0, 0 };
+  return t;
+}
+
+static void frame_handler(const HostFrame *frame) {
+  if (s_measuring && s_have_previous) {
+    s_frames++;
+    if (memcmp(s_previous, frame->pixels, sizeof(s_previous)) == 0) {
+      s_identical++;
+    }
+    for (int i = 0; i < frame->dirty_count; i++) {
+      const HostDirty *dirty = &frame->dirty[i];
+      const HostLayerStat *stat = find_stat(frame, dirty->layer);
+      uint64_t *before = previous_hash(dirty->layer);
+      SiteTotal *total = site_total(dirty, stat);
+      if (!total || !before) {
+        continue;
+      }
+      total->dirties++;
+      if (*before == (stat ? stat->hash : 0)) {
+        total->wasted++;
+      }
+    }
+  }
+
+  // Remember every layer's output, dirtied or not
+  for (int i = 0; i < s_hash_count; i++) {
+    s_hashes[i].hash = 0;
+  }
+  for (int i = 0; i < frame->layer_count; i++) {
+    uint64_t *hash = previous_hash(frame->layers[i].layer);
+    if (hash) {
+      *hash = frame->layers[i].hash;
+    }
+  }
+  memcpy(s_previous, frame->pixels, sizeof(s_previous));
+  s_have_previous = true;
+}
+
+void host_scenario(int argc, char **argv) {
+  int minutes = 60;
+  char *pairs[64];
+  int pair_count = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--minutes") == 0 && i + 1 < argc) {
+      minutes = atoi(argv[++i]);
+    } else if (pair_count < 64) {
+      pairs[pair_count++] = argv[i];
+    }
+  }
+
+  int steps = 6400;
+  host_health_set(HealthMetricStepCount, steps);
+  host_health_set(HealthMetricWalkedDistanceMeters, 4700);
+  host_health_set(HealthMetricHeartRateBPM, 68);
+  host_set_frame_handler(frame_handler);
+  host_run_for_ms(3000);
+  if (pair_count) {
+    host_inbox_send_pairs(pair_count, pairs);
+  }
+  host_run_for_ms(1000);
+
+  s_measuring = true;
+  for (int minute = 0; minute < minutes; minute++) {
+    host_run_for_ms(20 * 1000);
+    if (minute % 5 == 2) {
+      // Movement updates arrive whether or not steps were taken
+      if (minute % 10 == 2) {
+        steps += 120;
+        host_health_set(HealthMetricStepCount, steps);
+      }
+      host_health_event(HealthEventMovementUpdate);
+    }
+    if (minute % 15 == 7) {
+      host_battery_event(80, false);
+    }
+    if (minute % 30 == 12) {
+      host_inbox_begin();
+      host_inbox_cstring("WEATHER_DATA", WEATHER);
+      host_inbox_send();
+    }
+    host_run_for_ms(40 * 1000);
+  }
+
+  printf("frames %u identical %u\n", s_frames, s_identical);
+  for (int i = 0; i < s_site_count; i++) {
+    const SiteTotal *t = &s_sites[i];
+    printf("site %s %s %d %u %s %p %u %u\n",
+           t->site.func ? t->site.func : "-", t->site.file ? t->site.file : "-", t->site.line,
+           t->inputs, t->kind, t->proc, t->dirties, t->wasted);
+  }
+}
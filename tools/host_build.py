@@ -0,0 +1,243 @@
+#!/usr/bin/env python
+"""
+Host build of a Constellation edition.
+
+Compiles an edition's C sources together with the shared modules, the SDK
+shim in tools/host and a scenario driver into a native executable, so the
+watchface can be run and measured on the desktop (see tools/overdraw.py).
+
+For the chosen platform this generates, under <edition>/build/host/<platform>/:
+
+  host_ids.h         RESOURCE_ID_* and MESSAGE_KEY_* in package.json order,
+                     message keys numbered from 10000 like the SDK
+  host_resources.c   every bitmap quantised the way the SDK variant would be,
+                     with its heap cost, plus the message key name table
+
+Usage:
+  python tools/host_build.py <edition-dir> <platform> <driver.c> [-DNAME ...]
+
+Every *_PERSIST_KEY defined in the sources is checked against the message
+key range (settings persist under their MESSAGE_KEY_* ids) and the build
+stops if two keys would share a persist slot.
+
+Needs a host C compiler (cc / gcc / clang) and nothing from the Pebble SDK.
+"""
+from __future__ import print_function
+
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+import bitmap_pipeline
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+HOST_DIR = os.path.join(ROOT, 'tools', 'host')
+SHARED_C = os.path.join(ROOT, 'shared', 'src', 'c')
+SHARED_DIRS = ['shared_modules', 'utilities']
+PLATFORMS = ['aplite', 'basalt', 'chalk', 'diorite', 'emery', 'flint', 'gabbro']
+CFLAGS = ['-std=gnu11', '-g', '-O1', '-no-pie', '-Wall', '-Wno-unused-function']
+APP_FLAGS = ['-Dmain=pebble_app_main', '-Wno-return-type', '-Wno-unused-variable']
+UNHOOKED = ['render_graph_module.c']
+FIRST_MESSAGE_KEY = 10000
+PERSIST_KEY_DEFINE = re.compile(r'^\s*#define\s+(\w+_PERSIST_KEY)\s+(\d+)\b', re.M)
+
+# ============================================================================
+# GENERATED SOURCES
+# ============================================================================
+
+def _group(platform):
+    for group, members in bitmap_pipeline.PLATFORM_GROUPS.items():
+        if platform in members:
+            return group
+    raise ValueError('unknown platform %s' % platform)
+
+
+def _argb8(px):
+    # Rows are already quantised, so alpha is one of the four GColor8 levels
+    r, g, b, a = px
+    return (a >> 6) << 6 | (r >> 6) << 4 | (g >> 6) << 2 | (b >> 6)
+
+
+def write_generated(edition, platform, out_dir):
+    with open(os.path.join(edition, 'package.json')) as f:
+        manifest = json.load(f)
+    media = manifest['pebble']['resources']['media']
+    keys = manifest['pebble'].get('messageKeys', [])
+
+    ids = ['#pragma once', '// Generated by tools/host_build.py']
+    for i, entry in enumerate(media):
+        ids.append('#define RESOURCE_ID_%s %d' % (entry['name'], i + 1))
+    for i, key in enumerate(keys):
+        ids.append('#define MESSAGE_KEY_%s %d' % (key, FIRST_MESSAGE_KEY + i))
+
+    src = ['// Generated by tools/host_build.py', '#include "host.h"', '']
+    table = []
+    for i, entry in enumerate(media):
+        source = None
+        if entry.get('type') == 'bitmap':
+            source = bitmap_pipeline.resolve_source(edition, entry['file'])
+        if not source:
+            table.append('  { "%s", 0, 0, NULL, 0 },' % entry['name'])
+            continue
+        width, height, rows = bitmap_pipeline.read_png(source)
+        rows = bitmap_pipeline.quantise(rows, _group(platform))
+        heap = bitmap_pipeline.heap_bytes(width, height, bitmap_pipeline.smallest_format(rows))
+        pixels = [_argb8(px) for row in rows for px in row]
+        src.append('static const uint8_t s_res_%d[] = {' % i)
+        for start in range(0, len(pixels), 24):
+            src.append('  ' + ', '.join('0x%02x' % v for v in pixels[start:start + 24]) + ',')
+        src.append('};')
+        table.append('  { "%s", %d, %d, s_res_%d, %d },' % (entry['name'], width, height, i, heap))
+
+    src.append('')
+    src.append('const HostResource host_resources[] = {')
+    src.extend(table or ['  { "", 0, 0, NULL, 0 },'])
+    src.append('};')
+    src.append('const int host_resource_count = %d;' % len(media))
+    src.append('')
+    src.append('const HostMessageKey host_message_keys[] = {')
+    src.extend('  { "%s", %d },' % (key, FIRST_MESSAGE_KEY + i) for i, key in enumerate(keys))
+    src.append('  { "", 0 },')
+    src.append('};')
+    src.append('const int host_message_key_count = %d;' % len(keys))
+
+    with open(os.path.join(out_dir, 'host_ids.h'), 'w') as f:
+        f.write('\n'.join(ids) + '\n')
+    with open(os.path.join(out_dir, 'host_resources.c'), 'w') as f:
+        f.write('\n'.join(src) + '\n')
+
+# ============================================================================
+# PERSIST KEYS
+# ============================================================================
+
+def check_persist_keys(src_dir, message_keys):
+    """Raises if a *_PERSIST_KEY collides with a message key or another persist key."""
+    taken = dict((FIRST_MESSAGE_KEY + i, 'MESSAGE_KEY_' + key) for i, key in enumerate(message_keys))
+    for base, _, files in os.walk(src_dir):
+        for name in sorted(files):
+            if not name.endswith(('.c', '.h')):
+                continue
+            with open(os.path.join(base, name)) as f:
+                defines = PERSIST_KEY_DEFINE.findall(f.read())
+            for macro, value in defines:
+                owner = taken.setdefault(int(value), macro)
+                if owner != macro:
+                    raise ValueError('%s (%s) shares its persist slot with %s' % (macro, value, owner))
+
+# ============================================================================
+# BUILD
+# ============================================================================
+
+def _mirror(edition, src_dir):
+    """Edition sources with the shared directories copied in (setup.sh links them)."""
+    if os.path.exists(src_dir):
+        shutil.rmtree(src_dir)
+    shutil.copytree(os.path.join(edition, 'src', 'c'), src_dir, symlinks=True,
+                    ignore=shutil.ignore_patterns(*SHARED_DIRS))
+    for name in SHARED_DIRS:
+        shutil.copytree(os.path.join(SHARED_C, name), os.path.join(src_dir, name))
+
+
+def _sources(src_dir):
+    for base, _, files in os.walk(src_dir):
+        for name in sorted(files):
+            if name.endswith('.c'):
+                yield os.path.join(base, name)
+
+
+def build(edition, platform, drivers, defines=(), extra_sources=(), name=None, hooks=None):
+    """Builds the edition for platform with the given drivers; returns the binary path.
+
+    defines are extra compiler flags and are passed to the link as well, so
+    -fsanitize=... works there too. hooks is a header force-included into
+    the app sources (not the render graph module, whose definitions it would
+    rename), e.g. host/site_hooks.h.
+    """
+    edition = os.path.normpath(os.path.join(ROOT, edition))
+    if platform not in PLATFORMS:
+        raise ValueError('unknown platform %s' % platform)
+    out_dir = os.path.join(edition, 'build', 'host', platform)
+    src_dir = os.path.join(out_dir, 'src')
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+    _mirror(edition, src_dir)
+    write_generated(edition, platform, out_dir)
+    with open(os.path.join(edition, 'package.json')) as f:
+        check_persist_keys(src_dir, json.load(f)['pebble'].get('messageKeys', []))
+
+    binary = os.path.join(out_dir, name or os.path.splitext(os.path.basename(drivers[0]))[0])
+    cmd = [os.environ.get('CC', 'cc')] + CFLAGS + [
+        '-I', HOST_DIR, '-I', out_dir, '-I', src_dir,
+        '-include', os.path.join(out_dir, 'host_ids.h'),
+        '-DPBL_PLATFORM_%s' % platform.upper(),
+    ] + list(defines)
+    app = list(_sources(src_dir))
+    host = [os.path.join(HOST_DIR, 'pebble_host.c'),
+            os.path.join(out_dir, 'host_resources.c')] + list(drivers) + list(extra_sources)
+    objects = []
+    # The app is compiled separately so only its main() is renamed
+    for group, flags in ((app, APP_FLAGS), (host, [])):
+        for path in group:
+            extra = []
+            if hooks and group is app and os.path.basename(path) not in UNHOOKED:
+                extra = ['-include', hooks]
+            obj = os.path.join(out_dir, 'obj', os.path.relpath(path, ROOT).replace(os.sep, '_') + '.o')
+            if not os.path.isdir(os.path.dirname(obj)):
+                os.makedirs(os.path.dirname(obj))
+            subprocess.check_call(cmd + flags + extra + ['-c', path, '-o', obj])
+            objects.append(obj)
+    subprocess.check_call(cmd + objects + ['-o', binary, '-lm'])
+    return binary
+
+
+def symbolize(binary, addresses):
+    """Maps printed function pointers to names; null or unresolved ones are left out."""
+    addresses = sorted(set(a for a in addresses if a not in ('(nil)', '0x0')))
+    names = {}
+    if not addresses:
+        return names
+    try:
+        out = subprocess.check_output(['addr2line', '-f', '-e', binary] + addresses).decode()
+    except OSError:
+        return dict((address, address) for address in addresses)    # no binutils
+    lines = out.splitlines()
+    for i, address in enumerate(addresses):
+        names[address] = lines[2 * i]
+    return names
+
+
+# ============================================================================
+# COMMAND LINE
+# ============================================================================
+
+def usage(doc, error=None):
+    """Prints a tool's docstring; with error, to stderr after it. Returns the exit status."""
+    if error:
+        print('%s\n\n%s' % (error, doc.strip()), file=sys.stderr)
+        return 2
+    print(doc.strip())
+    return 0
+
+
+def edition_arg(arg):
+    """Edition directory named by a command-line argument, or None if there is none."""
+    edition = os.path.basename(os.path.normpath(arg))
+    return edition if os.path.isfile(os.path.join(ROOT, edition, 'package.json')) else None
+
+
+def main(argv):
+    if argv and argv[0] in ('-h', '--help'):
+        return usage(__doc__)
+    if len(argv) < 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    edition, platform, driver = argv[:3]
+    print(build(edition, platform, [os.path.abspath(driver)], defines=argv[3:]))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
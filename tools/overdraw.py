@@ -0,0 +1,237 @@
+#!/usr/bin/env python
+"""
+Overdraw heatmap for Constellation.
+
+Builds each edition for the host (tools/host_build.py), runs the overdraw
+scenario from tools/host/overdraw_main.c for a simulated minute and reports
+how many times every pixel is written per frame:
+
+  <edition>/build/overdraw/<platform>-<config>.png   heatmap, 2x scale
+  <edition>/build/overdraw/<platform>-<config>.json  summary for --compare
+
+Heatmap colours are writes per pixel per frame: black 0, blue 1, green 2,
+yellow 3, orange 4, red 5+; grey marks pixels a round display does not have.
+
+Configs:
+  default   settings as shipped
+  all       every optional layer switched on (second ticker, ring, steps,
+            weather, moon / analog clock where the edition has them)
+
+Usage:
+  python tools/overdraw.py [edition ...]                 # report every target platform
+  python tools/overdraw.py --platform=chalk --config=all
+  python tools/overdraw.py --minutes=5 --set=SHOW_WEATHER=0
+  python tools/overdraw.py --save=<dir>                  # keep the summaries as a baseline
+  python tools/overdraw.py --compare=<dir>               # deltas against that baseline
+  python tools/overdraw.py --immediate                   # build with RENDER_IMMEDIATE=1
+
+Text is drawn with boxes of the right size rather than the system fonts, so
+absolute counts for text layers are approximate; the layer stack, fills,
+rings, radials and bitmaps are exact.
+"""
+from __future__ import print_function
+
+import json
+import os
+import subprocess
+import sys
+
+import bitmap_pipeline
+import host_build
+
+ROOT = host_build.ROOT
+EDITIONS = ['standard-edition', 'chronomark-edition']
+DRIVER = os.path.join(host_build.HOST_DIR, 'overdraw_main.c')
+OPTIONAL_FEATURES = ['SHOW_SECOND_TICKER', 'SHOW_CLOCK_RING', 'SHOW_STEP_TRACKER',
+                     'SHOW_WEATHER', 'SHOW_MOON_VIEW', 'SHOW_CLOCK_ANALOG']
+CONFIGS = ['default', 'all']
+SCALE = 2
+
+RAMP = [(0, 0, 0, 255), (0, 85, 255, 255), (0, 170, 0, 255),
+        (255, 255, 0, 255), (255, 170, 0, 255), (255, 0, 0, 255)]
+MASKED = (85, 85, 85, 255)
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def _manifest(edition):
+    with open(os.path.join(ROOT, edition, 'package.json')) as f:
+        return json.load(f)
+
+
+def config_settings(edition, config, extra):
+    keys = _manifest(edition)['pebble'].get('messageKeys', [])
+    settings = []
+    if config == 'all':
+        settings = ['%s=1' % key for key in OPTIONAL_FEATURES if key in keys]
+    return settings + list(extra)
+
+
+def parse(output):
+    result = {'rows': [], 'layers': []}
+    for line in output.splitlines():
+        parts = line.split()
+        if not parts:
+            continue
+        if parts[0] == 'frames':
+            result['frames'] = int(parts[1])
+        elif parts[0] == 'screen':
+            result['width'], result['height'] = int(parts[1]), int(parts[2])
+        elif parts[0] == 'row':
+            result['rows'].append([int(v) for v in parts[2:]])
+        elif parts[0] == 'worst':
+            result['worst'] = int(parts[1])
+        elif parts[0] == 'layer':
+            result['layers'].append({
+                'kind': parts[1], 'proc': parts[2],
+                'frame': [int(v) for v in parts[3:7]],
+                'writes': int(parts[7]), 'overdraw': int(parts[8]),
+            })
+    return result
+
+
+def resolve_procs(binary, layers):
+    names = host_build.symbolize(binary, [layer['proc'] for layer in layers])
+    for layer in layers:
+        layer['name'] = names.get(layer['proc'], '')
+        if layer['kind'] == 'layer' and not layer['name']:
+            layer['name'] = '(container)'
+
+# ============================================================================
+# REPORT
+# ============================================================================
+
+def summarise(run):
+    frames = max(run['frames'], 1)
+    visible = total = peak = 0
+    histogram = [0] * len(RAMP)
+    for row in run['rows']:
+        for value in row:
+            if value < 0:
+                continue
+            visible += 1
+            total += value
+            per_frame = float(value) / frames
+            peak = max(peak, per_frame)
+            histogram[min(int(round(per_frame)), len(RAMP) - 1)] += 1
+    layers = sorted(run['layers'], key=lambda layer: -layer['writes'])
+    return {
+        'frames': run['frames'],
+        'visible_pixels': visible,
+        'writes_per_frame': float(total) / frames,
+        'writes_per_pixel': float(total) / frames / max(visible, 1),
+        'max_writes_per_pixel': peak,
+        'worst_frame_writes': run.get('worst', 0),
+        'histogram': [float(count) / max(visible, 1) for count in histogram],
+        'layers': [{'kind': layer['kind'], 'name': layer['name'], 'frame': layer['frame'],
+                    'writes_per_frame': float(layer['writes']) / frames,
+                    'overdraw_per_frame': float(layer['overdraw']) / frames}
+                   for layer in layers],
+    }
+
+
+def write_heatmap(path, run):
+    frames = max(run['frames'], 1)
+    rows = []
+    for row in run['rows']:
+        line = []
+        for value in row:
+            if value < 0:
+                px = MASKED
+            else:
+                px = RAMP[min(int(round(float(value) / frames)), len(RAMP) - 1)]
+            line.extend([px] * SCALE)
+        rows.extend([line] * SCALE)
+    bitmap_pipeline.write_palette_png(path, run['width'] * SCALE, run['height'] * SCALE, rows)
+
+
+def print_summary(label, summary, previous=None):
+    print('%s: %d frames, %.2f writes/pixel (max %.1f), %d writes/frame, worst frame %d'
+          % (label, summary['frames'], summary['writes_per_pixel'], summary['max_writes_per_pixel'],
+             summary['writes_per_frame'], summary['worst_frame_writes']))
+    if previous:
+        before = previous['writes_per_pixel']
+        change = (summary['writes_per_pixel'] - before) / before * 100 if before else 0
+        print('  vs baseline: %.2f -> %.2f writes/pixel (%+.1f%%)'
+              % (before, summary['writes_per_pixel'], change))
+    print('  pixels by writes/frame: ' + '  '.join(
+        '%s:%.0f%%' % ('%d+' % i if i == len(RAMP) - 1 else i, share * 100)
+        for i, share in enumerate(summary['histogram'])))
+    for layer in summary['layers']:
+        if not layer['writes_per_frame']:
+            continue
+        x, y, w, h = layer['frame']
+        print('  %-7s %-28s %4d,%-4d %4dx%-4d %8.0f writes %8.0f overdraw'
+              % (layer['kind'], layer['name'], x, y, w, h,
+                 layer['writes_per_frame'], layer['overdraw_per_frame']))
+
+
+def run_one(edition, platform, config, args):
+    defines = ['-DRENDER_IMMEDIATE=1'] if args['immediate'] else []
+    binary = host_build.build(edition, platform, [DRIVER], defines=defines)
+    cmd = [binary, '--minutes', str(args['minutes'])] + config_settings(edition, config, args['set'])
+    run = parse(subprocess.check_output(cmd).decode())
+    resolve_procs(binary, run['layers'])
+    summary = summarise(run)
+
+    out_dir = os.path.join(ROOT, edition, 'build', 'overdraw')
+    if not os.path.isdir(out_dir):
+        os.makedirs(out_dir)
+    stem = '%s-%s' % (platform, config)
+    write_heatmap(os.path.join(out_dir, stem + '.png'), run)
+
+    previous = None
+    if args['compare']:
+        path = os.path.join(args['compare'], edition, stem + '.json')
+        if os.path.exists(path):
+            with open(path) as f:
+                previous = json.load(f)
+    print_summary('%s %s %s' % (edition, platform, config), summary, previous)
+    paths = [os.path.join(out_dir, stem + '.json')]
+    if args['save']:
+        paths.append(os.path.join(args['save'], edition, stem + '.json'))
+    for path in paths:
+        if not os.path.isdir(os.path.dirname(path)):
+            os.makedirs(os.path.dirname(path))
+        with open(path, 'w') as f:
+            json.dump(summary, f, indent=2, sort_keys=True)
+
+
+def main(argv):
+    args = {'platform': None, 'config': None, 'minutes': 1, 'set': [],
+            'compare': None, 'save': None, 'immediate': False}
+    editions = []
+    for arg in argv:
+        if arg in ('-h', '--help'):
+            return host_build.usage(__doc__)
+        elif arg.startswith('--platform='):
+            args['platform'] = arg.split('=', 1)[1]
+        elif arg.startswith('--config='):
+            args['config'] = arg.split('=', 1)[1]
+        elif arg.startswith('--minutes='):
+            args['minutes'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--set='):
+            args['set'].append(arg.split('=', 1)[1])
+        elif arg.startswith('--compare='):
+            args['compare'] = os.path.abspath(arg.split('=', 1)[1])
+        elif arg.startswith('--save='):
+            args['save'] = os.path.abspath(arg.split('=', 1)[1])
+        elif arg == '--immediate':
+            args['immediate'] = True
+        elif host_build.edition_arg(arg):
+            editions.append(host_build.edition_arg(arg))
+        else:
+            return host_build.usage(__doc__, 'unknown argument: %s' % arg)
+
+    for edition in editions or EDITIONS:
+        targets = _manifest(edition)['pebble'].get('targetPlatforms', [])
+        platforms = [args['platform']] if args['platform'] else targets
+        for platform in platforms:
+            for config in [args['config']] if args['config'] else CONFIGS:
+                run_one(edition, platform, config, args)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
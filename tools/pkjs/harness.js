@@ -0,0 +1,494 @@
+// pkjs harness
+//
+// Runs an edition's src/pkjs/index.js under Node against fakes for Pebble,
+// localStorage, navigator.geolocation and XMLHttpRequest. Requests for
+// api.open-meteo.com go to the local stand-in in server.js. Time is virtual:
+// setTimeout / setInterval / Date follow a simulated clock, so a week takes
+// seconds. HTTP round trips are real; the clock advances by their measured
+// time plus --latency, which is applied virtually rather than by the server.
+//
+// The simulated week:
+//   - the phone app starts (ready) at midnight and is restarted each morning
+//   - a watch model applies weather pushes and sends REQUEST_WEATHER the way
+//     weather_sync_module.c does (data older than 60 min, 5 min apart)
+//   - the phone is at home, at an office 10 km away on weekdays and on a day
+//     trip on Saturday
+//   - settings are saved once, on the first evening
+//
+// Per simulated day it reports HTTP requests, location fixes, messages and
+// dictionary bytes each way, AppMessage NACKs and localStorage writes.
+//
+// Usage:
+//   node tools/pkjs/harness.js [--days=7] [--latency=80] [--fail-rate=0.05]
+//        [--gps-fail-rate=0.05] [--nack-rate=0.02] [--restarts=1] [--seed=1]
+//        [--edition=standard-edition] [--json] [--verbose]
+
+var fs = require('fs');
+var http = require('http');
+var path = require('path');
+var url = require('url');
+var vm = require('vm');
+
+var server = require('./server');
+
+var ROOT = path.join(__dirname, '..', '..');
+var DAY_MS = 24 * 60 * 60 * 1000;
+var START_MS = Date.UTC(2026, 5, 15);       // A Monday
+var API_HOST = 'api.open-meteo.com';
+var ACK_DELAY_MS = 300;
+var FIX_DELAY_MS = 1500;
+
+// Mirrors weather_sync_module.h
+var WATCH_STALE_AGE_S = 60 * 60;
+var WATCH_REQUEST_RETRY_S = 5 * 60;
+
+var HOME = { latitude: 52.5200, longitude: 13.4050 };
+var OFFICE = { latitude: 52.4400, longitude: 13.3100 };
+var TRIP = { latitude: 53.5511, longitude: 9.9937 };
+
+// ============================================================================
+// OPTIONS
+// ============================================================================
+
+function parseOptions(argv) {
+  var options = {
+    days: 7, latency: 80, failRate: 0.05, gpsFailRate: 0.05, nackRate: 0.02,
+    restarts: 1, seed: 1, edition: 'standard-edition', json: false, verbose: false
+  };
+  argv.forEach(function(arg) {
+    var match = /^--([a-z-]+)(?:=(.*))?$/.exec(arg);
+    if (!match) {
+      throw new Error('unknown argument ' + arg);
+    }
+    var name = match[1].replace(/-([a-z])/g, function(_, c) { return c.toUpperCase(); });
+    if (!(name in options)) {
+      throw new Error('unknown option --' + match[1]);
+    }
+    if (typeof options[name] === 'boolean') {
+      options[name] = true;
+    } else if (typeof options[name] === 'number') {
+      options[name] = parseFloat(match[2]);
+    } else {
+      options[name] = match[2];
+    }
+  });
+  return options;
+}
+
+// ============================================================================
+// VIRTUAL CLOCK
+// ============================================================================
+
+var clock = { now: START_MS, timers: [], nextId: 1, pending: 0, resume: null };
+
+function schedule(fn, delay, repeat, owner) {
+  var id = clock.nextId++;
+  delay = Math.max(0, delay || 0);
+  clock.timers.push({ id: id, at: clock.now + delay, fn: fn, interval: repeat ? Math.max(delay, 1) : 0, owner: owner });
+  return id;
+}
+
+function cancel(id) {
+  clock.timers = clock.timers.filter(function(timer) { return timer.id !== id; });
+}
+
+function cancelOwner(owner) {
+  clock.timers = clock.timers.filter(function(timer) { return timer.owner !== owner; });
+}
+
+// Real I/O holds the clock until it completes
+function beginIo() {
+  clock.pending++;
+  return Date.now();
+}
+
+function endIo(started, delay, callback) {
+  clock.now += Date.now() - started + delay;
+  clock.pending--;
+  callback();
+  if (clock.pending === 0 && clock.resume) {
+    var resume = clock.resume;
+    clock.resume = null;
+    setImmediate(resume);
+  }
+}
+
+function runUntil(end, done) {
+  function step() {
+    if (clock.pending > 0) {
+      clock.resume = step;
+      return;
+    }
+    var next = null;
+    clock.timers.forEach(function(timer) {
+      if (!next || timer.at < next.at || (timer.at === next.at && timer.id < next.id)) {
+        next = timer;
+      }
+    });
+    if (!next || next.at > end) {
+      clock.now = Math.max(clock.now, end);
+      done();
+      return;
+    }
+    if (next.interval) {
+      next.at += next.interval;
+    } else {
+      cancel(next.id);
+    }
+    clock.now = Math.max(clock.now, next.at - next.interval);
+    next.fn();
+    setImmediate(step);
+  }
+  step();
+}
+
+// Date with the virtual clock as "now"
+function VirtualDate() {
+  var args = arguments.length ? Array.prototype.slice.call(arguments) : [clock.now];
+  return new (Function.prototype.bind.apply(Date, [null].concat(args)))();
+}
+VirtualDate.now = function() { return clock.now; };
+VirtualDate.UTC = Date.UTC;
+VirtualDate.parse = Date.parse;
+VirtualDate.prototype = Date.prototype;
+
+// ============================================================================
+// STATS
+// ============================================================================
+
+var STAT_NAMES = ['http', 'httpFailed', 'fixes', 'fixFailed', 'toWatch', 'toWatchBytes', 'weather', 'config',
+                  'nacks', 'toPhone', 'toPhoneBytes', 'storageWrites'];
+var stats = [];
+
+function count(name, amount) {
+  var day = Math.floor((clock.now - START_MS) / DAY_MS);
+  if (!stats[day]) {
+    stats[day] = {};
+    STAT_NAMES.forEach(function(stat) { stats[day][stat] = 0; });
+  }
+  stats[day][name] += amount === undefined ? 1 : amount;
+}
+
+// Serialised AppMessage size: count byte, then key (4), type (1), length (2) and data per tuple
+function dictBytes(payload) {
+  var bytes = 1;
+  Object.keys(payload).forEach(function(key) {
+    var value = payload[key];
+    var size = 4;
+    if (typeof value === 'string') {
+      size = Buffer.byteLength(value, 'utf8') + 1;
+    } else if (Array.isArray(value)) {
+      size = value.length;
+    }
+    bytes += 7 + size;
+  });
+  return bytes;
+}
+
+// ============================================================================
+// FAKES
+// ============================================================================
+
+function makeLocalStorage() {
+  var items = {};
+  return {
+    getItem: function(key) { return items.hasOwnProperty(key) ? items[key] : null; },
+    setItem: function(key, value) { count('storageWrites'); items[key] = String(value); },
+    removeItem: function(key) { delete items[key]; },
+    clear: function() { items = {}; }
+  };
+}
+
+function positionAt(time, random) {
+  var day = Math.floor((time - START_MS) / DAY_MS);
+  var hour = ((time - START_MS) % DAY_MS) / 3600000;
+  var place = HOME;
+  if (day % 7 < 5 && hour >= 8.5 && hour < 17.5) {
+    place = OFFICE;
+  } else if (day % 7 === 5 && hour >= 10 && hour < 20) {
+    place = TRIP;
+  }
+  // GPS jitter of a few tens of metres
+  return {
+    latitude: place.latitude + (random() - 0.5) * 0.0004,
+    longitude: place.longitude + (random() - 0.5) * 0.0004
+  };
+}
+
+function makeGeolocation(options, random, owner) {
+  return {
+    getCurrentPosition: function(success, error) {
+      count('fixes');
+      schedule(function() {
+        if (random() < options.gpsFailRate) {
+          count('fixFailed');
+          if (error) error({ code: 3, message: 'Timeout expired' });
+          return;
+        }
+        success({ coords: positionAt(clock.now, random), timestamp: clock.now });
+      }, FIX_DELAY_MS, false, owner);
+    }
+  };
+}
+
+function makeXMLHttpRequest(port, latency) {
+  function FakeXMLHttpRequest() {
+    this.status = 0;
+    this.responseText = '';
+    this.onload = null;
+    this.onerror = null;
+  }
+  FakeXMLHttpRequest.prototype.open = function(method, address) {
+    var parsed = url.parse(address);
+    if (parsed.hostname !== API_HOST) {
+      throw new Error('unexpected request to ' + address);
+    }
+    this.target = 'http://127.0.0.1:' + port + parsed.path;
+  };
+  FakeXMLHttpRequest.prototype.send = function() {
+    var xhr = this;
+    var started = beginIo();
+    count('http');
+    http.get(xhr.target, function(res) {
+      var body = '';
+      res.setEncoding('utf8');
+      res.on('data', function(chunk) { body += chunk; });
+      res.on('end', function() {
+        endIo(started, latency, function() {
+          xhr.status = res.statusCode;
+          xhr.responseText = body;
+          if (res.statusCode !== 200) count('httpFailed');
+          if (xhr.onload) xhr.onload();
+        });
+      });
+    }).on('error', function() {
+      endIo(started, latency, function() {
+        count('httpFailed');
+        if (xhr.onerror) xhr.onerror();
+      });
+    });
+  };
+  return FakeXMLHttpRequest;
+}
+
+// Stands in for @rebble/clay: settings arrive as a JSON object of values
+function makeClay(storage) {
+  function Clay() {}
+  Clay.prototype.generateUrl = function() { return 'data:text/html,'; };
+  Clay.prototype.getSettings = function(response) {
+    var settings = JSON.parse(decodeURIComponent(response));
+    storage.setItem('clay-settings', JSON.stringify(settings));
+    var converted = {};
+    Object.keys(settings).forEach(function(key) {
+      converted[key] = typeof settings[key] === 'boolean' ? (settings[key] ? 1 : 0) : settings[key];
+    });
+    return converted;
+  };
+  return Clay;
+}
+
+// ============================================================================
+// WATCH
+// ============================================================================
+
+function makeWatch(options, random) {
+  var watch = {
+    weatherTime: null,          // seconds, like WeatherData.updated_at
+    lastRequest: clock.now / 1000,
+    phone: null                 // the running pkjs instance
+  };
+
+  watch.receive = function(payload) {
+    if (payload.WEATHER_DATA) {
+      var timestamp = 0;
+      try {
+        timestamp = JSON.parse(payload.WEATHER_DATA).timestamp || 0;
+      } catch (e) {
+        timestamp = 0;
+      }
+      watch.weatherTime = timestamp > 0 ? timestamp : Math.floor(clock.now / 1000);
+    }
+  };
+
+  // weather_sync_module_check, run on every minute tick
+  watch.check = function() {
+    var now = Math.floor(clock.now / 1000);
+    var age = watch.weatherTime === null ? Infinity : now - watch.weatherTime;
+    if (age < WATCH_STALE_AGE_S || now - watch.lastRequest < WATCH_REQUEST_RETRY_S || !watch.phone) {
+      return;
+    }
+    watch.lastRequest = now;
+    var payload = { REQUEST_WEATHER: 1 };
+    count('toPhone');
+    count('toPhoneBytes', 1 + 7 + 1);      // One dict_write_uint8 tuple
+    var phone = watch.phone;
+    schedule(function() { phone.emit('appmessage', { payload: payload }); }, ACK_DELAY_MS, false, phone.owner);
+  };
+
+  watch.deliver = function(payload, success, failure, owner) {
+    schedule(function() {
+      if (random() < options.nackRate) {
+        count('nacks');
+        if (failure) failure({ data: payload, error: { message: 'NACK' } });
+        return;
+      }
+      count('toWatch');
+      count('toWatchBytes', dictBytes(payload));
+      count(payload.WEATHER_DATA ? 'weather' : 'config');
+      watch.receive(payload);
+      if (success) success({ data: payload });
+    }, ACK_DELAY_MS, false, owner);
+  };
+
+  return watch;
+}
+
+// ============================================================================
+// PKJS
+// ============================================================================
+
+function startPkjs(options, shared) {
+  var dir = path.join(ROOT, options.edition, 'src', 'pkjs');
+  var owner = {};
+  var listeners = {};
+  var phone = {
+    owner: owner,
+    emit: function(type, event) {
+      (listeners[type] || []).forEach(function(listener) { listener(event || {}); });
+    }
+  };
+
+  var Pebble = {
+    addEventListener: function(type, listener) {
+      (listeners[type] = listeners[type] || []).push(listener);
+    },
+    sendAppMessage: function(payload, success, failure) {
+      shared.watch.deliver(payload, success, failure, owner);
+    },
+    openURL: function() {}
+  };
+
+  function fakeRequire(name) {
+    if (name === '@rebble/clay') return makeClay(shared.storage);
+    return require(path.join(dir, name));
+  }
+
+  var sandbox = {
+    console: {
+      log: function() {
+        if (options.verbose) {
+          var stamp = new Date(clock.now).toISOString().slice(5, 19).replace('T', ' ');
+          console.log('[' + stamp + '] ' + Array.prototype.join.call(arguments, ' '));
+        }
+      }
+    },
+    Pebble: Pebble,
+    localStorage: shared.storage,
+    navigator: { geolocation: makeGeolocation(options, shared.random, owner) },
+    XMLHttpRequest: makeXMLHttpRequest(shared.port, options.latency),
+    Date: VirtualDate,
+    setTimeout: function(fn, delay) { return schedule(fn, delay, false, owner); },
+    setInterval: function(fn, delay) { return schedule(fn, delay, true, owner); },
+    clearTimeout: cancel,
+    clearInterval: cancel,
+    require: fakeRequire
+  };
+  vm.runInNewContext(fs.readFileSync(path.join(dir, 'index.js'), 'utf8'), sandbox,
+                     { filename: path.join(dir, 'index.js') });
+
+  shared.watch.phone = phone;
+  phone.emit('ready');
+  return phone;
+}
+
+function defaultSettings(edition) {
+  var settings = {};
+  (function walk(node) {
+    if (Array.isArray(node)) {
+      node.forEach(walk);
+    } else if (node && typeof node === 'object') {
+      if (node.messageKey && node.defaultValue !== undefined) {
+        settings[node.messageKey] = node.defaultValue;
+      }
+      Object.keys(node).forEach(function(key) { walk(node[key]); });
+    }
+  })(JSON.parse(fs.readFileSync(path.join(ROOT, edition, 'src', 'pkjs', 'config.json'), 'utf8')));
+  return settings;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+function report(options) {
+  var days = stats.slice(0, options.days).map(function(day) {
+    return day || {};
+  });
+  if (options.json) {
+    console.log(JSON.stringify({ options: options, days: days }, null, 2));
+    return;
+  }
+  var columns = [
+    ['http', 'http'], ['httpFailed', 'failed'], ['fixes', 'fixes'], ['fixFailed', 'failed'],
+    ['weather', 'weather'], ['config', 'config'], ['toWatchBytes', 'bytes'], ['nacks', 'nacks'],
+    ['toPhone', 'requests'], ['toPhoneBytes', 'bytes'], ['storageWrites', 'storage']
+  ];
+  function row(label, values) {
+    return label + columns.map(function(column, i) {
+      var value = values[i];
+      return ('         ' + (typeof value === 'number' ? (value % 1 ? value.toFixed(1) : value) : value)).slice(-9);
+    }).join('');
+  }
+  console.log(options.edition + ': ' + options.days + ' simulated days, latency ' + options.latency +
+              ' ms, HTTP fail rate ' + options.failRate + ', GPS fail rate ' + options.gpsFailRate +
+              ', NACK rate ' + options.nackRate);
+  console.log(row('  day       ', columns.map(function(column) { return column[1]; })));
+  var totals = columns.map(function() { return 0; });
+  days.forEach(function(day, index) {
+    var values = columns.map(function(column, i) {
+      var value = day[column[0]] || 0;
+      totals[i] += value;
+      return value;
+    });
+    var date = new Date(START_MS + index * DAY_MS).toUTCString().slice(0, 3);
+    console.log(row('  ' + index + ' ' + date + '     ', values));
+  });
+  console.log(row('  per day    ', totals.map(function(total) { return total / Math.max(days.length, 1); })));
+}
+
+function main() {
+  var options = parseOptions(process.argv.slice(2));
+  var random = server.makeRandom(options.seed * 7919);
+  var storage = makeLocalStorage();
+  var shared = { storage: storage, random: random, port: 0, watch: makeWatch(options, random) };
+  var end = START_MS + options.days * DAY_MS;
+
+  var openMeteo = server.start({ latency: 0, failRate: options.failRate, seed: options.seed },
+                               function(listening) {
+    shared.port = listening.address().port;
+    var phone = startPkjs(options, shared);
+
+    // Watch ticks, phone app restarts and one settings save
+    schedule(function() { shared.watch.check(); }, 60 * 1000, true, shared);
+    for (var day = 0; day < options.days; day++) {
+      for (var r = 0; r < options.restarts; r++) {
+        schedule(function() {
+          cancelOwner(phone.owner);
+          phone = startPkjs(options, shared);
+        }, day * DAY_MS + (7 + r * 24 / Math.max(options.restarts, 1)) * 3600000, false, shared);
+      }
+    }
+    schedule(function() {
+      var settings = defaultSettings(options.edition);
+      settings.SHOW_SECOND_TICKER = true;
+      phone.emit('webviewclosed', { response: encodeURIComponent(JSON.stringify(settings)) });
+    }, 20 * 3600000, false, shared);
+
+    runUntil(end, function() {
+      openMeteo.close();
+      report(options);
+    });
+  });
+}
+
+main();
@@ -0,0 +1,87 @@
+// Local Open-Meteo stand-in
+//
+// Serves the recorded forecasts in tools/pkjs/recorded/ for /v1/forecast,
+// in rotation, with the requested coordinates copied in. Latency and
+// failures are configurable so pkjs retry and cache paths can be exercised:
+// a failed request alternates between an HTTP 503 and a dropped connection.
+//
+// Usage: node tools/pkjs/server.js [--port=8642] [--latency=80] [--fail-rate=0.1]
+
+var fs = require('fs');
+var http = require('http');
+var path = require('path');
+var url = require('url');
+
+var RECORDED_DIR = path.join(__dirname, 'recorded');
+
+function loadRecorded() {
+  return fs.readdirSync(RECORDED_DIR).filter(function(name) {
+    return /\.json$/.test(name);
+  }).sort().map(function(name) {
+    return JSON.parse(fs.readFileSync(path.join(RECORDED_DIR, name), 'utf8'));
+  });
+}
+
+// Deterministic so a simulated week fails the same requests every run
+function makeRandom(seed) {
+  var state = seed >>> 0 || 1;
+  return function() {
+    state ^= state << 13;
+    state ^= state >>> 17;
+    state ^= state << 5;
+    return (state >>> 0) / 4294967296;
+  };
+}
+
+// options: { port, latency, failRate, seed }; calls back with the listening server
+function start(options, callback) {
+  var recorded = loadRecorded();
+  var random = makeRandom(options.seed || 1);
+  var served = 0;
+  var failed = 0;
+
+  var server = http.createServer(function(req, res) {
+    var parsed = url.parse(req.url, true);
+    setTimeout(function() {
+      if (parsed.pathname !== '/v1/forecast') {
+        res.writeHead(404);
+        res.end();
+        return;
+      }
+      if (random() < (options.failRate || 0)) {
+        failed++;
+        if (failed % 2) {
+          res.writeHead(503, { 'Content-Type': 'text/plain' });
+          res.end('Service Unavailable');
+        } else {
+          req.socket.destroy();
+        }
+        return;
+      }
+      var body = JSON.parse(JSON.stringify(recorded[served++ % recorded.length]));
+      body.latitude = parseFloat(parsed.query.latitude);
+      body.longitude = parseFloat(parsed.query.longitude);
+      res.writeHead(200, { 'Content-Type': 'application/json' });
+      res.end(JSON.stringify(body));
+    }, options.latency || 0);
+  });
+  server.listen(options.port || 0, '127.0.0.1', function() {
+    callback(server);
+  });
+  return server;
+}
+
+module.exports = { start: start, makeRandom: makeRandom };
+
+if (require.main === module) {
+  var options = { port: 8642 };
+  process.argv.slice(2).forEach(function(arg) {
+    var match = /^--([a-z-]+)=(.*)$/.exec(arg);
+    if (match && match[1] === 'port') options.port = parseInt(match[2], 10);
+    if (match && match[1] === 'latency') options.latency = parseInt(match[2], 10);
+    if (match && match[1] === 'fail-rate') options.failRate = parseFloat(match[2]);
+  });
+  start(options, function(server) {
+    console.log('Open-Meteo stand-in on http://127.0.0.1:' + server.address().port + '/v1/forecast');
+  });
+}
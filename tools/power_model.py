@@ -0,0 +1,177 @@
+#!/usr/bin/env python
+"""
+Simulated 24-hour power model for Constellation.
+
+Builds each edition for the host (tools/host_build.py) and runs the day
+scenario from tools/host/power_main.c once per settings combination: ticks,
+movement and sleep updates, battery readings, wrist taps and an hourly
+weather push. The face's own work is counted
+
+  wakeups          tick, timer, service and inbox handlers run
+  frames / pixels  redraws and pixels written by them
+  health_calls     health_service_sum_today / peek_current_value / minute history
+  persist_writes   persist_write_* calls (and bytes)
+  bt               AppMessages in and out (and bytes)
+
+and priced with tools/power_costs.json (microamp-seconds per operation) to
+give an estimated mAh per day. The costs are estimates to be tuned against
+a measured watch; the firmware's idle draw is the same for every face and is
+left out, so the numbers are what each setting adds on top of it.
+The day starts at --battery percent and loses one every 96 minutes, so a
+low start shows the face under the battery saver's power tiers.
+
+Combinations come from the toggles in src/pkjs/config.json. By default the
+shipped settings run once, then once more with each toggle flipped; selects
+and inputs stay at their defaults.
+
+Usage:
+  python tools/power_model.py [edition ...]              # defaults + each toggle flipped
+  python tools/power_model.py --combinations             # every toggle combination
+  python tools/power_model.py --vary=SHOW_SECOND_TICKER,SHOW_WEATHER --combinations
+  python tools/power_model.py --platform=chalk --hours=6 --weather-minutes=180
+  python tools/power_model.py --costs=<file>             # another cost table
+  python tools/power_model.py --battery=15               # a day under the battery saver
+"""
+from __future__ import print_function
+
+import itertools
+import json
+import os
+import subprocess
+import sys
+
+import host_build
+
+ROOT = host_build.ROOT
+DRIVER = os.path.join(host_build.HOST_DIR, 'power_main.c')
+COSTS_PATH = os.path.join(ROOT, 'tools', 'power_costs.json')
+DEFAULT_PLATFORMS = {'standard-edition': 'basalt', 'chronomark-edition': 'gabbro'}
+
+# Counter from power_main.c -> entry in the cost table
+PRICED = [('wakeups', 'wakeup'), ('frames', 'frame'), ('pixels_written', 'pixel'),
+          ('health_calls', 'health_call'), ('persist_writes', 'persist_write'),
+          ('persist_bytes', 'persist_byte'), ('inbox_messages', 'bt_message'),
+          ('outbox_messages', 'bt_message'), ('bt_bytes', 'bt_byte')]
+UAS_PER_MAH = 3600.0 * 1000
+
+# ============================================================================
+# SETTINGS
+# ============================================================================
+
+def toggles(edition):
+    with open(os.path.join(ROOT, edition, 'src', 'pkjs', 'config.json')) as f:
+        config = json.load(f)
+    found = []
+
+    def walk(node):
+        if isinstance(node, list):
+            for item in node:
+                walk(item)
+        elif isinstance(node, dict):
+            if node.get('type') == 'toggle' and 'messageKey' in node:
+                if node['messageKey'] not in [key for key, _ in found]:
+                    found.append((node['messageKey'], bool(node.get('defaultValue'))))
+            for value in node.values():
+                walk(value)
+    walk(config)
+    return found
+
+
+def combinations(defaults, vary, every):
+    """[(label, {key: bool})], shipped settings first."""
+    shipped = dict(defaults)
+    keys = [key for key, _ in defaults if not vary or key in vary]
+    result = [('defaults', shipped)]
+    if every:
+        for values in itertools.product([False, True], repeat=len(keys)):
+            settings = dict(shipped, **dict(zip(keys, values)))
+            if settings != shipped:
+                changed = [key for key in keys if settings[key] != shipped[key]]
+                result.append((' '.join('%s=%d' % (key, settings[key]) for key in changed), settings))
+    else:
+        for key in keys:
+            result.append(('%s=%d' % (key, not shipped[key]), dict(shipped, **{key: not shipped[key]})))
+    return result
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def run(binary, settings, args):
+    cmd = [binary, '--hours', str(args['hours']), '--weather-minutes', str(args['weather_minutes']),
+           '--battery', str(args['battery'])]
+    cmd += ['%s=%d' % (key, value) for key, value in sorted(settings.items())]
+    counters = {}
+    for line in subprocess.check_output(cmd).decode().splitlines():
+        parts = line.split()
+        if len(parts) == 2:
+            counters[parts[0]] = int(parts[1])
+    # Shorter runs are scaled up to a day
+    scale = 24.0 / max(counters.pop('hours', 24), 1)
+    return dict((name, value * scale) for name, value in counters.items())
+
+
+def price(counters, costs):
+    """Estimated mAh per day, and the microamp-seconds behind it per cost."""
+    spent = {}
+    for counter, cost in PRICED:
+        spent[cost] = spent.get(cost, 0) + counters.get(counter, 0) * costs.get(cost, 0)
+    return sum(spent.values()) / UAS_PER_MAH, spent
+
+# ============================================================================
+# REPORT
+# ============================================================================
+
+def print_report(label, rows):
+    base = rows[0][1]
+    print('%s: estimated mAh/day, change vs defaults, per-day counts' % label)
+    width = max(len(name) for name, _, _, _ in rows)
+    for name, mah, spent, counters in sorted(rows, key=lambda row: row[1]):
+        top = max(spent, key=lambda cost: spent[cost]) if spent else '-'
+        print('  %-*s %7.3f %+7.3f %7.0f wakeups %7.0f frames %7.0f px/frame  most: %s'
+              % (width, name, mah, mah - base, counters.get('wakeups', 0), counters.get('frames', 0),
+                 float(counters.get('pixels_written', 0)) / max(counters.get('frames', 0), 1), top))
+
+
+def main(argv):
+    args = {'platform': None, 'hours': 24, 'weather_minutes': 60, 'battery': 90, 'vary': [],
+            'combinations': False, 'costs': COSTS_PATH}
+    editions = []
+    for arg in argv:
+        if arg in ('-h', '--help'):
+            return host_build.usage(__doc__)
+        elif arg.startswith('--platform='):
+            args['platform'] = arg.split('=', 1)[1]
+        elif arg.startswith('--hours='):
+            args['hours'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--weather-minutes='):
+            args['weather_minutes'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--battery='):
+            args['battery'] = int(arg.split('=', 1)[1])
+        elif arg.startswith('--vary='):
+            args['vary'] = arg.split('=', 1)[1].split(',')
+        elif arg == '--combinations':
+            args['combinations'] = True
+        elif arg.startswith('--costs='):
+            args['costs'] = arg.split('=', 1)[1]
+        elif host_build.edition_arg(arg):
+            editions.append(host_build.edition_arg(arg))
+        else:
+            return host_build.usage(__doc__, 'unknown argument: %s' % arg)
+
+    with open(args['costs']) as f:
+        costs = json.load(f)
+    for edition in editions or sorted(DEFAULT_PLATFORMS, reverse=True):
+        platform = args['platform'] or DEFAULT_PLATFORMS[edition]
+        binary = host_build.build(edition, platform, [DRIVER], name='power')
+        rows = []
+        for name, settings in combinations(toggles(edition), args['vary'], args['combinations']):
+            counters = run(binary, settings, args)
+            mah, spent = price(counters, costs)
+            rows.append((name, mah, spent, counters))
+        print_report('%s %s' % (edition, platform), rows)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,180 @@
+#!/usr/bin/env python
+"""
+AppMessage trace replay for Constellation.
+
+Reads the "Trace:" lines pkjs logs for every delivered message when
+OUTBOX_TRACE is set in src/pkjs/index.js (pebble logs > trace.log), builds
+each edition for the host (tools/host_build.py) and replays the messages
+into its inbox_received_handler through tools/host/replay_main.c. Per
+message kind it reports:
+
+  bytes      dictionary size
+  handler    wall-clock time inside inbox_received_handler (host, -O1)
+  +redraw    handler plus the frame it caused
+  persist    persist writes (p.bytes: bytes written)
+  dirty      layer invalidations
+  frames     frames drawn, and pixels written by them
+  heap       live heap change once the frame is done
+
+Host times only rank message kinds against each other; the counts are what
+the watch does too. A key the edition does not have is renamed to its
+counterpart there (KEY_ALIASES, e.g. SHOW_CLOCK_RING and SHOW_DECORATIVE_RING
+are the same ring setting) or dropped with a warning on stderr.
+
+Usage:
+  python tools/replay.py [trace.log ...] [edition ...]   # default: tools/traces/sample.log
+  python tools/replay.py trace.log --per-message          # one line per message
+  python tools/replay.py trace.log --real-time            # keep the trace's timing, ticks included
+  python tools/replay.py --platform=chalk --set=SHOW_SECOND_TICKER=1
+"""
+from __future__ import print_function
+
+import json
+import os
+import re
+import subprocess
+import sys
+
+import host_build
+
+ROOT = host_build.ROOT
+DRIVER = os.path.join(host_build.HOST_DIR, 'replay_main.c')
+SAMPLE_TRACE = os.path.join(ROOT, 'tools', 'traces', 'sample.log')
+DEFAULT_PLATFORMS = {'standard-edition': 'basalt', 'chronomark-edition': 'gabbro'}
+TRACE_LINE = re.compile(r'Trace: (\{.*\})\s*$')
+
+# Settings that are the same thing under another name in the other edition
+KEY_ALIASES = {
+    'SHOW_CLOCK_RING': 'SHOW_DECORATIVE_RING',
+    'SHOW_DECORATIVE_RING': 'SHOW_CLOCK_RING',
+}
+FIELDS = ['bytes', 'handler_ns', 'total_ns', 'persist_writes', 'persist_bytes',
+          'dirty_marks', 'frames', 'pixels', 'heap_delta']
+
+# ============================================================================
+# TRACE
+# ============================================================================
+
+def read_trace(paths):
+    messages = []
+    for path in paths:
+        with open(path) as f:
+            for line in f:
+                match = TRACE_LINE.search(line)
+                if match:
+                    messages.append(json.loads(match.group(1)))
+    return messages
+
+
+def write_replay(messages, keys, path):
+    """Writes the line format replay_main.c reads; returns the mapped and dropped key names."""
+    mapped, dropped = set(), set()
+    with open(path, 'w') as f:
+        for message in messages:
+            f.write('message %d %s\n' % (message['time'], message['kind']))
+            for key, value in sorted(message['payload'].items()):
+                if key not in keys and KEY_ALIASES.get(key) in keys:
+                    mapped.add('%s->%s' % (key, KEY_ALIASES[key]))
+                    key = KEY_ALIASES[key]
+                if key not in keys:
+                    dropped.add(key)
+                elif isinstance(value, bool) or isinstance(value, int):
+                    f.write('int %s %d\n' % (key, int(value)))
+                else:
+                    text = value if isinstance(value, str) else json.dumps(value)
+                    f.write('str %s %s\n' % (key, text.replace('\n', ' ')))
+            f.write('send\n')
+    return sorted(mapped), sorted(dropped)
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def run(edition, platform, messages, args):
+    binary = host_build.build(edition, platform, [DRIVER], name='replay')
+    with open(os.path.join(ROOT, edition, 'package.json')) as f:
+        keys = set(json.load(f)['pebble'].get('messageKeys', []))
+    replay_path = os.path.join(os.path.dirname(binary), 'trace.replay')
+    mapped, dropped = write_replay(messages, keys, replay_path)
+    if dropped:
+        print('replay: warning: %s has no %s; dropped from the trace'
+              % (edition, ', '.join(dropped)), file=sys.stderr)
+
+    cmd = [binary, '--trace', replay_path, '--gap-ms', str(args['gap_ms'])]
+    if args['real_time']:
+        cmd.append('--real-time')
+    results = []
+    for line in subprocess.check_output(cmd + args['set']).decode().splitlines():
+        parts = line.split()
+        if parts[:1] == ['message']:
+            result = dict(zip(FIELDS, [int(v) for v in parts[3:]]))
+            result['index'], result['kind'] = int(parts[1]), parts[2]
+            results.append(result)
+    return results, mapped, dropped
+
+# ============================================================================
+# REPORT
+# ============================================================================
+
+def print_report(label, results, mapped, dropped, per_message):
+    print('%s: %d messages' % (label, len(results)))
+    if mapped:
+        print('  mapped keys: %s' % ', '.join(mapped))
+    if dropped:
+        print('  dropped keys: %s' % ', '.join(dropped))
+    header = '  %-12s %5s %6s %11s %11s %8s %7s %6s %7s %10s %8s'
+    row = '  %-12s %5s %6.0f %9.1fus %9.1fus %8.1f %7.0f %6.1f %7.1f %10.0f %8.0f'
+    print(header % ('kind', 'count', 'bytes', 'handler', '+redraw', 'persist', 'p.bytes', 'dirty',
+                    'frames', 'pixels', 'heap'))
+    groups = []
+    if per_message:
+        groups = [('%d %s' % (r['index'], r['kind']), [r]) for r in results]
+    else:
+        for kind in sorted(set(r['kind'] for r in results)):
+            groups.append((kind, [r for r in results if r['kind'] == kind]))
+    for name, group in groups:
+        n = float(len(group))
+
+        def mean(field):
+            return sum(r[field] for r in group) / n
+        print(row % (name, len(group), mean('bytes'), mean('handler_ns') / 1000, mean('total_ns') / 1000,
+                     mean('persist_writes'), mean('persist_bytes'), mean('dirty_marks'),
+                     mean('frames'), mean('pixels'), mean('heap_delta')))
+
+
+def main(argv):
+    args = {'platform': None, 'gap_ms': 1000, 'real_time': False, 'set': [], 'per_message': False}
+    traces, editions = [], []
+    for arg in argv:
+        if arg in ('-h', '--help'):
+            return host_build.usage(__doc__)
+        elif arg.startswith('--platform='):
+            args['platform'] = arg.split('=', 1)[1]
+        elif arg.startswith('--gap-ms='):
+            args['gap_ms'] = int(arg.split('=', 1)[1])
+        elif arg == '--real-time':
+            args['real_time'] = True
+        elif arg.startswith('--set='):
+            args['set'].append(arg.split('=', 1)[1])
+        elif arg == '--per-message':
+            args['per_message'] = True
+        elif os.path.isfile(arg):
+            traces.append(arg)
+        elif host_build.edition_arg(arg):
+            editions.append(host_build.edition_arg(arg))
+        else:
+            return host_build.usage(__doc__, 'unknown argument: %s' % arg)
+
+    messages = read_trace(traces or [SAMPLE_TRACE])
+    if not messages:
+        print('replay: no "Trace:" lines found; set OUTBOX_TRACE in src/pkjs/index.js', file=sys.stderr)
+        return 2
+    for edition in editions or sorted(DEFAULT_PLATFORMS, reverse=True):
+        platform = args['platform'] or DEFAULT_PLATFORMS[edition]
+        results, mapped, dropped = run(edition, platform, messages, args)
+        print_report('%s %s' % (edition, platform), results, mapped, dropped, args['per_message'])
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,135 @@
+#!/usr/bin/env python
+"""
+Wasted-frame detector for Constellation.
+
+Builds each edition for the host with the call-site hooks
+(tools/host/site_hooks.h), runs tools/host/wasted_main.c through a simulated
+hour with the second ticker off and on, and lists every call site that
+dirtied a layer whose pixels then came out identical to the previous frame:
+
+  wasted   dirties that changed nothing on screen
+  dirties  times the site dirtied that layer
+  inputs   render graph inputs behind the dirty ("-" for direct calls)
+
+Frames whose whole screen matched the previous frame are counted separately;
+those cost a full redraw for nothing.
+
+Usage:
+  python tools/wasted_frames.py [edition ...]          # default platform per edition
+  python tools/wasted_frames.py --platform=chalk --minutes=180
+  python tools/wasted_frames.py --set=SHOW_WEATHER=1   # extra settings for every run
+  python tools/wasted_frames.py --all                  # include sites that never wasted a frame
+
+Exits non-zero when any frame was wasted, so it can gate a change.
+"""
+from __future__ import print_function
+
+import os
+import re
+import subprocess
+import sys
+
+import host_build
+
+ROOT = host_build.ROOT
+DRIVER = os.path.join(host_build.HOST_DIR, 'wasted_main.c')
+HOOKS = os.path.join(host_build.HOST_DIR, 'site_hooks.h')
+GRAPH_HEADER = os.path.join(ROOT, 'shared', 'src', 'c', 'shared_modules', 'render_graph_module.h')
+DEFAULT_PLATFORMS = {'standard-edition': 'basalt', 'chronomark-edition': 'gabbro'}
+TICKER = [('ticker off', 'SHOW_SECOND_TICKER=0'), ('ticker on', 'SHOW_SECOND_TICKER=1')]
+
+# ============================================================================
+# RUN
+# ============================================================================
+
+def input_names():
+    with open(GRAPH_HEADER) as f:
+        text = f.read()
+    return [(1 << int(shift), name.lower())
+            for name, shift in re.findall(r'RENDER_INPUT_(\w+)\s*=\s*1\s*<<\s*(\d+)', text)]
+
+
+def describe_inputs(mask, names):
+    if not mask:
+        return '-'
+    return '|'.join(name for bit, name in names if mask & bit)
+
+
+def parse(output, src_dir):
+    result = {'sites': []}
+    for line in output.splitlines():
+        parts = line.split()
+        if parts[:1] == ['frames']:
+            result['frames'], result['identical'] = int(parts[1]), int(parts[3])
+        elif parts[:1] == ['site']:
+            path = parts[2]
+            if path.startswith(src_dir):
+                path = os.path.relpath(path, src_dir)
+            result['sites'].append({
+                'func': parts[1], 'file': path, 'line': int(parts[3]), 'inputs': int(parts[4]),
+                'kind': parts[5], 'proc': parts[6], 'dirties': int(parts[7]), 'wasted': int(parts[8]),
+            })
+    return result
+
+
+def run(edition, platform, settings, minutes):
+    binary = host_build.build(edition, platform, [DRIVER], hooks=HOOKS)
+    src_dir = os.path.join(os.path.dirname(binary), 'src')
+    output = subprocess.check_output([binary, '--minutes', str(minutes)] + settings).decode()
+    result = parse(output, src_dir)
+    names = host_build.symbolize(binary, [site['proc'] for site in result['sites']])
+    for site in result['sites']:
+        site['layer'] = names.get(site['proc']) or site['kind']
+    return result
+
+# ============================================================================
+# REPORT
+# ============================================================================
+
+def print_report(label, result, show_all):
+    frames = result['frames']
+    share = 100.0 * result['identical'] / frames if frames else 0
+    print('%s: %d frames, %d identical to the previous one (%.1f%%)'
+          % (label, frames, result['identical'], share))
+    names = input_names()
+    sites = sorted(result['sites'], key=lambda s: (-s['wasted'], -s['dirties']))
+    rows = [('%s (%s:%d)' % (site['func'], site['file'], site['line']), site)
+            for site in sites if site['wasted'] or show_all]
+    width = max([len(where) for where, _ in rows] + [0])
+    for where, site in rows:
+        print('  %5d / %-5d %-*s  %-24s %s'
+              % (site['wasted'], site['dirties'], width, where, site['layer'],
+                 describe_inputs(site['inputs'], names)))
+
+
+def main(argv):
+    platform, minutes, extra, show_all = None, 60, [], False
+    editions = []
+    for arg in argv:
+        if arg in ('-h', '--help'):
+            return host_build.usage(__doc__)
+        elif arg.startswith('--platform='):
+            platform = arg.split('=', 1)[1]
+        elif arg.startswith('--minutes='):
+            minutes = int(arg.split('=', 1)[1])
+        elif arg.startswith('--set='):
+            extra.append(arg.split('=', 1)[1])
+        elif arg == '--all':
+            show_all = True
+        elif host_build.edition_arg(arg):
+            editions.append(host_build.edition_arg(arg))
+        else:
+            return host_build.usage(__doc__, 'unknown argument: %s' % arg)
+
+    wasted = 0
+    for edition in editions or sorted(DEFAULT_PLATFORMS, reverse=True):
+        target = platform or DEFAULT_PLATFORMS[edition]
+        for label, ticker in TICKER:
+            result = run(edition, target, [ticker] + extra, minutes)
+            print_report('%s %s %s' % (edition, target, label), result, show_all)
+            wasted += sum(site['wasted'] for site in result['sites'])
+    return 1 if wasted else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))